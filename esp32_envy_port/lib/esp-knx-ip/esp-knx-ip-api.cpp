@@ -0,0 +1,567 @@
+/**
+ * esp-knx-ip library for KNX/IP communication on an ESP32
+ * JSON API: gateway state in one GET, batched changes in one POST
+ * License: MIT
+ */
+
+#include "esp-knx-ip.h"
+#include "esp-knx-ip-json.h"
+#include <esp_log.h>
+#include <memory>
+#define DEBUG_TAG "KNXIP"
+#define DEBUG_PRINT(fmt, ...) ESP_LOGD(DEBUG_TAG, fmt, ##__VA_ARGS__)
+#define DEBUG_PRINTLN(fmt, ...) ESP_LOGD(DEBUG_TAG, fmt "\n", ##__VA_ARGS__)
+
+/*
+ * GET is written straight into the buffers AsyncTCP hands out, one item
+ * (a config, a feedback, an assignment, ...) at a time. An item that does
+ * not fit is left for the next buffer as a whole, so a response never mixes
+ * two states of the same item. Only an item larger than a whole buffer is
+ * split.
+ */
+enum __api_section {
+  API_PHYS,
+  API_CONFIGS_HEAD,
+  API_CONFIGS,
+  API_FEEDBACKS_HEAD,
+  API_FEEDBACKS,
+  API_CALLBACKS_HEAD,
+  API_CALLBACKS,
+  API_ASSIGNMENTS_HEAD,
+  API_ASSIGNMENTS,
+  API_END,
+  API_DONE
+};
+
+struct __api_page {
+  uint8_t section;
+  uint16_t item;      // next entry within the section
+  uint16_t emitted;   // entries written in the section, for the separators
+  size_t skip;        // bytes of an oversized item already sent
+};
+
+static const char *const config_type_names[] = {"unknown", "int", "bool", "string", "options", "ga"};
+static const char *const feedback_type_names[] = {"unknown", "int", "float", "bool", "action"};
+
+void ESPKNXIP::__handle_api_get(AsyncWebServerRequest *request)
+{
+  std::shared_ptr<__api_page> page(new __api_page());
+  page->section = API_PHYS;
+  page->item = page->emitted = 0;
+  page->skip = 0;
+
+  AsyncWebServerResponse *response = request->beginChunkedResponse("application/json", [this, page](uint8_t *buffer, size_t max_len, size_t /* index */) -> size_t {
+    KnxJsonWriter out(buffer, max_len, page->skip);
+    while (page->section != API_DONE)
+    {
+      size_t mark = out.size();
+      __api_page before = *page;
+      __api_item(out, *page);
+      if (!out.overflowed())
+      {
+        page->skip = 0;
+        continue;
+      }
+      *page = before;
+      if (mark > 0)
+        out.truncate(mark);
+      else
+        page->skip += out.size();
+      break;
+    }
+    return out.size();
+  });
+  request->send(response);
+}
+
+// Writes the next item and advances page past it
+void ESPKNXIP::__api_item(KnxJsonWriter &out, __api_page &page)
+{
+  switch (page.section)
+  {
+    case API_PHYS:
+      out.raw("{\"physaddr\":");
+      out.pa(physaddr);
+      page.section = API_CONFIGS_HEAD;
+      return;
+
+    case API_CONFIGS_HEAD:
+      out.raw(",\"configs\":[");
+      page.section = API_CONFIGS;
+      page.item = page.emitted = 0;
+      return;
+
+    case API_CONFIGS:
+    {
+      if (page.item >= registered_configs)
+      {
+        out.raw(']');
+        page.section = API_FEEDBACKS_HEAD;
+        return;
+      }
+      config_id_t i = page.item++;
+      config_t &cfg = custom_configs[i];
+      if (cfg.cond && !cfg.cond())
+        return;
+      if (page.emitted++ > 0)
+        out.raw(',');
+      out.raw("{\"id\":");
+      out.num((int32_t)i);
+      out.raw(",\"name\":");
+      out.str(cfg.name.c_str(), cfg.name.length());
+      out.raw(",\"type\":");
+      out.str(config_type_names[cfg.type]);
+      out.raw(",\"value\":");
+      switch (cfg.type)
+      {
+        case CONFIG_TYPE_STRING:
+          out.str((const char *)&custom_config_data[cfg.offset + sizeof(uint8_t)]);
+          out.raw(",\"max_len\":");
+          out.num((int32_t)cfg.len - 1);
+          break;
+        case CONFIG_TYPE_INT:
+          out.num(config_get_int(i));
+          break;
+        case CONFIG_TYPE_BOOL:
+          out.boolean(config_get_bool(i));
+          break;
+        case CONFIG_TYPE_OPTIONS:
+        {
+          out.num((int32_t)config_get_options(i));
+          out.raw(",\"options\":[");
+          for (option_entry_t *cur = cfg.data.options; cur->name != nullptr; cur++)
+          {
+            if (cur != cfg.data.options)
+              out.raw(',');
+            out.raw("{\"name\":");
+            out.str(cur->name);
+            out.raw(",\"value\":");
+            out.num((int32_t)cur->value);
+            out.raw('}');
+          }
+          out.raw(']');
+          break;
+        }
+        case CONFIG_TYPE_GA:
+          out.ga(config_get_ga(i));
+          break;
+        case CONFIG_TYPE_UNKNOWN:
+          out.raw("null");
+          break;
+      }
+      out.raw('}');
+      return;
+    }
+
+    case API_FEEDBACKS_HEAD:
+      out.raw(",\"feedbacks\":[");
+      page.section = API_FEEDBACKS;
+      page.item = page.emitted = 0;
+      return;
+
+    case API_FEEDBACKS:
+    {
+      if (page.item >= registered_feedbacks)
+      {
+        out.raw(']');
+        page.section = API_CALLBACKS_HEAD;
+        return;
+      }
+      feedback_id_t i = page.item++;
+      feedback_t &fb = feedbacks[i];
+      if (fb.cond && !fb.cond())
+        return;
+      if (page.emitted++ > 0)
+        out.raw(',');
+      out.raw("{\"id\":");
+      out.num((int32_t)i);
+      out.raw(",\"name\":");
+      out.str(fb.name.c_str(), fb.name.length());
+      out.raw(",\"type\":");
+      out.str(feedback_type_names[fb.type]);
+      switch (fb.type)
+      {
+        case FEEDBACK_TYPE_INT:
+          out.raw(",\"value\":");
+          out.num(*(int32_t *)fb.data);
+          break;
+        case FEEDBACK_TYPE_FLOAT:
+          out.raw(",\"value\":");
+          out.num(*(float *)fb.data, fb.options.float_options.precision);
+          break;
+        case FEEDBACK_TYPE_BOOL:
+          out.raw(",\"value\":");
+          out.boolean(*(bool *)fb.data);
+          break;
+        case FEEDBACK_TYPE_ACTION:
+        case FEEDBACK_TYPE_UNKNOWN:
+          break;
+      }
+      out.raw('}');
+      return;
+    }
+
+    case API_CALLBACKS_HEAD:
+      out.raw(",\"callbacks\":[");
+      page.section = API_CALLBACKS;
+      page.item = page.emitted = 0;
+      return;
+
+    case API_CALLBACKS:
+    {
+      if (page.item >= registered_callbacks)
+      {
+        out.raw(']');
+        page.section = API_ASSIGNMENTS_HEAD;
+        return;
+      }
+      callback_id_t i = page.item++;
+      if (callbacks[i].cond && !callbacks[i].cond())
+        return;
+      if (page.emitted++ > 0)
+        out.raw(',');
+      out.raw("{\"id\":");
+      out.num((int32_t)i);
+      out.raw(",\"name\":");
+      out.str(callbacks[i].name.c_str(), callbacks[i].name.length());
+      out.raw('}');
+      return;
+    }
+
+    case API_ASSIGNMENTS_HEAD:
+      out.raw(",\"assignments\":[");
+      page.section = API_ASSIGNMENTS;
+      page.item = page.emitted = 0;
+      return;
+
+    case API_ASSIGNMENTS:
+    {
+      if (page.item >= registered_callback_assignments)
+      {
+        out.raw(']');
+        page.section = API_END;
+        return;
+      }
+      callback_assignment_id_t i = page.item++;
+      if (!__callback_assignment_used(i))
+        return;
+      if (page.emitted++ > 0)
+        out.raw(',');
+      out.raw("{\"id\":");
+      out.num((int32_t)i);
+      out.raw(",\"ga\":");
+      out.ga(callback_assignments[i].address);
+      out.raw(",\"callback\":");
+      out.num((int32_t)callback_assignments[i].callback_id);
+      out.raw('}');
+      return;
+    }
+
+    case API_END:
+      out.raw('}');
+      page.section = API_DONE;
+      return;
+  }
+}
+
+/* POST body, collected by __handle_api_body and freed with the request */
+struct __api_body {
+  size_t len;
+  bool too_large;
+  char data[];
+};
+
+void ESPKNXIP::__handle_api_body(AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total)
+{
+  if (index == 0)
+  {
+    bool too_large = total > API_BODY_MAX;
+    __api_body *body = (__api_body *)malloc(sizeof(__api_body) + (too_large ? 0 : total + 1));
+    if (body == nullptr)
+      return;
+    body->len = 0;
+    body->too_large = too_large;
+    request->_tempObject = body;
+  }
+  __api_body *body = (__api_body *)request->_tempObject;
+  if (body == nullptr || body->too_large || index + len > total)
+    return;
+  memcpy(body->data + index, data, len);
+  body->len = index + len;
+}
+
+typedef enum __api_value_kind {
+  API_VALUE_NONE,
+  API_VALUE_STRING,
+  API_VALUE_INT,
+  API_VALUE_BOOL,
+} api_value_kind_t;
+
+/* One batch, parsed and checked in full before any of it is applied */
+struct __api_batch {
+  bool has_physaddr;
+  address_t physaddr;
+
+  uint8_t configs_len;
+  struct {
+    int32_t id;
+    api_value_kind_t kind;
+    int32_t num;        // int and options values, bools as 0/1
+    const char *str;    // into the request body
+    size_t str_len;
+    address_t ga;
+  } configs[API_BATCH_MAX];
+
+  uint8_t unassign_len;
+  callback_assignment_id_t unassign[API_BATCH_MAX];
+
+  uint8_t assign_len;
+  struct {
+    address_t ga;
+    int32_t callback;
+  } assign[API_BATCH_MAX];
+};
+
+static void __api_error(AsyncWebServerRequest *request, int code, const char *what, const char *list = nullptr, int index = -1)
+{
+  char msg[128];
+  if (list != nullptr)
+    snprintf(msg, sizeof(msg), "{\"error\":\"%s[%d]: %s\"}", list, index, what);
+  else
+    snprintf(msg, sizeof(msg), "{\"error\":\"%s\"}", what);
+  DEBUG_PRINTLN("API: %s", msg);
+  request->send(code, "application/json", msg);
+}
+
+void ESPKNXIP::__handle_api_post(AsyncWebServerRequest *request)
+{
+  DEBUG_PRINTLN("API batch called");
+  __api_body *body = (__api_body *)request->_tempObject;
+  if (body != nullptr && body->too_large)
+    return __api_error(request, 413, "body too large");
+  if (body == nullptr || body->len == 0)
+    return __api_error(request, 400, "empty body");
+
+  std::unique_ptr<__api_batch> batch(new __api_batch());
+  batch->has_physaddr = false;
+  batch->configs_len = batch->unassign_len = batch->assign_len = 0;
+
+  // Parse
+  KnxJsonReader in(body->data, body->len);
+  const char *key;
+  const char *s;
+  size_t n;
+  if (!in.begin_object())
+    return __api_error(request, 400, "expected an object");
+  while (in.next_member(key))
+  {
+    if (strcmp(key, "physaddr") == 0)
+    {
+      if (!in.read_string(s, n) || !knx_json_parse_pa(s, n, batch->physaddr))
+        return __api_error(request, 400, "physaddr must be \\\"area.line.member\\\"");
+      batch->has_physaddr = true;
+    }
+    else if (strcmp(key, "configs") == 0)
+    {
+      in.begin_array();
+      while (in.next_element())
+      {
+        if (batch->configs_len >= API_BATCH_MAX)
+          return __api_error(request, 400, "too many entries", "configs", batch->configs_len);
+        auto &c = batch->configs[batch->configs_len];
+        c.id = -1;
+        c.kind = API_VALUE_NONE;
+        in.begin_object();
+        while (in.next_member(key))
+        {
+          if (strcmp(key, "id") == 0)
+            in.read_int(c.id);
+          else if (strcmp(key, "value") == 0)
+          {
+            bool b;
+            switch (in.peek())
+            {
+              case '"':
+                c.kind = API_VALUE_STRING;
+                in.read_string(c.str, c.str_len);
+                break;
+              case 't':
+              case 'f':
+                c.kind = API_VALUE_BOOL;
+                in.read_bool(b);
+                c.num = b;
+                break;
+              default:
+                c.kind = API_VALUE_INT;
+                in.read_int(c.num);
+                break;
+            }
+          }
+          else
+            return __api_error(request, 400, "unknown member", "configs", batch->configs_len);
+        }
+        batch->configs_len++;
+      }
+    }
+    else if (strcmp(key, "unassign") == 0)
+    {
+      in.begin_array();
+      while (in.next_element())
+      {
+        if (batch->unassign_len >= API_BATCH_MAX)
+          return __api_error(request, 400, "too many entries", "unassign", batch->unassign_len);
+        int32_t id = -1;
+        in.read_int(id);
+        if (id < 0 || id > 0xFFFF)
+          return __api_error(request, 400, "no such assignment", "unassign", batch->unassign_len);
+        batch->unassign[batch->unassign_len++] = id;
+      }
+    }
+    else if (strcmp(key, "assign") == 0)
+    {
+      in.begin_array();
+      while (in.next_element())
+      {
+        if (batch->assign_len >= API_BATCH_MAX)
+          return __api_error(request, 400, "too many entries", "assign", batch->assign_len);
+        auto &a = batch->assign[batch->assign_len];
+        bool has_ga = false;
+        a.callback = -1;
+        in.begin_object();
+        while (in.next_member(key))
+        {
+          if (strcmp(key, "ga") == 0)
+          {
+            if (!in.read_string(s, n) || !(has_ga = knx_json_parse_ga(s, n, a.ga)))
+              return __api_error(request, 400, "ga must be \\\"area/line/member\\\"", "assign", batch->assign_len);
+          }
+          else if (strcmp(key, "callback") == 0)
+            in.read_int(a.callback);
+          else
+            return __api_error(request, 400, "unknown member", "assign", batch->assign_len);
+        }
+        if (!in.error() && !has_ga)
+          return __api_error(request, 400, "missing ga", "assign", batch->assign_len);
+        batch->assign_len++;
+      }
+    }
+    else
+      return __api_error(request, 400, "unknown member");
+  }
+  if (!in.finish())
+    return __api_error(request, 400, "malformed JSON");
+
+  // Validate everything against the current tables, and apply it under the
+  // same lock. Dispatch and the form handlers take it too, so nobody sees or
+  // changes the tables between the check and a half-applied batch.
+  knx_lock_take(&cfg_lock);
+  auto fail = [&](int code, const char *what, const char *list, int index) {
+    knx_lock_give(&cfg_lock);
+    __api_error(request, code, what, list, index);
+  };
+  for (uint8_t k = 0; k < batch->configs_len; ++k)
+  {
+    auto &c = batch->configs[k];
+    if (c.id < 0 || c.id >= registered_configs)
+      return fail(400, "no such config", "configs", k);
+    for (uint8_t j = 0; j < k; ++j)
+    {
+      if (batch->configs[j].id == c.id)
+        return fail(400, "listed twice", "configs", k);
+    }
+    config_t &cfg = custom_configs[c.id];
+    bool ok = false;
+    switch (cfg.type)
+    {
+      case CONFIG_TYPE_STRING:
+        ok = c.kind == API_VALUE_STRING && c.str_len < cfg.len && strlen(c.str) == c.str_len;
+        break;
+      case CONFIG_TYPE_INT:
+        ok = c.kind == API_VALUE_INT;
+        break;
+      case CONFIG_TYPE_BOOL:
+        ok = c.kind == API_VALUE_BOOL;
+        break;
+      case CONFIG_TYPE_OPTIONS:
+        if (c.kind != API_VALUE_INT)
+          break;
+        for (option_entry_t *cur = cfg.data.options; cur->name != nullptr && !ok; cur++)
+          ok = cur->value == c.num;
+        break;
+      case CONFIG_TYPE_GA:
+        ok = c.kind == API_VALUE_STRING && knx_json_parse_ga(c.str, c.str_len, c.ga);
+        break;
+      case CONFIG_TYPE_UNKNOWN:
+        break;
+    }
+    if (!ok)
+      return fail(400, "invalid value", "configs", k);
+  }
+  for (uint8_t k = 0; k < batch->unassign_len; ++k)
+  {
+    if (!__callback_assignment_used(batch->unassign[k]))
+      return fail(400, "no such assignment", "unassign", k);
+    for (uint8_t j = 0; j < k; ++j)
+    {
+      if (batch->unassign[j] == batch->unassign[k])
+        return fail(400, "listed twice", "unassign", k);
+    }
+  }
+  for (uint8_t k = 0; k < batch->assign_len; ++k)
+  {
+    if (batch->assign[k].callback < 0 || batch->assign[k].callback >= registered_callbacks)
+      return fail(400, "no such callback", "assign", k);
+  }
+  // Slots removed by this batch are free again before the new ones are taken
+  uint32_t free_slots = callback_assignments.capacity() - registered_callback_assignments + batch->unassign_len;
+  for (callback_assignment_id_t f = callback_assignment_free; f != CALLBACK_ASSIGNMENT_FREE; f = callback_assignments[f].address.value)
+    free_slots++;
+  if (batch->assign_len > free_slots)
+    return fail(409, "no room for the new assignments", nullptr, -1);
+
+  callback_assignment_id_t assigned[API_BATCH_MAX];
+  if (batch->has_physaddr)
+    physaddr = batch->physaddr;
+  for (uint8_t k = 0; k < batch->configs_len; ++k)
+  {
+    auto &c = batch->configs[k];
+    config_t &cfg = custom_configs[c.id];
+    __config_set_flags(c.id, CONFIG_FLAGS_VALUE_SET);
+    switch (cfg.type)
+    {
+      case CONFIG_TYPE_STRING:
+        memcpy(&custom_config_data[cfg.offset + sizeof(uint8_t)], c.str, c.str_len + 1);
+        break;
+      case CONFIG_TYPE_INT:
+        __config_set_int(c.id, c.num);
+        break;
+      case CONFIG_TYPE_BOOL:
+        __config_set_bool(c.id, c.num != 0);
+        break;
+      case CONFIG_TYPE_OPTIONS:
+        __config_set_options(c.id, (uint8_t)c.num);
+        break;
+      case CONFIG_TYPE_GA:
+        __config_set_ga(c.id, c.ga);
+        break;
+      case CONFIG_TYPE_UNKNOWN:
+        break;
+    }
+  }
+  for (uint8_t k = 0; k < batch->unassign_len; ++k)
+    __callback_delete_assignment(batch->unassign[k]);
+  for (uint8_t k = 0; k < batch->assign_len; ++k)
+    assigned[k] = __callback_register_assignment(batch->assign[k].ga, batch->assign[k].callback);
+  knx_lock_give(&cfg_lock);
+
+  AsyncResponseStream *response = request->beginResponseStream("application/json");
+  response->print("{\"assigned\":[");
+  for (uint8_t k = 0; k < batch->assign_len; ++k)
+  {
+    if (k > 0)
+      response->print(',');
+    response->print(assigned[k]);
+  }
+  response->print("]}");
+  request->send(response);
+}
@@ -0,0 +1,36 @@
+/**
+ * esp-knx-ip library for KNX/IP communication on an ESP32
+ * Gzip-compressed static web files kept in flash
+ * License: MIT
+ */
+
+#ifndef ESP_KNX_IP_ASSET_H
+#define ESP_KNX_IP_ASSET_H
+
+#include <Arduino.h>
+
+/*
+ * One file as packed by scripts/gen_assets.py. data is the gzip stream and
+ * is sent as-is with Content-Encoding: gzip. etag is a quoted hash of the
+ * uncompressed content. Pages link assets with that hash in the query
+ * string, so those can be cached for a long time and still change with the
+ * firmware; a page itself is revalidated and usually answered with a 304.
+ */
+typedef struct __knx_asset {
+  const char *path;
+  const char *mime;
+  const uint8_t *data;
+  size_t len;
+  const char *etag;
+  const char *cache_control;
+} knx_asset_t;
+
+#define ASSET_CACHE_IMMUTABLE   "public, max-age=31536000, immutable"
+#define ASSET_CACHE_REVALIDATE  "no-cache"
+
+class AsyncWebServerRequest;
+
+/* Answers with 304 if the client already holds this version, otherwise with the compressed file */
+void knx_asset_send(AsyncWebServerRequest *request, const knx_asset_t &asset);
+
+#endif
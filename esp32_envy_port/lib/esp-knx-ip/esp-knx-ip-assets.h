@@ -0,0 +1,126 @@
+/**
+ * esp-knx-ip library for KNX/IP communication on an ESP32
+ * Static web assets of the configuration page, generated by scripts/gen_assets.py. Do not edit.
+ * License: MIT
+ */
+
+#ifndef ESP_KNX_IP_ASSETS_H
+#define ESP_KNX_IP_ASSETS_H
+
+#include "esp-knx-ip-asset.h"
+
+// knx.css: 551 bytes, 283 gzipped
+#define KNX_ASSET_KNX_CSS_VERSION "9c6c00bfcfa5a8f4"
+static const uint8_t knx_asset_knx_css[] PROGMEM = {
+  0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0x8d, 0x91, 0xcd, 0x6a, 0xc3, 0x30,
+  0x0c, 0xc7, 0xef, 0x7b, 0x8a, 0x42, 0x2f, 0x1b, 0xcc, 0xa3, 0xe9, 0x18, 0xac, 0x0e, 0x3b, 0xec,
+  0x39, 0xc6, 0x0e, 0x76, 0xac, 0xc4, 0x66, 0xb6, 0x65, 0x14, 0xa5, 0x4b, 0x08, 0x7e, 0xf7, 0x25,
+  0x4b, 0x52, 0x18, 0x14, 0x56, 0x7c, 0x91, 0xa5, 0x9f, 0xfe, 0xfa, 0xd2, 0x68, 0x86, 0xb1, 0xc6,
+  0xc8, 0xa2, 0x56, 0xc1, 0xf9, 0x41, 0xbe, 0x93, 0x53, 0xbe, 0x0c, 0x8a, 0x1a, 0x17, 0xe5, 0x21,
+  0xdb, 0x62, 0xdc, 0xec, 0x52, 0xab, 0xea, 0xab, 0x21, 0xec, 0xa2, 0x11, 0x15, 0x7a, 0x24, 0xb9,
+  0x7f, 0x36, 0xfa, 0x04, 0xa7, 0x72, 0xf9, 0x7d, 0x5b, 0xc7, 0x50, 0x26, 0x65, 0x8c, 0x8b, 0x8d,
+  0x2c, 0x20, 0x64, 0x7b, 0x5c, 0x93, 0x05, 0x63, 0x92, 0x87, 0xa7, 0x17, 0x08, 0xab, 0xb2, 0xd0,
+  0xc8, 0x8c, 0x61, 0xf1, 0xe5, 0x1a, 0x29, 0x8c, 0x7f, 0x03, 0x73, 0xba, 0x57, 0x1a, 0xfc, 0xe6,
+  0x27, 0xd7, 0x58, 0x5e, 0x79, 0x17, 0x53, 0xc7, 0x1f, 0x3c, 0x24, 0x78, 0x63, 0xe8, 0xf9, 0xf3,
+  0x1f, 0xa6, 0xed, 0x74, 0x70, 0x13, 0x75, 0x53, 0xff, 0x1a, 0xc9, 0x00, 0x4d, 0xd3, 0x6e, 0x83,
+  0x2c, 0x6d, 0x57, 0x1d, 0xb5, 0x13, 0x93, 0xd0, 0x45, 0x06, 0xca, 0xac, 0xb4, 0x87, 0x71, 0x61,
+  0x67, 0x31, 0xaf, 0x52, 0x0b, 0x72, 0x33, 0x32, 0x9b, 0x47, 0xb6, 0x6b, 0x58, 0x16, 0xa9, 0xdf,
+  0xb5, 0xe8, 0x9d, 0xd9, 0xed, 0x8d, 0x31, 0x17, 0xdd, 0xd7, 0xd4, 0x67, 0x26, 0x19, 0xd9, 0x8a,
+  0xca, 0x3a, 0x6f, 0xee, 0xe1, 0x0c, 0xf1, 0xe1, 0x4a, 0x93, 0xf5, 0x71, 0x7e, 0x33, 0x6b, 0xf1,
+  0x0c, 0x74, 0x85, 0x98, 0x64, 0xf3, 0x54, 0x6f, 0x55, 0xfe, 0x5d, 0x76, 0x71, 0x4c, 0xfd, 0x56,
+  0xea, 0xb2, 0xd3, 0xd9, 0x37, 0x2f, 0x4c, 0x28, 0xef, 0x9a, 0x28, 0x3d, 0xd4, 0x7c, 0xd3, 0x51,
+  0xf3, 0xdd, 0x0f, 0x2d, 0xd3, 0xf9, 0xed, 0x27, 0x02, 0x00, 0x00,
+};
+
+// live.html: 2419 bytes, 1253 gzipped
+#define KNX_ASSET_LIVE_HTML_VERSION "bb0afd4325de5983"
+static const uint8_t knx_asset_live_html[] PROGMEM = {
+  0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0x95, 0x56, 0x6d, 0x6f, 0xdb, 0x36,
+  0x10, 0xfe, 0x9e, 0x5f, 0xa1, 0x7a, 0x83, 0x49, 0xc2, 0x8a, 0x24, 0xe7, 0xad, 0xa9, 0x2d, 0x3a,
+  0x58, 0xd3, 0x16, 0x18, 0x86, 0xb5, 0x43, 0x93, 0xae, 0x1d, 0xba, 0x62, 0xa0, 0xa9, 0x73, 0xc4,
+  0x45, 0x16, 0x35, 0x92, 0x8e, 0x13, 0xa4, 0xf9, 0xda, 0xcf, 0xc3, 0x7e, 0x62, 0x7f, 0xc9, 0x8e,
+  0x94, 0xfc, 0xd6, 0xad, 0x03, 0x66, 0xc0, 0x10, 0xef, 0x78, 0xf7, 0xdc, 0x8b, 0xee, 0x45, 0xf9,
+  0xa3, 0x67, 0xaf, 0xce, 0x2f, 0x7f, 0xf9, 0xe9, 0x79, 0x54, 0xba, 0x79, 0x35, 0xd9, 0xcb, 0xc3,
+  0x23, 0x2f, 0x41, 0x14, 0x93, 0x7c, 0x0e, 0x4e, 0x44, 0xb2, 0x14, 0xc6, 0x82, 0xe3, 0xbd, 0x37,
+  0x97, 0x2f, 0xf6, 0x4f, 0x7b, 0x1d, 0xb7, 0x16, 0x73, 0xe0, 0xbd, 0x1b, 0x05, 0xcb, 0x46, 0x1b,
+  0xd7, 0x8b, 0xa4, 0xae, 0x1d, 0xd4, 0x28, 0xb5, 0x54, 0x85, 0x2b, 0x79, 0x01, 0x37, 0x4a, 0xc2,
+  0x7e, 0x20, 0xe2, 0x48, 0xd5, 0xca, 0x29, 0x51, 0xed, 0x5b, 0x29, 0x2a, 0xe0, 0x43, 0xc4, 0x70,
+  0xca, 0x55, 0x30, 0xf9, 0xe1, 0xe5, 0xbb, 0xa8, 0x52, 0x37, 0x90, 0xa7, 0x2d, 0xbd, 0x97, 0x57,
+  0xaa, 0xbe, 0x8e, 0x0c, 0x54, 0xbc, 0x67, 0xdd, 0x5d, 0x05, 0xb6, 0x04, 0x40, 0xf0, 0xd2, 0xc0,
+  0x8c, 0xf7, 0xae, 0xeb, 0xdb, 0x44, 0x5a, 0x7b, 0x76, 0xc3, 0x9f, 0xc8, 0x13, 0x99, 0x65, 0xd3,
+  0x99, 0x9c, 0x89, 0x63, 0x71, 0x3a, 0x3b, 0xea, 0xa1, 0x66, 0xda, 0xba, 0x3c, 0xd5, 0xc5, 0x9d,
+  0x8f, 0x62, 0xb8, 0x05, 0x8e, 0xc4, 0x5e, 0x5e, 0xa8, 0x9b, 0x28, 0x60, 0xf2, 0x5e, 0x23, 0x8a,
+  0x42, 0xd5, 0x57, 0xa3, 0x21, 0xcc, 0xbd, 0x66, 0x33, 0xc9, 0x6d, 0x23, 0xea, 0x48, 0x15, 0xde,
+  0xaa, 0x70, 0xd0, 0x9b, 0x60, 0x34, 0x35, 0x48, 0x87, 0x42, 0x79, 0xea, 0xef, 0x26, 0x51, 0x7f,
+  0xae, 0x8a, 0x42, 0xbb, 0x71, 0xb4, 0x91, 0x95, 0x7a, 0x51, 0xbb, 0xde, 0x24, 0x5b, 0x89, 0x38,
+  0xa8, 0xe0, 0xca, 0x88, 0xb9, 0xfd, 0x37, 0xe1, 0xb9, 0xb2, 0x16, 0x8a, 0x2d, 0xe9, 0x96, 0x91,
+  0xa7, 0x0d, 0x7a, 0xe0, 0xc4, 0x14, 0xa3, 0xcf, 0x5d, 0x1b, 0x82, 0x33, 0xfe, 0x38, 0xb9, 0x54,
+  0x73, 0x9f, 0x98, 0x32, 0x10, 0xeb, 0xc3, 0x85, 0x5e, 0x18, 0xb9, 0xe1, 0x3f, 0x03, 0x8b, 0x5e,
+  0x0a, 0xa7, 0x74, 0xbd, 0xe6, 0x5d, 0xde, 0x35, 0x5b, 0x02, 0xc2, 0x89, 0x96, 0x48, 0x3d, 0x6e,
+  0xba, 0xb2, 0xe1, 0xf3, 0x14, 0x1c, 0x33, 0x7a, 0x69, 0x7b, 0xfe, 0x22, 0x64, 0x0e, 0x9f, 0xc1,
+  0x17, 0xcc, 0x27, 0x26, 0x0c, 0x1f, 0x56, 0x1a, 0xd5, 0xb8, 0xc9, 0xde, 0x8d, 0x30, 0xd1, 0xf9,
+  0x25, 0xbf, 0xcf, 0x46, 0xc4, 0x20, 0x02, 0x89, 0x87, 0x23, 0x22, 0x6a, 0xbb, 0x04, 0x43, 0xe2,
+  0x83, 0x11, 0x59, 0x1a, 0xe5, 0x80, 0x3c, 0xc4, 0x3f, 0x7e, 0xf7, 0xee, 0xb7, 0xd7, 0xaf, 0xde,
+  0x5e, 0xf0, 0x83, 0x2c, 0x8b, 0x9d, 0x76, 0xa2, 0xe2, 0x59, 0xdc, 0x86, 0x8a, 0x87, 0x1a, 0x6e,
+  0x1d, 0xdf, 0x1f, 0x8e, 0x03, 0x9a, 0x37, 0xcc, 0x0b, 0x2d, 0x17, 0x73, 0xac, 0x9b, 0xe4, 0x0a,
+  0xdc, 0xf3, 0x0a, 0xfc, 0xf1, 0xe9, 0xdd, 0xf7, 0x05, 0x25, 0xfe, 0x96, 0xb0, 0xf1, 0xde, 0x6c,
+  0x51, 0x4b, 0x1f, 0x5d, 0xd4, 0x08, 0x5a, 0xc6, 0x15, 0xbb, 0x37, 0xe0, 0x16, 0xa6, 0x8e, 0x68,
+  0x39, 0x99, 0x1c, 0xb1, 0x01, 0x49, 0xc8, 0x80, 0x96, 0xfd, 0xe1, 0x71, 0x7b, 0xac, 0x1e, 0x36,
+  0x0a, 0x57, 0xff, 0x54, 0x38, 0x44, 0xa9, 0x34, 0x28, 0x3c, 0x6e, 0x4f, 0xdb, 0xf2, 0x25, 0xdc,
+  0xd2, 0xe9, 0x46, 0x7c, 0x9a, 0x0f, 0x4f, 0xce, 0x48, 0x46, 0x46, 0x84, 0xb0, 0xc1, 0x34, 0x71,
+  0xfa, 0xc2, 0x19, 0xac, 0x07, 0x3a, 0x3c, 0x61, 0x5b, 0x4a, 0xe8, 0x26, 0x95, 0x50, 0x55, 0x36,
+  0xbe, 0x12, 0x0d, 0xbb, 0xdf, 0x8b, 0x22, 0x1f, 0x9a, 0x33, 0x9b, 0xc0, 0x24, 0xa6, 0xcb, 0x41,
+  0x17, 0x1b, 0x25, 0xce, 0xf8, 0xa8, 0xa2, 0x28, 0x28, 0x25, 0x33, 0x6d, 0x9e, 0x0b, 0x59, 0xd2,
+  0x15, 0x1e, 0x95, 0xec, 0x3e, 0x00, 0x14, 0x5f, 0x07, 0x28, 0x10, 0xc0, 0x15, 0x89, 0xc3, 0x5c,
+  0x9e, 0x77, 0x4d, 0x27, 0xc7, 0xce, 0x24, 0xa2, 0x69, 0xa0, 0x2e, 0xce, 0x4b, 0x55, 0x15, 0xd4,
+  0x15, 0xec, 0x21, 0x98, 0x51, 0x33, 0xea, 0x1d, 0xc3, 0xeb, 0x50, 0xfb, 0xc9, 0x54, 0x9b, 0x02,
+  0xcc, 0xa5, 0x6e, 0x38, 0x39, 0x6c, 0x6e, 0x23, 0xab, 0x2b, 0x55, 0x44, 0xdf, 0xc0, 0x93, 0xe3,
+  0xc7, 0x87, 0x05, 0xf1, 0x0a, 0x3e, 0xef, 0x89, 0xaa, 0x2d, 0x18, 0xf7, 0x14, 0xd0, 0x3d, 0xa0,
+  0xce, 0xc4, 0x81, 0x39, 0x53, 0xc6, 0xba, 0x00, 0x1f, 0x90, 0x97, 0x78, 0x02, 0x1a, 0x6e, 0xa4,
+  0x67, 0xbe, 0xd4, 0x05, 0xd8, 0xa4, 0x82, 0xfa, 0x0a, 0x8b, 0x6d, 0x55, 0x06, 0x2c, 0xdc, 0x1b,
+  0x98, 0xeb, 0x1b, 0x68, 0x3d, 0x0b, 0x8c, 0x4a, 0x6c, 0x90, 0xb6, 0x92, 0x39, 0x07, 0x6b, 0xc5,
+  0x15, 0xd0, 0xe9, 0x62, 0xb6, 0x4e, 0x65, 0xc1, 0x6b, 0x58, 0x46, 0xbe, 0x8a, 0x7f, 0xc6, 0x59,
+  0x13, 0xae, 0xe2, 0x9a, 0x17, 0xbe, 0x5e, 0xde, 0xa8, 0xda, 0x9d, 0xd2, 0x21, 0x8b, 0x2d, 0xfc,
+  0xb1, 0xe1, 0x0c, 0x4f, 0xe8, 0x41, 0xec, 0xcc, 0x02, 0x58, 0xac, 0xf9, 0x91, 0xf7, 0x34, 0x4d,
+  0xa3, 0xd7, 0x20, 0x31, 0x70, 0x1b, 0x09, 0x03, 0x51, 0xbd, 0x98, 0x4f, 0xc1, 0x40, 0x11, 0x47,
+  0x02, 0x6b, 0xa4, 0x89, 0x94, 0xc5, 0x58, 0x84, 0x8b, 0x5c, 0x89, 0x27, 0x59, 0x29, 0x4c, 0x68,
+  0xd7, 0x9c, 0x9d, 0x0b, 0x95, 0xb6, 0x8e, 0xfb, 0xd2, 0xcd, 0xb3, 0xb3, 0x6c, 0x44, 0xd1, 0xda,
+  0xbe, 0xa7, 0x58, 0x3f, 0xbb, 0x7d, 0x81, 0x3f, 0x6f, 0x22, 0x14, 0xb6, 0xbf, 0x19, 0xd4, 0xdb,
+  0xec, 0x16, 0x66, 0xc0, 0x3d, 0x82, 0xa7, 0x31, 0x9f, 0xd4, 0x23, 0x2a, 0x9e, 0x8d, 0x55, 0x5e,
+  0x8f, 0xd5, 0x60, 0x10, 0x02, 0xed, 0xaa, 0x66, 0x13, 0xc4, 0xe1, 0x01, 0xd5, 0x5d, 0x10, 0xb3,
+  0xed, 0x60, 0xf5, 0xe0, 0x88, 0xc5, 0xd2, 0xed, 0xb2, 0x9e, 0xb0, 0x18, 0xd3, 0xbe, 0xcb, 0x1b,
+  0x66, 0x2c, 0x2e, 0x30, 0x69, 0xfc, 0xfd, 0x87, 0x71, 0x30, 0xb0, 0x32, 0x7d, 0x8d, 0xa6, 0xaf,
+  0x73, 0x94, 0x1f, 0x5f, 0xa3, 0x71, 0x2f, 0x92, 0x34, 0x0b, 0x5b, 0x52, 0x5f, 0xfd, 0xbb, 0x08,
+  0xc3, 0xc1, 0x35, 0x63, 0xac, 0xd5, 0xf6, 0x65, 0xfe, 0x9e, 0xba, 0x74, 0x98, 0x65, 0x19, 0xc3,
+  0x5e, 0x78, 0xa1, 0x6e, 0xa1, 0xa0, 0x87, 0xe8, 0x5d, 0x7f, 0x78, 0x46, 0x3e, 0x7f, 0xfa, 0x0b,
+  0xdb, 0xe4, 0xf3, 0xa7, 0x3f, 0x49, 0x8c, 0x5d, 0xba, 0x83, 0x72, 0x8c, 0x6e, 0x6c, 0xd3, 0x27,
+  0x8c, 0x61, 0xa7, 0xec, 0xca, 0x3c, 0xfe, 0x42, 0xe6, 0x14, 0x65, 0xce, 0x2f, 0xdf, 0x4b, 0xf7,
+  0xe1, 0xe3, 0x47, 0x4a, 0xb2, 0x5b, 0x32, 0xf0, 0xce, 0x49, 0xc7, 0xda, 0x90, 0x92, 0xdf, 0xb5,
+  0xaa, 0x29, 0x89, 0x08, 0xfb, 0x10, 0x2b, 0xce, 0xb3, 0x7e, 0xdf, 0xa7, 0x77, 0x92, 0x75, 0xae,
+  0xea, 0x01, 0x47, 0xd7, 0x7d, 0x80, 0x48, 0x3e, 0xe0, 0x3f, 0x4c, 0xa1, 0x01, 0x0f, 0xf4, 0x57,
+  0xc7, 0x4d, 0x98, 0xe5, 0x84, 0xed, 0x74, 0x55, 0x50, 0xfc, 0x4f, 0xad, 0xf6, 0xfd, 0x7e, 0xa1,
+  0xd6, 0x32, 0x77, 0x0a, 0xbb, 0x5b, 0x27, 0x74, 0x5d, 0xd5, 0x38, 0xf9, 0x7c, 0x59, 0xbf, 0x85,
+  0xe9, 0x85, 0x96, 0xd7, 0xe0, 0x28, 0xad, 0xb4, 0x0c, 0x53, 0x3c, 0x69, 0x8c, 0x76, 0x5a, 0xea,
+  0x8a, 0x73, 0x52, 0x3a, 0xd7, 0xd8, 0x11, 0x39, 0x23, 0x4b, 0x6b, 0x47, 0x69, 0x8a, 0x39, 0x5e,
+  0x86, 0x27, 0x1b, 0xac, 0xa5, 0x4b, 0x0c, 0x7d, 0x43, 0x35, 0xc2, 0x95, 0x7e, 0x31, 0x63, 0xc7,
+  0x35, 0x95, 0x90, 0x40, 0x53, 0xbf, 0x00, 0x7f, 0x4d, 0xfc, 0x4e, 0xff, 0x36, 0x8d, 0x89, 0x75,
+  0x38, 0x4b, 0xe6, 0xa4, 0x7d, 0xab, 0xd8, 0x87, 0x53, 0x5c, 0x1d, 0xe6, 0xce, 0xef, 0x0b, 0x4e,
+  0x84, 0x31, 0xe2, 0x0e, 0xdb, 0x6b, 0x86, 0x13, 0xbd, 0xbb, 0xd6, 0xb5, 0xc6, 0x91, 0xc2, 0xd7,
+  0xc3, 0x89, 0xdd, 0x7f, 0x35, 0x13, 0x61, 0x6f, 0x7e, 0x91, 0x08, 0xd2, 0x85, 0x8d, 0x19, 0x7a,
+  0x58, 0x23, 0x76, 0x3d, 0xbe, 0x01, 0x05, 0x76, 0x8f, 0x43, 0xca, 0xa1, 0x0f, 0x7a, 0x16, 0x41,
+  0xe2, 0xdf, 0xf0, 0x23, 0xee, 0x3d, 0xc5, 0x61, 0x4b, 0xfa, 0xfd, 0x9d, 0xee, 0x6f, 0xaf, 0xd9,
+  0xa6, 0x58, 0x32, 0xc6, 0xf9, 0x01, 0x5b, 0xcd, 0x8d, 0xee, 0x7a, 0x63, 0x4c, 0x62, 0x65, 0xc0,
+  0xb6, 0xff, 0xab, 0x05, 0xf4, 0xff, 0xe2, 0x30, 0xb0, 0xf9, 0x1e, 0x20, 0x63, 0xfc, 0x16, 0xf2,
+  0xab, 0x59, 0x2f, 0x1c, 0xed, 0xd8, 0xf1, 0x81, 0x6f, 0x8b, 0x07, 0xff, 0xca, 0xd7, 0x6f, 0x7a,
+  0x8c, 0x1b, 0x74, 0xb5, 0x3b, 0xf3, 0xb4, 0xdb, 0xad, 0xed, 0x27, 0xd6, 0xdf, 0xea, 0x39, 0x03,
+  0x6c, 0x73, 0x09, 0x00, 0x00,
+};
+
+static const knx_asset_t knx_assets[] = {
+  { ROOT_PREFIX "/knx.css", "text/css", knx_asset_knx_css, sizeof(knx_asset_knx_css), "\"" KNX_ASSET_KNX_CSS_VERSION "\"", ASSET_CACHE_IMMUTABLE },
+  { ROOT_PREFIX "/live.html", "text/html", knx_asset_live_html, sizeof(knx_asset_live_html), "\"" KNX_ASSET_LIVE_HTML_VERSION "\"", ASSET_CACHE_REVALIDATE },
+};
+
+#define KNX_ASSET_COUNT (sizeof(knx_assets) / sizeof(knx_assets[0]))
+
+#endif
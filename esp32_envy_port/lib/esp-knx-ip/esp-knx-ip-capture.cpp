@@ -0,0 +1,245 @@
+/**
+ * esp-knx-ip library for KNX/IP communication on an ESP32
+ * Binary capture of every received telegram into rotating files on flash
+ * License: MIT
+ */
+
+#include "esp-knx-ip.h"
+#include <esp_log.h>
+#define DEBUG_TAG "KNXIP"
+
+KnxCapture::KnxCapture() : fs(nullptr), file_len(0), block(nullptr), count(0), first_ms(0), last_us(0),
+                           telegrams(0), dropped(0)
+{
+  dir[0] = '\0';
+  knx_lock_init(&lock);
+  memset(&counters, 0, sizeof(counters));
+}
+
+bool KnxCapture::begin(fs::FS &fs, const char *dir)
+{
+  if (active())
+    return true;
+  if (strlen(dir) >= sizeof(this->dir))
+    return false;
+  strcpy(this->dir, dir);
+  fs.mkdir(dir);
+
+  // Carry on numbering after the files a previous run left behind
+  fs::File d = fs.open(dir);
+  if (!d || !d.isDirectory())
+  {
+    ESP_LOGE(DEBUG_TAG, "Capture: cannot open %s", dir);
+    return false;
+  }
+  bool found = false;
+  for (fs::File f = d.openNextFile(); f; f = d.openNextFile())
+  {
+    const char *name = strrchr(f.name(), '/');
+    name = name != nullptr ? name + 1 : f.name();
+    char *end;
+    unsigned long segment = strtoul(name, &end, 10);
+    if (end == name || strcmp(end, ".kc") != 0)
+      continue;
+    if (!found || segment < counters.first_segment)
+      counters.first_segment = segment;
+    if (!found || segment >= counters.next_segment)
+      counters.next_segment = segment + 1;
+    found = true;
+  }
+  d.close();
+
+  knx_event_init(&event);
+  if (!knx_task_start(&task, "knx_capture", &KnxCapture::__task, this, CAPTURE_TASK_STACK_SIZE, CAPTURE_TASK_PRIORITY, -1))
+  {
+    ESP_LOGE(DEBUG_TAG, "Capture: could not start writer task");
+    return false;
+  }
+  this->fs = &fs;
+  ESP_LOGI(DEBUG_TAG, "Capture started in %s at file %u", dir, (unsigned)counters.next_segment);
+  return true;
+}
+
+void KnxCapture::push(telegram_t const &telegram, uint32_t now_us, uint32_t now_ms)
+{
+  uint16_t need = CAPTURE_RECORD_LEN + telegram.data_len;
+  if (block != nullptr && (block->len + need > CAPTURE_BLOCK_SIZE || count == 0xFF))
+    __commit();
+  if (block == nullptr)
+  {
+    block = blocks.reserve();
+    if (block == nullptr)
+    {
+      dropped.fetch_add(1, std::memory_order_relaxed);
+      return;
+    }
+    block->len = CAPTURE_HEADER_LEN;
+    count = 0;
+  }
+
+  uint8_t *r = block->buf + block->len;
+  if (count == 0)
+  {
+    first_ms = now_ms;
+    last_us = now_us;
+    uint8_t *h = block->buf;
+    h[6] = now_ms;
+    h[7] = now_ms >> 8;
+    h[8] = now_ms >> 16;
+    h[9] = now_ms >> 24;
+    h[10] = now_us;
+    h[11] = now_us >> 8;
+    h[12] = now_us >> 16;
+    h[13] = now_us >> 24;
+  }
+  uint32_t delta = now_us - last_us;
+  last_us = now_us;
+  do
+  {
+    *r++ = (delta & 0x7F) | (delta > 0x7F ? 0x80 : 0);
+    delta >>= 7;
+  } while (delta > 0);
+  r[0] = telegram.source.bytes.high;
+  r[1] = telegram.source.bytes.low;
+  r[2] = telegram.destination.bytes.high;
+  r[3] = telegram.destination.bytes.low;
+  r[4] = telegram.ct;
+  r[5] = telegram.data_len;
+  if (telegram.data_len > 0)
+  {
+    memcpy(r + 6, telegram.data, telegram.data_len);
+    r[6] &= 0x3F;
+  }
+  block->len = (r + 6 + telegram.data_len) - block->buf;
+  count++;
+  telegrams.fetch_add(1, std::memory_order_relaxed);
+}
+
+void KnxCapture::flush(uint32_t now_ms)
+{
+  if (pending() && (uint32_t)(now_ms - first_ms) >= CAPTURE_FLUSH_MS)
+    __commit();
+}
+
+// Hands the block being filled to the writer task
+void KnxCapture::__commit()
+{
+  uint8_t *h = block->buf;
+  uint16_t len = block->len - CAPTURE_HEADER_LEN;
+  h[0] = CAPTURE_MAGIC_0;
+  h[1] = CAPTURE_MAGIC_1;
+  h[2] = CAPTURE_VERSION;
+  h[3] = count;
+  h[4] = len;
+  h[5] = len >> 8;
+  blocks.commit();
+  block = nullptr;
+  knx_event_signal(&event);
+}
+
+void KnxCapture::__task(void *arg)
+{
+  KnxCapture *self = (KnxCapture *)arg;
+  for (;;)
+  {
+    knx_event_wait(&self->event, 1000);
+    capture_block_t *b;
+    while ((b = self->blocks.front()) != nullptr)
+    {
+      self->__write(*b);
+      self->blocks.pop();
+    }
+  }
+}
+
+void KnxCapture::__write(capture_block_t const &b)
+{
+  knx_lock_take(&lock);
+  if (!file || file_len + b.len > CAPTURE_FILE_SIZE)
+    __open_segment();
+  if (file && file.write(b.buf, b.len) == b.len)
+  {
+    file.flush();
+    file_len += b.len;
+    counters.blocks++;
+    counters.bytes += b.len;
+  }
+  else
+  {
+    counters.write_errors++;
+  }
+  knx_lock_give(&lock);
+}
+
+// Caller holds lock
+bool KnxCapture::__open_segment()
+{
+  char path[CAPTURE_PATH_MAX];
+  file.close();
+  __segment_path(counters.next_segment, path);
+  file = fs->open(path, FILE_WRITE);
+  file_len = 0;
+  if (!file)
+  {
+    ESP_LOGE(DEBUG_TAG, "Capture: cannot create %s", path);
+    return false;
+  }
+  counters.next_segment++;
+  while (counters.next_segment - counters.first_segment > CAPTURE_FILES)
+  {
+    __segment_path(counters.first_segment, path);
+    fs->remove(path);
+    counters.first_segment++;
+  }
+  return true;
+}
+
+void KnxCapture::__segment_path(uint32_t segment, char *path)
+{
+  snprintf(path, CAPTURE_PATH_MAX, "%s/%lu.kc", dir, (unsigned long)segment);
+}
+
+size_t KnxCapture::read(capture_cursor_t &cursor, uint8_t *buf, size_t max_len)
+{
+  char path[CAPTURE_PATH_MAX];
+  size_t n = 0;
+  knx_lock_take(&lock);
+  // Files rotated away under a slow download are skipped
+  if (cursor.segment < counters.first_segment)
+  {
+    cursor.segment = counters.first_segment;
+    cursor.offset = 0;
+  }
+  while (cursor.segment < counters.next_segment)
+  {
+    // Opened per chunk, so a download holds no file while the writer rotates
+    __segment_path(cursor.segment, path);
+    fs::File f = fs->open(path, FILE_READ);
+    size_t size = f ? f.size() : 0;
+    if (cursor.offset < size)
+    {
+      f.seek(cursor.offset);
+      n = f.read(buf, size - cursor.offset < max_len ? size - cursor.offset : max_len);
+      cursor.offset += n;
+      f.close();
+      break;
+    }
+    f.close();
+    if (cursor.segment + 1 == counters.next_segment)
+      break; // at the end of the file being written
+    cursor.segment++;
+    cursor.offset = 0;
+  }
+  knx_lock_give(&lock);
+  return n;
+}
+
+capture_stats_t KnxCapture::stats()
+{
+  knx_lock_take(&lock);
+  capture_stats_t s = counters;
+  knx_lock_give(&lock);
+  s.telegrams = telegrams.load(std::memory_order_relaxed);
+  s.dropped = dropped.load(std::memory_order_relaxed);
+  return s;
+}
@@ -0,0 +1,115 @@
+/**
+ * esp-knx-ip library for KNX/IP communication on an ESP32
+ * Binary capture of every received telegram into rotating files on flash
+ * License: MIT
+ */
+
+#ifndef ESP_KNX_IP_CAPTURE_H
+#define ESP_KNX_IP_CAPTURE_H
+
+#include <FS.h>
+#include <atomic>
+#include "esp-knx-ip-frame.h"
+#include "esp-knx-ip-ring.h"
+#include "esp-knx-ip-task.h"
+
+#define CAPTURE_VERSION       1
+#define CAPTURE_MAGIC_0       'K'
+#define CAPTURE_MAGIC_1       'C'
+#define CAPTURE_HEADER_LEN    14
+#define CAPTURE_RECORD_LEN    11  // without the payload, with the longest delta
+#define CAPTURE_PATH_MAX      48
+
+#if CAPTURE_BLOCK_SIZE < CAPTURE_HEADER_LEN + CAPTURE_RECORD_LEN + 255
+#error "CAPTURE_BLOCK_SIZE must hold a record with the largest payload"
+#endif
+
+typedef struct __capture_stats {
+  uint32_t telegrams;     // records written to a block
+  uint32_t dropped;       // telegrams lost because every block was waiting for flash
+  uint32_t blocks;        // blocks written to flash
+  uint32_t bytes;
+  uint32_t write_errors;
+  uint32_t first_segment; // oldest file still kept
+  uint32_t next_segment;  // the file being written is next_segment - 1
+} capture_stats_t;
+
+typedef struct __capture_block {
+  uint16_t len; // bytes used in buf, including the header
+  uint8_t buf[CAPTURE_BLOCK_SIZE];
+} capture_block_t;
+
+/* Where a download has got to */
+typedef struct __capture_cursor {
+  uint32_t segment;
+  uint32_t offset;
+} capture_cursor_t;
+
+/*
+ * Records are collected in RAM blocks of CAPTURE_BLOCK_SIZE bytes and
+ * handed to a writer task as whole blocks, so the receive path only copies
+ * bytes and flash is written a block at a time. A block that is not full
+ * goes out after CAPTURE_FLUSH_MS. When all CAPTURE_BLOCKS are waiting for
+ * flash, telegrams are counted as dropped rather than waited for.
+ *
+ * Files are dir/<segment>.kc, numbered upwards. A file is closed at
+ * CAPTURE_FILE_SIZE, and only the last CAPTURE_FILES are kept. Each start
+ * begins a new file, so a reboot never appends to an old one. A file is a
+ * sequence of blocks, each readable on its own:
+ *
+ *   'K', 'C', version, record count, length of the records (uint16, LE),
+ *   millis() and micros() of the first record (uint32, LE)
+ *
+ * followed by records of
+ *
+ *   µs since the previous record, or since the block start (LEB128),
+ *   source (2), destination (2), ct, length, payload
+ *
+ * with the addresses in bus order and the APCI bits of the first payload
+ * byte cleared.
+ */
+class KnxCapture
+{
+  public:
+    KnxCapture();
+
+    bool begin(fs::FS &fs, const char *dir);
+    /* Cheap check for the hot path */
+    bool active() const { return fs != nullptr; }
+    bool pending() const { return block != nullptr && block->len > CAPTURE_HEADER_LEN; }
+    void push(telegram_t const &telegram, uint32_t now_us, uint32_t now_ms);
+    void flush(uint32_t now_ms);
+    capture_stats_t stats();
+
+    /* Copies the next bytes of the capture, oldest file first. Returns 0 at the end. */
+    size_t read(capture_cursor_t &cursor, uint8_t *buf, size_t max_len);
+
+  private:
+    static void __task(void *arg);
+    void __write(capture_block_t const &b);
+    bool __open_segment();
+    void __segment_path(uint32_t segment, char *path);
+    void __commit();
+
+    fs::FS *fs;
+    char dir[CAPTURE_PATH_MAX - 16];
+    knx_task_t task;
+    knx_event_t event;
+    knx_lock_t lock; // held while flash is written, read or files rotated
+    fs::File file;
+    uint32_t file_len;
+
+    // Producer side, loop()
+    SpscRing<capture_block_t, CAPTURE_BLOCKS> blocks;
+    capture_block_t *block; // reserved and being filled, nullptr if none was free
+    uint8_t count;
+    uint32_t first_ms;
+    uint32_t last_us;
+    // Read by stats() from other tasks without the lock, which push() must not wait for
+    std::atomic<uint32_t> telegrams;
+    std::atomic<uint32_t> dropped;
+
+    capture_stats_t counters; // the rest, under lock
+};
+
+#endif
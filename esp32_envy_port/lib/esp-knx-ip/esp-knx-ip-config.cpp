@@ -17,7 +17,7 @@
  
  config_id_t ESPKNXIP::config_register_string(String name, uint8_t len, String _default, enable_condition_t cond)
  {
-   if (registered_configs >= MAX_CONFIGS)
+   if (registered_configs >= custom_configs.capacity())
      return -1;
  
    if (_default.length() >= len)
@@ -44,7 +44,7 @@
  
  config_id_t ESPKNXIP::config_register_int(String name, int32_t _default, enable_condition_t cond)
  {
-   if (registered_configs >= MAX_CONFIGS)
+   if (registered_configs >= custom_configs.capacity())
      return -1;
  
    config_id_t id = registered_configs;
@@ -68,7 +68,7 @@
  
  config_id_t ESPKNXIP::config_register_bool(String name, bool _default, enable_condition_t cond)
  {
-   if (registered_configs >= MAX_CONFIGS)
+   if (registered_configs >= custom_configs.capacity())
      return -1;
  
    config_id_t id = registered_configs;
@@ -92,7 +92,7 @@
  
  config_id_t ESPKNXIP::config_register_options(String name, option_entry_t *options, uint8_t _default, enable_condition_t cond)
  {
-   if (registered_configs >= MAX_CONFIGS)
+   if (registered_configs >= custom_configs.capacity())
      return -1;
  
    if (options == nullptr || options->name == nullptr)
@@ -121,7 +121,7 @@
  
  config_id_t ESPKNXIP::config_register_ga(String name, enable_condition_t cond)
  {
-   if (registered_configs >= MAX_CONFIGS)
+   if (registered_configs >= custom_configs.capacity())
      return -1;
  
    config_id_t id = registered_configs;
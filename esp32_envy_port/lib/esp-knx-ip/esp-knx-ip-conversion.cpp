@@ -7,78 +7,63 @@
 
  #include "esp-knx-ip.h"
 
- // Conversion functions remain unchanged since they perform platform-independent operations.
- bool ESPKNXIP::data_to_bool(uint8_t *data)
+ // Thin wrappers over the Dpt<> codecs in esp-knx-ip-dpt.h
+ bool ESPKNXIP::data_to_bool(const uint8_t *data)
  {
-   return (data[0] & 0x01) == 1;
+   return Dpt<1>::decode(data);
  }
  
- int8_t ESPKNXIP::data_to_1byte_int(uint8_t *data)
+ int8_t ESPKNXIP::data_to_1byte_int(const uint8_t *data)
  {
-   return (int8_t)data[1];
+   return Dpt<6>::decode(data);
  }
  
- uint8_t ESPKNXIP::data_to_1byte_uint(uint8_t *data)
+ uint8_t ESPKNXIP::data_to_1byte_uint(const uint8_t *data)
  {
-   return data[1];
+   return Dpt<5>::decode(data);
  }
  
- int16_t ESPKNXIP::data_to_2byte_int(uint8_t *data)
+ int16_t ESPKNXIP::data_to_2byte_int(const uint8_t *data)
  {
-   return (int16_t)((data[1] << 8) | data[2]);
+   return Dpt<8>::decode(data);
  }
  
- uint16_t ESPKNXIP::data_to_2byte_uint(uint8_t *data)
+ uint16_t ESPKNXIP::data_to_2byte_uint(const uint8_t *data)
  {
-   return (uint16_t)((data[1] << 8) | data[2]);
+   return Dpt<7>::decode(data);
  }
  
- float ESPKNXIP::data_to_2byte_float(uint8_t *data)
+ float ESPKNXIP::data_to_2byte_float(const uint8_t *data)
  {
-   uint8_t expo = (data[1] & 0b01111000) >> 3;
-   int16_t mant = ((data[1] & 0b10000111) << 8) | data[2];
-   return 0.01f * mant * pow(2, expo);
+   return Dpt<9>::decode(data);
  }
  
- time_of_day_t ESPKNXIP::data_to_3byte_time(uint8_t *data)
+ time_of_day_t ESPKNXIP::data_to_3byte_time(const uint8_t *data)
  {
-   time_of_day_t time;
-   time.weekday = (weekday_t)((data[1] & 0b11100000) >> 5);
-   time.hours = (data[1] & 0b00011111);
-   time.minutes = (data[2] & 0b00111111);
-   time.seconds = (data[3] & 0b00111111);
-   return time;
+   return Dpt<10>::decode(data);
  }
  
- date_t ESPKNXIP::data_to_3byte_data(uint8_t *data)
+ date_t ESPKNXIP::data_to_3byte_data(const uint8_t *data)
  {
-   date_t date;
-   date.day = (data[1] & 0b00011111);
-   date.month = (data[2] & 0b00001111);
-   date.year = (data[3] & 0b01111111);
-   return date;
+   return Dpt<11>::decode(data);
  }
  
- color_t ESPKNXIP::data_to_3byte_color(uint8_t *data)
+ color_t ESPKNXIP::data_to_3byte_color(const uint8_t *data)
  {
-   color_t color;
-   color.red = data[1];
-   color.green = data[2];
-   color.blue = data[3];
-   return color;
+   return Dpt<232>::decode(data);
  }
  
- int32_t ESPKNXIP::data_to_4byte_int(uint8_t *data)
+ int32_t ESPKNXIP::data_to_4byte_int(const uint8_t *data)
  {
-   return (int32_t)((data[1] << 24) | (data[2] << 16) | (data[3] << 8) | data[4]);
+   return Dpt<13>::decode(data);
  }
  
- uint32_t ESPKNXIP::data_to_4byte_uint(uint8_t *data)
+ uint32_t ESPKNXIP::data_to_4byte_uint(const uint8_t *data)
  {
-   return (uint32_t)((data[1] << 24) | (data[2] << 16) | (data[3] << 8) | data[4]);
+   return Dpt<12>::decode(data);
  }
  
- float ESPKNXIP::data_to_4byte_float(uint8_t *data)
+ float ESPKNXIP::data_to_4byte_float(const uint8_t *data)
  {
-   return (float)((data[1] << 24) | (data[2] << 16) | (data[3] << 8) | data[4]);
- }
\ No newline at end of file
+   return Dpt<14>::decode(data);
+ }
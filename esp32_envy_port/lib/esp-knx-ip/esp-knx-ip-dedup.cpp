@@ -0,0 +1,112 @@
+/**
+ * esp-knx-ip library for KNX/IP communication on an ESP32
+ * Time-windowed cache that recognises echoes of our own frames and repeated telegrams
+ * License: MIT
+ */
+
+#include "esp-knx-ip-dedup.h"
+#include <string.h>
+
+#define DEDUP_FLAG_VALID 0x01
+
+KnxDedupCache::KnxDedupCache() : window(0)
+{
+  memset(entries, 0, sizeof(entries));
+  memset(&counters, 0, sizeof(counters));
+}
+
+uint64_t KnxDedupCache::key(uint16_t source, uint16_t destination, uint8_t ct, const uint8_t *data, uint8_t data_len)
+{
+  // FNV-1a over the payload; the APCI bits in the first byte are covered by ct
+  uint32_t h = 2166136261u;
+  for (uint8_t i = 0; i < data_len; ++i)
+  {
+    h ^= (i == 0) ? (data[0] & 0x3F) : data[i];
+    h *= 16777619u;
+  }
+  h ^= ((uint32_t)ct << 24) | data_len;
+  return ((uint64_t)source << 48) | ((uint64_t)destination << 32) | h;
+}
+
+dedup_entry_t *KnxDedupCache::__lookup(uint64_t key, uint32_t now_ms, dedup_entry_t *&victim)
+{
+  uint32_t mix = (uint32_t)(key ^ (key >> 29));
+  dedup_entry_t *set = entries[((mix * 0x9E3779B1u) >> 24) & (DEDUP_SETS - 1)];
+  dedup_entry_t *hit = nullptr;
+  uint32_t victim_age = 0;
+  victim = &set[0];
+  for (uint8_t w = 0; w < DEDUP_WAYS; ++w)
+  {
+    dedup_entry_t &e = set[w];
+    uint32_t age = (e.flags & DEDUP_FLAG_VALID) ? (uint32_t)(now_ms - e.stamp_ms) : UINT32_MAX;
+    if (age < window && e.key == key)
+      hit = &e;
+    // Evict empty slots first, then the oldest entry
+    if (age >= victim_age)
+    {
+      victim = &e;
+      victim_age = age;
+    }
+  }
+  return hit;
+}
+
+void KnxDedupCache::sent(uint64_t key, uint32_t now_ms)
+{
+  if (window == 0)
+    return;
+  dedup_entry_t *victim;
+  dedup_entry_t *e = __lookup(key, now_ms, victim);
+  if (e == nullptr)
+  {
+    e = victim;
+    e->key = key;
+    e->flags = DEDUP_FLAG_VALID;
+    e->echoes = 0;
+  }
+  // Sending the same telegram again before its echo is back expects two echoes
+  e->stamp_ms = now_ms;
+  if (e->echoes < UINT8_MAX)
+    e->echoes++;
+}
+
+dedup_verdict_t KnxDedupCache::received(uint64_t key, uint32_t now_ms, bool repeated)
+{
+  if (window == 0)
+  {
+    counters.passed++;
+    return DEDUP_NEW;
+  }
+
+  dedup_entry_t *victim;
+  dedup_entry_t *e = __lookup(key, now_ms, victim);
+  if (e != nullptr)
+  {
+    if (e->echoes > 0 && !repeated)
+    {
+      // One echo per send; a repeat of our frame is a duplicate below
+      e->echoes--;
+      counters.echoes++;
+      return DEDUP_ECHO;
+    }
+    if (repeated)
+    {
+      // The window is not extended, so a repeat long after its original
+      // is delivered like any other frame whose original was missed
+      counters.duplicates++;
+      return DEDUP_DUPLICATE;
+    }
+    // The same value sent again on purpose: deliver it, and its repeats
+    // are measured from this copy
+    e->stamp_ms = now_ms;
+    counters.passed++;
+    return DEDUP_NEW;
+  }
+
+  victim->key = key;
+  victim->stamp_ms = now_ms;
+  victim->flags = DEDUP_FLAG_VALID;
+  victim->echoes = 0;
+  counters.passed++;
+  return DEDUP_NEW;
+}
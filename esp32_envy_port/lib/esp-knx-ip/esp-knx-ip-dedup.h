@@ -0,0 +1,71 @@
+/**
+ * esp-knx-ip library for KNX/IP communication on an ESP32
+ * Time-windowed cache that recognises echoes of our own frames and repeated telegrams
+ * License: MIT
+ */
+
+#ifndef ESP_KNX_IP_DEDUP_H
+#define ESP_KNX_IP_DEDUP_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define DEDUP_WAYS 4
+#define DEDUP_SETS 16
+
+typedef enum __dedup_verdict {
+  DEDUP_NEW,       // deliver it
+  DEDUP_ECHO,      // a frame we sent ourselves, coming back from the multicast group
+  DEDUP_DUPLICATE, // flagged as repeated, and the original was delivered within the window
+} dedup_verdict_t;
+
+typedef struct __dedup_stats {
+  uint32_t passed;
+  uint32_t echoes;
+  uint32_t duplicates;
+} dedup_stats_t;
+
+typedef struct __dedup_entry {
+  uint64_t key;
+  uint32_t stamp_ms;
+  uint8_t flags;
+  uint8_t echoes;   // our own sends of this telegram whose echo has not come back yet
+} dedup_entry_t;
+
+/*
+ * Fixed-size, set-associative cache of recently seen telegrams keyed on
+ * (source, destination, command type, payload hash). Every lookup hashes
+ * the telegram once and looks at DEDUP_WAYS entries, so the cost per
+ * telegram does not grow with traffic. Old entries are simply overwritten.
+ */
+class KnxDedupCache
+{
+  public:
+    KnxDedupCache();
+
+    /* window_ms == 0 disables the cache: every telegram is new */
+    void window_set(uint32_t window_ms) { window = window_ms; }
+    uint32_t window_get() const { return window; }
+
+    static uint64_t key(uint16_t source, uint16_t destination, uint8_t ct, const uint8_t *data, uint8_t data_len);
+
+    /* Remembers a frame we are about to send, so its echo is recognised */
+    void sent(uint64_t key, uint32_t now_ms);
+    /*
+     * Classifies a received frame and remembers it. Only echoes of our own
+     * sends and frames with the repeat flag set are dropped: a device may
+     * send the same value twice on purpose, and both copies are delivered.
+     */
+    dedup_verdict_t received(uint64_t key, uint32_t now_ms, bool repeated);
+
+    dedup_stats_t const &stats() const { return counters; }
+
+  private:
+    dedup_entry_t *__lookup(uint64_t key, uint32_t now_ms, dedup_entry_t *&victim);
+
+    dedup_entry_t entries[DEDUP_SETS][DEDUP_WAYS];
+    uint32_t window;
+    dedup_stats_t counters;
+};
+
+#endif
@@ -0,0 +1,285 @@
+/**
+ * esp-knx-ip library for KNX/IP communication on an ESP32
+ * Datapoint type codecs: Dpt<Main, Sub>::encode()/decode() between values and payload bytes
+ * License: MIT
+ */
+
+#ifndef ESP_KNX_IP_DPT_H
+#define ESP_KNX_IP_DPT_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <limits>
+#include "DPT.h"
+
+/*
+ * Payload as handed to send(): byte 0 shares its top two bits with the APCI,
+ * so types of up to six bits live in its low bits and wider types start at
+ * byte 1.
+ */
+template <size_t N>
+struct dpt_bytes_t {
+  uint8_t data[N];
+};
+
+/*
+ * One codec per DPT main number. Each one defines value_type, size (payload
+ * bytes including byte 0), encode(value) and decode(data). encode() and
+ * decode() are constexpr where C++11 allows it, so encoding a constant
+ * yields a constant payload. Only DPT 14 needs the bit pattern of a float
+ * and cannot be constexpr. decode() expects size bytes; callers holding a
+ * received message go through ESPKNXIP::decode<>(), which checks the length.
+ */
+template <uint16_t Main>
+struct DptFormat;
+
+/* Subtypes share their main type's encoding unless specialised below */
+template <uint16_t Main, uint16_t Sub = 0>
+struct Dpt : DptFormat<Main> {};
+
+namespace dpt_detail {
+  constexpr uint32_t be16(const uint8_t *d) { return ((uint32_t)d[0] << 8) | d[1]; }
+  constexpr uint32_t be32(const uint8_t *d) { return ((uint32_t)d[0] << 24) | ((uint32_t)d[1] << 16) | ((uint32_t)d[2] << 8) | d[3]; }
+  constexpr int32_t round_half_away(float v)
+  {
+    return (int32_t)v + (v - (int32_t)v >= 0.5f ? 1 : (v - (int32_t)v <= -0.5f ? -1 : 0));
+  }
+
+  /*
+   * DPT 9, compile-time path: halve until the value fits the 12-bit
+   * mantissa, then round. Exponents past 15 saturate. 0x7FFF, exponent 15
+   * with mantissa 2047, is the "invalid data" code, so the largest value
+   * that can be sent is 0x7FFE.
+   */
+  constexpr uint8_t f16_exponent(float v, uint8_t e)
+  {
+    return (e < 15 && (v < -2048.0f || v > 2047.0f)) ? f16_exponent(v / 2, e + 1) : e;
+  }
+  constexpr uint16_t f16_pack(uint8_t e, int32_t m) { return (m < 0 ? 0x8000 : 0) | ((uint16_t)e << 11) | (m & 0x7FF); }
+  constexpr int32_t f16_round(float scaled)
+  {
+    return scaled >= 2047.5f ? 2047 : (scaled <= -2048.5f ? -2048 : round_half_away(scaled));
+  }
+  constexpr int32_t f16_valid(uint8_t e, int32_t m) { return e == 15 && m == 2047 ? 2046 : m; }
+  constexpr uint16_t f16_encode(float v, uint8_t e) { return f16_pack(e, f16_valid(e, f16_round(v / (float)(1 << e)))); }
+  constexpr uint16_t f16_from_const(float centi)
+  {
+    return centi != centi ? 0x7FFF : f16_encode(centi, f16_exponent(centi, 0)); // NaN is the DPT 9 "invalid" code
+  }
+
+  /*
+   * DPT 9, run-time path: the same result computed from the float's bits.
+   * The exponent comes straight from the IEEE exponent, and rounding to
+   * the mantissa is a single integer add and shift.
+   */
+  inline uint16_t f16_from_bits(float centi)
+  {
+    uint32_t bits;
+    memcpy(&bits, &centi, sizeof(bits));
+    uint32_t neg = bits >> 31;
+    int32_t exp2 = (int32_t)((bits >> 23) & 0xFF) - 127;             // centi is in [2^exp2, 2^(exp2+1))
+    uint64_t frac = (bits & 0x7FFFFF) | 0x800000;                     // centi = frac * 2^(exp2 - 23)
+    int32_t e = exp2 - 10;
+    e &= ~(e >> 31);                                                  // max(e, 0)
+    // -2048 * 2^k is the one negative value that fits one exponent lower
+    e -= (int32_t)(neg & (uint32_t)((bits & 0x7FFFFF) == 0) & (uint32_t)(e > 0));
+    int32_t shift = 23 + e - exp2;                                    // frac >> shift is centi / 2^e
+    shift = shift > 40 ? 40 : shift;                                  // everything smaller rounds to 0
+    // 2047 < v < 2048 still has to be halved once; -2048 fits as it is
+    uint32_t bump = (neg ^ 1) & (uint32_t)(frac > ((uint64_t)2047 << shift));
+    e += bump;
+    shift += bump;
+    uint32_t m = (uint32_t)((frac + ((uint64_t)1 << (shift - 1))) >> shift);
+    // Past exponent 15 the value saturates at the end of the range, which
+    // is 0x7FFE on the positive side: 0x7FFF means "invalid data"
+    uint32_t over = (uint32_t)(e > 15);
+    e = over ? 15 : e;
+    m = over ? 2047 + neg : m;
+    m -= (uint32_t)(e == 15) & (neg ^ 1) & (uint32_t)(m == 2047);
+    // Zero has no sign
+    neg &= (uint32_t)(m != 0);
+    uint32_t mant = ((m ^ (0u - neg)) + neg) & 0x7FF;
+    uint16_t code = (uint16_t)((neg << 15) | ((uint32_t)e << 11) | mant);
+    return centi != centi ? 0x7FFF : code;
+  }
+
+  constexpr uint16_t f16_from(float centi)
+  {
+    return __builtin_constant_p(centi) ? f16_from_const(centi) : f16_from_bits(centi);
+  }
+
+  /* DPT 9 decode: 0.01 * 2^exponent for every exponent, and NaN for the invalid code 0x7FFF */
+  constexpr float f16_scale[16] = {
+    0.01f, 0.02f, 0.04f, 0.08f, 0.16f, 0.32f, 0.64f, 1.28f,
+    2.56f, 5.12f, 10.24f, 20.48f, 40.96f, 81.92f, 163.84f, 327.68f,
+  };
+  constexpr int32_t f16_mantissa(uint32_t m12) { return (int32_t)m12 - (int32_t)((m12 & 0x800) << 1); }
+  constexpr float f16_to(uint8_t hi, uint8_t lo)
+  {
+    return hi == 0x7F && lo == 0xFF ? std::numeric_limits<float>::quiet_NaN()
+                                    : f16_scale[(hi >> 3) & 0x0F] * (float)f16_mantissa(((uint32_t)(hi & 0x80) << 4) | ((uint32_t)(hi & 0x07) << 8) | lo);
+  }
+
+  /* DPT 16: character i of s, or 0 past its end */
+  constexpr uint8_t str_at(const char *s, uint8_t i) { return s[0] == 0 ? 0 : (i == 0 ? (uint8_t)s[0] : str_at(s + 1, i - 1)); }
+}
+
+/* DPT 1.xxx boolean */
+template <> struct DptFormat<1> {
+  typedef bool value_type;
+  static const uint8_t size = 1;
+  static constexpr dpt_bytes_t<1> encode(bool v) { return {{(uint8_t)(v ? 1 : 0)}}; }
+  static constexpr bool decode(const uint8_t *d) { return (d[0] & 0x01) != 0; }
+};
+
+/* DPT 2.xxx 1-bit controlled */
+template <> struct DptFormat<2> {
+  typedef uint8_t value_type;
+  static const uint8_t size = 1;
+  static constexpr dpt_bytes_t<1> encode(uint8_t v) { return {{(uint8_t)(v & 0x03)}}; }
+  static constexpr uint8_t decode(const uint8_t *d) { return d[0] & 0x03; }
+};
+
+/* DPT 3.xxx 3-bit controlled */
+template <> struct DptFormat<3> {
+  typedef uint8_t value_type;
+  static const uint8_t size = 1;
+  static constexpr dpt_bytes_t<1> encode(uint8_t v) { return {{(uint8_t)(v & 0x0F)}}; }
+  static constexpr uint8_t decode(const uint8_t *d) { return d[0] & 0x0F; }
+};
+
+/* DPT 5.xxx 8-bit unsigned */
+template <> struct DptFormat<5> {
+  typedef uint8_t value_type;
+  static const uint8_t size = 2;
+  static constexpr dpt_bytes_t<2> encode(uint8_t v) { return {{0x00, v}}; }
+  static constexpr uint8_t decode(const uint8_t *d) { return d[1]; }
+};
+
+/* DPT 5.001 percentage, 0..100 % scaled to 0..255 */
+template <> struct Dpt<5, 1> {
+  typedef float value_type;
+  static const uint8_t size = 2;
+  static constexpr dpt_bytes_t<2> encode(float v)
+  {
+    return {{0x00, (uint8_t)(v <= 0.0f ? 0 : (v >= 100.0f ? 255 : dpt_detail::round_half_away(v * 2.55f)))}};
+  }
+  static constexpr float decode(const uint8_t *d) { return d[1] * (100.0f / 255.0f); }
+};
+
+/* DPT 6.xxx 8-bit signed */
+template <> struct DptFormat<6> {
+  typedef int8_t value_type;
+  static const uint8_t size = 2;
+  static constexpr dpt_bytes_t<2> encode(int8_t v) { return {{0x00, (uint8_t)v}}; }
+  static constexpr int8_t decode(const uint8_t *d) { return (int8_t)d[1]; }
+};
+
+/* DPT 7.xxx 2-byte unsigned */
+template <> struct DptFormat<7> {
+  typedef uint16_t value_type;
+  static const uint8_t size = 3;
+  static constexpr dpt_bytes_t<3> encode(uint16_t v) { return {{0x00, (uint8_t)(v >> 8), (uint8_t)v}}; }
+  static constexpr uint16_t decode(const uint8_t *d) { return (uint16_t)dpt_detail::be16(d + 1); }
+};
+
+/* DPT 8.xxx 2-byte signed */
+template <> struct DptFormat<8> {
+  typedef int16_t value_type;
+  static const uint8_t size = 3;
+  static constexpr dpt_bytes_t<3> encode(int16_t v) { return {{0x00, (uint8_t)((uint16_t)v >> 8), (uint8_t)v}}; }
+  static constexpr int16_t decode(const uint8_t *d) { return (int16_t)dpt_detail::be16(d + 1); }
+};
+
+/* DPT 9.xxx 2-byte float: 0.01 * mantissa * 2^exponent, 12-bit two's complement mantissa */
+template <> struct DptFormat<9> {
+  typedef float value_type;
+  static const uint8_t size = 3;
+  static constexpr dpt_bytes_t<3> encode(float v) { return DptFormat<7>::encode(dpt_detail::f16_from(v * 100.0f)); }
+  static constexpr float decode(const uint8_t *d) { return dpt_detail::f16_to(d[1], d[2]); }
+};
+
+/* DPT 10.001 time of day */
+template <> struct DptFormat<10> {
+  typedef time_of_day_t value_type;
+  static const uint8_t size = 4;
+  static constexpr dpt_bytes_t<4> encode(time_of_day_t const &t)
+  {
+    return {{0x00, (uint8_t)(((t.weekday << 5) & 0xE0) | (t.hours & 0x1F)), (uint8_t)(t.minutes & 0x3F), (uint8_t)(t.seconds & 0x3F)}};
+  }
+  static constexpr time_of_day_t decode(const uint8_t *d)
+  {
+    return {(weekday_t)((d[1] & 0xE0) >> 5), (uint8_t)(d[1] & 0x1F), (uint8_t)(d[2] & 0x3F), (uint8_t)(d[3] & 0x3F)};
+  }
+};
+
+/* DPT 11.001 date, year as 0..99 */
+template <> struct DptFormat<11> {
+  typedef date_t value_type;
+  static const uint8_t size = 4;
+  static constexpr dpt_bytes_t<4> encode(date_t const &d)
+  {
+    return {{0x00, (uint8_t)(d.day & 0x1F), (uint8_t)(d.month & 0x0F), (uint8_t)(d.year & 0x7F)}};
+  }
+  static constexpr date_t decode(const uint8_t *d) { return {(uint8_t)(d[1] & 0x1F), (uint8_t)(d[2] & 0x0F), (uint8_t)(d[3] & 0x7F)}; }
+};
+
+/* DPT 12.xxx 4-byte unsigned */
+template <> struct DptFormat<12> {
+  typedef uint32_t value_type;
+  static const uint8_t size = 5;
+  static constexpr dpt_bytes_t<5> encode(uint32_t v) { return {{0x00, (uint8_t)(v >> 24), (uint8_t)(v >> 16), (uint8_t)(v >> 8), (uint8_t)v}}; }
+  static constexpr uint32_t decode(const uint8_t *d) { return dpt_detail::be32(d + 1); }
+};
+
+/* DPT 13.xxx 4-byte signed */
+template <> struct DptFormat<13> {
+  typedef int32_t value_type;
+  static const uint8_t size = 5;
+  static constexpr dpt_bytes_t<5> encode(int32_t v) { return DptFormat<12>::encode((uint32_t)v); }
+  static constexpr int32_t decode(const uint8_t *d) { return (int32_t)dpt_detail::be32(d + 1); }
+};
+
+/* DPT 14.xxx IEEE 754 single precision */
+template <> struct DptFormat<14> {
+  typedef float value_type;
+  static const uint8_t size = 5;
+  static inline dpt_bytes_t<5> encode(float v)
+  {
+    uint32_t bits;
+    memcpy(&bits, &v, sizeof(bits));
+    return DptFormat<12>::encode(bits);
+  }
+  static inline float decode(const uint8_t *d)
+  {
+    uint32_t bits = dpt_detail::be32(d + 1);
+    float v;
+    memcpy(&v, &bits, sizeof(v));
+    return v;
+  }
+};
+
+/* DPT 16.xxx 14-character string, zero padded */
+template <> struct DptFormat<16> {
+  typedef const char *value_type;
+  static const uint8_t size = 15;
+  static constexpr dpt_bytes_t<15> encode(const char *s)
+  {
+    using dpt_detail::str_at;
+    return {{0x00, str_at(s, 0), str_at(s, 1), str_at(s, 2), str_at(s, 3), str_at(s, 4), str_at(s, 5), str_at(s, 6),
+             str_at(s, 7), str_at(s, 8), str_at(s, 9), str_at(s, 10), str_at(s, 11), str_at(s, 12), str_at(s, 13)}};
+  }
+  /* Not zero terminated when all 14 characters are used */
+  static inline const char *decode(const uint8_t *d) { return (const char *)(d + 1); }
+};
+
+/* DPT 232.600 RGB colour */
+template <> struct DptFormat<232> {
+  typedef color_t value_type;
+  static const uint8_t size = 4;
+  static constexpr dpt_bytes_t<4> encode(color_t const &c) { return {{0x00, c.red, c.green, c.blue}}; }
+  static constexpr color_t decode(const uint8_t *d) { return {d[1], d[2], d[3]}; }
+};
+
+#endif
@@ -0,0 +1,50 @@
+/**
+ * esp-knx-ip library for KNX/IP communication on an ESP32
+ * Routing flow control: how long to hold back outgoing frames after ROUTING_BUSY
+ * License: MIT
+ */
+
+#include "esp-knx-ip-flow.h"
+
+#define BUSY_COUNT_GUARD_MS   10
+#define BUSY_RANDOM_STEP_MS   50
+#define BUSY_SLOW_STEP_MS     100
+#define BUSY_DECAY_STEP_MS    5
+
+static inline bool __before(uint32_t a, uint32_t b)
+{
+  return (int32_t)(a - b) < 0;
+}
+
+void KnxFlowControl::busy(uint16_t wait_ms, uint32_t now_ms, uint32_t random)
+{
+  if (counter == 0 || !__before(now_ms, last_busy_ms + BUSY_COUNT_GUARD_MS))
+  {
+    if (counter < UINT16_MAX)
+      counter++;
+    last_busy_ms = now_ms;
+  }
+
+  uint32_t until = now_ms + wait_ms + random % ((uint32_t)counter * BUSY_RANDOM_STEP_MS + 1);
+  if (!paused || __before(resume_ms, until))
+    resume_ms = until;
+  paused = true;
+  decay_ms = now_ms + (uint32_t)counter * BUSY_SLOW_STEP_MS;
+}
+
+bool KnxFlowControl::may_send(uint32_t now_ms)
+{
+  if (paused)
+  {
+    if (__before(now_ms, resume_ms))
+      return false;
+    paused = false;
+  }
+
+  while (counter > 0 && !__before(now_ms, decay_ms))
+  {
+    counter--;
+    decay_ms += BUSY_DECAY_STEP_MS;
+  }
+  return true;
+}
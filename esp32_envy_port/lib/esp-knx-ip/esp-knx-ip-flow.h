@@ -0,0 +1,45 @@
+/**
+ * esp-knx-ip library for KNX/IP communication on an ESP32
+ * Routing flow control: how long to hold back outgoing frames after ROUTING_BUSY
+ * License: MIT
+ */
+
+#ifndef ESP_KNX_IP_FLOW_H
+#define ESP_KNX_IP_FLOW_H
+
+#include <stdint.h>
+
+typedef struct __knx_routing_stats {
+  uint32_t busy_received;  // ROUTING_BUSY frames addressed to all devices
+  uint32_t lost_reports;   // ROUTING_LOST_MESSAGE frames received
+  uint32_t lost_messages;  // sum of the lost counts those frames reported
+  uint16_t busy_counter;   // current N of the backoff
+} knx_routing_stats_t;
+
+/*
+ * Implements the sender side of KNXnet/IP routing flow control. On every
+ * ROUTING_BUSY the device pauses for the announced wait time plus a random
+ * share of N * 50 ms, where N counts recent BUSY frames. N goes up at most
+ * once per 10 ms and, after N * 100 ms without a new BUSY, goes down by one
+ * every 5 ms. All times are in milliseconds, and the caller passes in the
+ * clock and the random number.
+ */
+class KnxFlowControl
+{
+  public:
+    KnxFlowControl() : paused(false), resume_ms(0), last_busy_ms(0), decay_ms(0), counter(0) {}
+
+    void busy(uint16_t wait_ms, uint32_t now_ms, uint32_t random);
+    /* True when frames may go out at now_ms */
+    bool may_send(uint32_t now_ms);
+    uint16_t busy_counter() const { return counter; }
+
+  private:
+    bool paused;
+    uint32_t resume_ms;
+    uint32_t last_busy_ms;
+    uint32_t decay_ms;  // when N next goes down by one
+    uint16_t counter;
+};
+
+#endif
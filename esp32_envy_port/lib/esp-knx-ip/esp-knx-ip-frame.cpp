@@ -0,0 +1,151 @@
+/**
+ * esp-knx-ip library for KNX/IP communication on an ESP32
+ * KNXnet/IP routing frame layout and a bounds-checked parser for it.
+ * License: MIT
+ */
+
+#include "esp-knx-ip-frame.h"
+#include <string.h>
+
+#define KNX_IP_HEADER_LEN   6
+#define CEMI_HEADER_LEN     2 // message code, additional info length
+#define CEMI_SERVICE_LEN    8 // control 1/2, source, destination, data length, TPCI
+#define BUSY_INFO_LEN       6 // structure length, device state, wait time, control field
+#define LOST_INFO_LEN       4 // structure length, device state, lost message count
+
+/* header_len, protocol_version and service_type of a routing indication */
+#define ROUTING_INDICATION_PREFIX ((0x06UL << 24) | (0x10UL << 16) | KNX_ST_ROUTING_INDICATION)
+
+/*
+ * Routing indication, L_Data.ind, no additional info, standard frame with
+ * system broadcast, no repeat, low priority, group destination, hop count 6.
+ * Lengths, addresses and APCI are filled in per frame.
+ */
+static const uint8_t frame_template[KNX_FRAME_HEADER_LEN] = {
+  0x06, 0x10, 0x05, 0x30, 0x00, 0x00,   // KNX/IP header, total length
+  KNX_MT_L_DATA_IND, 0x00,              // message code, additional info length
+  0xBC, 0xE0,                           // control fields 1 and 2
+  0x00, 0x00, 0x00, 0x00,               // source, destination
+  0x00, 0x00,                           // data length, TPCI/APCI
+};
+
+static inline knx_parse_result_t __count(knx_parse_stats_t *stats, knx_parse_result_t result)
+{
+  if (stats != nullptr)
+    stats->count[result]++;
+  return result;
+}
+
+knx_parse_result_t knx_frame_parse(const uint8_t *buf, size_t len, telegram_t &telegram, knx_parse_stats_t *stats)
+{
+  if (len < KNX_IP_HEADER_LEN)
+    return __count(stats, KNX_PARSE_TOO_SHORT);
+
+  // Fast path: one compare decides whether the frame is worth looking at
+  uint32_t prefix = ((uint32_t)buf[0] << 24) | ((uint32_t)buf[1] << 16) | ((uint32_t)buf[2] << 8) | buf[3];
+  if (prefix != ROUTING_INDICATION_PREFIX)
+  {
+    if (buf[0] != 0x06)
+      return __count(stats, KNX_PARSE_BAD_HEADER_LEN);
+    if (buf[1] != 0x10)
+      return __count(stats, KNX_PARSE_BAD_VERSION);
+    return __count(stats, KNX_PARSE_FOREIGN_SERVICE);
+  }
+
+  // Trailing bytes past total_len are ignored, a truncated frame is not
+  size_t total_len = ((size_t)buf[4] << 8) | buf[5];
+  if (total_len < KNX_IP_HEADER_LEN || total_len > len)
+    return __count(stats, KNX_PARSE_BAD_TOTAL_LEN);
+  if (total_len < KNX_IP_HEADER_LEN + CEMI_HEADER_LEN)
+    return __count(stats, KNX_PARSE_TOO_SHORT);
+
+  const uint8_t *cemi = buf + KNX_IP_HEADER_LEN;
+  const uint8_t *end = buf + total_len;
+  if (cemi[0] != KNX_MT_L_DATA_IND)
+    return __count(stats, KNX_PARSE_BAD_MESSAGE_CODE);
+
+  const uint8_t *service = cemi + CEMI_HEADER_LEN + cemi[1];
+  if (service > end)
+    return __count(stats, KNX_PARSE_BAD_ADDITIONAL_INFO);
+  if (end - service < CEMI_SERVICE_LEN)
+    return __count(stats, KNX_PARSE_TOO_SHORT);
+
+  uint8_t data_len = service[6];
+  if (data_len == 0 || end - (service + CEMI_SERVICE_LEN) < data_len)
+    return __count(stats, KNX_PARSE_BAD_DATA_LEN);
+
+  // Destination address type is the top bit of control field 2
+  if ((service[1] & 0x80) == 0)
+    return __count(stats, KNX_PARSE_NOT_GROUP);
+
+  const uint8_t *data = service + CEMI_SERVICE_LEN;
+  telegram.source.bytes.high = service[2];
+  telegram.source.bytes.low = service[3];
+  telegram.destination.bytes.high = service[4];
+  telegram.destination.bytes.low = service[5];
+  telegram.ct = (knx_command_type_t)(((data[0] & 0xC0) >> 6) | ((service[7] & 0x03) << 2));
+  // The repeat bit of control field 1 is cleared on a repeated frame
+  telegram.repeated = (service[0] & 0x20) == 0;
+  telegram.data_len = data_len;
+  telegram.data = data;
+  return __count(stats, KNX_PARSE_OK);
+}
+
+bool knx_routing_ctrl_parse(const uint8_t *buf, size_t len, knx_routing_ctrl_t &ctrl)
+{
+  if (len < KNX_IP_HEADER_LEN || buf[0] != 0x06 || buf[1] != 0x10)
+    return false;
+
+  uint16_t service = ((uint16_t)buf[2] << 8) | buf[3];
+  size_t info_len;
+  if (service == KNX_ST_ROUTING_BUSY)
+    info_len = BUSY_INFO_LEN;
+  else if (service == KNX_ST_ROUTING_LOST_MESSAGE)
+    info_len = LOST_INFO_LEN;
+  else
+    return false;
+
+  size_t total_len = ((size_t)buf[4] << 8) | buf[5];
+  if (total_len > len || total_len < KNX_IP_HEADER_LEN + info_len)
+    return false;
+
+  const uint8_t *info = buf + KNX_IP_HEADER_LEN;
+  if (info[0] != info_len)
+    return false;
+
+  ctrl.service = (knx_service_type_t)service;
+  ctrl.device_state = info[1];
+  ctrl.wait_ms = 0;
+  ctrl.control = 0;
+  ctrl.lost = 0;
+  if (service == KNX_ST_ROUTING_BUSY)
+  {
+    ctrl.wait_ms = ((uint16_t)info[2] << 8) | info[3];
+    ctrl.control = ((uint16_t)info[4] << 8) | info[5];
+  }
+  else
+  {
+    ctrl.lost = ((uint16_t)info[2] << 8) | info[3];
+  }
+  return true;
+}
+
+size_t knx_frame_encode(uint8_t *out, address_t source, address_t destination, knx_command_type_t ct, const uint8_t *data, uint8_t data_len)
+{
+  if (data_len == 0)
+    return 0;
+
+  size_t len = KNX_FRAME_HEADER_LEN + data_len;
+  memcpy(out, frame_template, KNX_FRAME_HEADER_LEN);
+  out[4] = len >> 8;
+  out[5] = len & 0xFF;
+  out[10] = source.bytes.high;
+  out[11] = source.bytes.low;
+  out[12] = destination.bytes.high;
+  out[13] = destination.bytes.low;
+  out[14] = data_len;
+  out[15] = (ct & 0x0C) >> 2;
+  memcpy(out + KNX_FRAME_HEADER_LEN, data, data_len);
+  out[KNX_FRAME_HEADER_LEN] = (data[0] & 0x3F) | ((ct & 0x03) << 6);
+  return len;
+}
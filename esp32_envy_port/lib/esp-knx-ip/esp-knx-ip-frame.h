@@ -0,0 +1,221 @@
+/**
+ * esp-knx-ip library for KNX/IP communication on an ESP32
+ * KNXnet/IP routing frame layout and a bounds-checked parser for it.
+ * Nothing in here depends on the Arduino core.
+ * License: MIT
+ */
+
+#ifndef ESP_KNX_IP_FRAME_H
+#define ESP_KNX_IP_FRAME_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+typedef struct __cemi_addi {
+    uint8_t type_id;
+    uint8_t len;
+    uint8_t data[]; // flexible array member (last element)
+} cemi_addi_t;
+
+typedef union __address {
+  uint16_t value;
+  struct {
+    uint8_t high;
+    uint8_t low;
+  } bytes;
+  struct __attribute__((packed)) {
+    uint8_t line:3;
+    uint8_t area:5;
+    uint8_t member;
+  } ga;
+  struct __attribute__((packed)) {
+    uint8_t line:4;
+    uint8_t area:4;
+    uint8_t member;
+  } pa;
+  uint8_t array[2];
+} address_t;
+
+/* Service and Command Types */
+typedef enum __knx_service_type {
+  KNX_ST_SEARCH_REQUEST           = 0x0201,
+  KNX_ST_SEARCH_RESPONSE          = 0x0202,
+  KNX_ST_DESCRIPTION_REQUEST      = 0x0203,
+  KNX_ST_DESCRIPTION_RESPONSE     = 0x0204,
+  KNX_ST_CONNECT_REQUEST          = 0x0205,
+  KNX_ST_CONNECT_RESPONSE         = 0x0206,
+  KNX_ST_CONNECTIONSTATE_REQUEST  = 0x0207,
+  KNX_ST_CONNECTIONSTATE_RESPONSE = 0x0208,
+  KNX_ST_DISCONNECT_REQUEST       = 0x0209,
+  KNX_ST_DISCONNECT_RESPONSE      = 0x020A,
+  KNX_ST_DEVICE_CONFIGURATION_REQUEST = 0x0310,
+  KNX_ST_DEVICE_CONFIGURATION_ACK     = 0x0311,
+  KNX_ST_TUNNELING_REQUEST = 0x0420,
+  KNX_ST_TUNNELING_ACK     = 0x0421,
+  KNX_ST_ROUTING_INDICATION   = 0x0530,
+  KNX_ST_ROUTING_LOST_MESSAGE = 0x0531,
+  KNX_ST_ROUTING_BUSY         = 0x0532,
+  KNX_ST_REMOTE_DIAGNOSTIC_REQUEST          = 0x0740,
+  KNX_ST_REMOTE_DIAGNOSTIC_RESPONSE         = 0x0741,
+  KNX_ST_REMOTE_BASIC_CONFIGURATION_REQUEST = 0x0742,
+  KNX_ST_REMOTE_RESET_REQUEST               = 0x0743,
+} knx_service_type_t;
+
+typedef enum __knx_command_type {
+  KNX_CT_READ                     = 0x00,
+  KNX_CT_ANSWER                   = 0x01,
+  KNX_CT_WRITE                    = 0x02,
+  KNX_CT_INDIVIDUAL_ADDR_WRITE    = 0x03,
+  KNX_CT_INDIVIDUAL_ADDR_REQUEST  = 0x04,
+  KNX_CT_INDIVIDUAL_ADDR_RESPONSE = 0x05,
+  KNX_CT_ADC_READ                 = 0x06,
+  KNX_CT_ADC_ANSWER               = 0x07,
+  KNX_CT_MEM_READ                 = 0x08,
+  KNX_CT_MEM_ANSWER               = 0x09,
+  KNX_CT_MEM_WRITE                = 0x0A,
+  KNX_CT_MASK_VERSION_READ        = 0x0C,
+  KNX_CT_MASK_VERSION_RESPONSE    = 0x0D,
+  KNX_CT_RESTART                  = 0x0E,
+  KNX_CT_ESCAPE                   = 0x0F,
+} knx_command_type_t;
+
+typedef enum __knx_cemi_msg_type {
+  KNX_MT_L_DATA_REQ = 0x11,
+  KNX_MT_L_DATA_IND = 0x29,
+  KNX_MT_L_DATA_CON = 0x2E,
+} knx_cemi_msg_type_t;
+
+typedef enum __knx_communication_type {
+  KNX_COT_UDP = 0x00,
+  KNX_COT_NDP = 0x01,
+  KNX_COT_UCD = 0x02,
+  KNX_COT_NCD = 0x03,
+} knx_communication_type_t;
+
+/* KNX/IP Packet */
+typedef struct __knx_ip_pkt {
+  uint8_t header_len;
+  uint8_t protocol_version;
+  uint16_t service_type;
+  union {
+    struct {
+      uint8_t first_byte;
+      uint8_t second_byte;
+    } bytes;
+    uint16_t len;
+  } total_len;
+  uint8_t pkt_data[]; // Contains the cEMI message (cemi_msg_t)
+} knx_ip_pkt_t;
+
+/* cEMI Service */
+typedef struct __cemi_service {
+  union {
+    struct {
+      uint8_t confirm:1;
+      uint8_t ack:1;
+      uint8_t priority:2;
+      uint8_t system_broadcast:1;
+      uint8_t repeat:1;
+      uint8_t reserved:1;
+      uint8_t frame_type:1;
+    } bits;
+    uint8_t byte;
+  } control_1;
+  union {
+    struct {
+      uint8_t extended_frame_format:4;
+      uint8_t hop_count:3;
+      uint8_t dest_addr_type:1;
+    } bits;
+    uint8_t byte;
+  } control_2;
+  address_t source;
+  address_t destination;
+  uint8_t data_len;
+  struct {
+    uint8_t apci:2;
+    uint8_t tpci_seq_number:4;
+    uint8_t tpci_comm_type:2;
+  } pci;
+  uint8_t data[];
+} cemi_service_t;
+
+/* cEMI Message */
+typedef struct __cemi_msg {
+  uint8_t message_code;
+  uint8_t additional_info_len;
+  union {
+    /* Changed from a flexible array member to a fixed-size one-element array */
+    cemi_addi_t additional_info[1];
+    cemi_service_t service_information;
+  } data;
+} cemi_msg_t;
+
+/* A received group telegram. data points into the buffer the frame was parsed from. */
+typedef struct __telegram {
+  address_t source;
+  address_t destination;
+  knx_command_type_t ct;
+  bool repeated;        // repeat flag of control field 1: a retransmission of an earlier frame
+  uint8_t data_len;
+  const uint8_t *data;
+} telegram_t;
+
+/* Why knx_frame_parse() accepted or dropped a frame */
+typedef enum __knx_parse_result {
+  KNX_PARSE_OK,
+  KNX_PARSE_TOO_SHORT,          // datagram ends inside the header or cEMI service information
+  KNX_PARSE_BAD_HEADER_LEN,
+  KNX_PARSE_BAD_VERSION,
+  KNX_PARSE_FOREIGN_SERVICE,    // well-formed header, but not a routing indication
+  KNX_PARSE_BAD_TOTAL_LEN,      // total_len disagrees with the datagram size
+  KNX_PARSE_BAD_MESSAGE_CODE,   // not L_Data.ind
+  KNX_PARSE_BAD_ADDITIONAL_INFO,// additional info runs past the end of the frame
+  KNX_PARSE_BAD_DATA_LEN,       // no APCI byte, or data_len runs past the end of the frame
+  KNX_PARSE_NOT_GROUP,          // individually addressed
+  KNX_PARSE_RESULT_COUNT
+} knx_parse_result_t;
+
+typedef struct __knx_parse_stats {
+  uint32_t count[KNX_PARSE_RESULT_COUNT]; // indexed by knx_parse_result_t
+} knx_parse_stats_t;
+
+/*
+ * Validates a KNXnet/IP routing indication carrying a group L_Data.ind and
+ * fills telegram with a view into buf. Everything is checked against len, so
+ * any datagram can be passed in. Frames for other services are rejected
+ * after looking at the first four bytes. If stats is given, the counter for
+ * the result is incremented.
+ */
+knx_parse_result_t knx_frame_parse(const uint8_t *buf, size_t len, telegram_t &telegram, knx_parse_stats_t *stats = nullptr);
+
+/* Routing indication header and cEMI service information in front of the payload */
+#define KNX_FRAME_HEADER_LEN  16
+#define KNX_FRAME_MAX_LEN     (KNX_FRAME_HEADER_LEN + 255)
+
+/*
+ * Encodes a group telegram as a routing indication into out, which needs
+ * room for KNX_FRAME_HEADER_LEN + data_len bytes. data[0] carries the low
+ * six payload bits; its top two bits are replaced by the command type.
+ * The fixed header bytes come from a constant template, so only
+ * addresses, lengths and payload are written per frame. Returns the frame
+ * length, or 0 when data_len is 0.
+ */
+size_t knx_frame_encode(uint8_t *out, address_t source, address_t destination, knx_command_type_t ct, const uint8_t *data, uint8_t data_len);
+
+/* Flow control frames a KNXnet/IP router multicasts when its queues fill up */
+typedef struct __knx_routing_ctrl {
+  knx_service_type_t service; // KNX_ST_ROUTING_BUSY or KNX_ST_ROUTING_LOST_MESSAGE
+  uint8_t device_state;
+  uint16_t wait_ms;           // BUSY: how long every sender has to pause
+  uint16_t control;           // BUSY: 0x0000 addresses all devices
+  uint16_t lost;              // LOST_MESSAGE: telegrams the router dropped
+} knx_routing_ctrl_t;
+
+/*
+ * Parses a ROUTING_BUSY or ROUTING_LOST_MESSAGE frame, with the same bounds
+ * checks as knx_frame_parse(). Returns false for anything else.
+ */
+bool knx_routing_ctrl_parse(const uint8_t *buf, size_t len, knx_routing_ctrl_t &ctrl);
+
+#endif
@@ -0,0 +1,29 @@
+/**
+ * esp-knx-ip library for KNX/IP communication on an ESP32
+ * Fixed-size history of raw telegrams, formatted as text only when read
+ * License: MIT
+ */
+
+#include "esp-knx-ip-history.h"
+#include <stdio.h>
+
+size_t knx_history_format(history_entry_t const &entry, char *buf, size_t cap)
+{
+  char line[HISTORY_LINE_MAX];
+  int n = snprintf(line, sizeof(line), "%lu.%03lu %s %u.%u.%u -> %u/%u/%u CT=0x%x Data:",
+                   (unsigned long)(entry.ms / 1000), (unsigned long)(entry.ms % 1000),
+                   entry.sent ? "Sent" : "Received",
+                   entry.source.pa.area, entry.source.pa.line, entry.source.pa.member,
+                   entry.destination.ga.area, entry.destination.ga.line, entry.destination.ga.member,
+                   entry.ct);
+  for (uint8_t i = 0; i < entry.len; ++i)
+    n += snprintf(line + n, sizeof(line) - n, " %02x", entry.data[i]);
+  if (entry.truncated)
+    n += snprintf(line + n, sizeof(line) - n, " ...");
+  line[n++] = '\n';
+
+  if ((size_t)n > cap)
+    return 0;
+  memcpy(buf, line, n);
+  return n;
+}
@@ -0,0 +1,102 @@
+/**
+ * esp-knx-ip library for KNX/IP communication on an ESP32
+ * Fixed-size history of raw telegrams, formatted as text only when read
+ * License: MIT
+ */
+
+#ifndef ESP_KNX_IP_HISTORY_H
+#define ESP_KNX_IP_HISTORY_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include "esp-knx-ip-frame.h"
+#include "esp-knx-ip-task.h"
+
+#define HISTORY_DATA_LEN   14   // payload bytes kept per telegram
+#define HISTORY_LINE_MAX   128  // longest line knx_history_format() writes, with its newline
+
+typedef struct __history_entry {
+  uint32_t ms;
+  address_t source;
+  address_t destination;
+  uint8_t ct;
+  uint8_t len : 4;       // payload bytes kept, at most HISTORY_DATA_LEN
+  uint8_t truncated : 1; // the telegram carried more than that
+  uint8_t sent : 1;      // sent by this device rather than received
+  uint8_t data[HISTORY_DATA_LEN];
+} history_entry_t;
+
+static_assert(sizeof(history_entry_t) == 24, "history_entry_t should pack into 24 bytes");
+
+/*
+ * "12.345 Received 1.1.5 -> 10/6/5 CT=0x2 Data: 0c 1a\n" into buf. Returns
+ * the length, or 0 if it does not fit in cap.
+ */
+size_t knx_history_format(history_entry_t const &entry, char *buf, size_t cap);
+
+/*
+ * Keeps the last N telegrams in N * 24 bytes. Every telegram gets the next
+ * sequence number; the entries from seq() - size() up to seq() are held,
+ * and older ones are overwritten. push() does no formatting and no
+ * allocation. Readers on another task copy entries out by sequence number,
+ * so a reader that falls behind the writer just finds its entries gone.
+ */
+template <size_t N>
+class KnxHistory
+{
+  public:
+    KnxHistory() : head(0) { knx_lock_init(&lock); }
+
+    void push(uint32_t ms, address_t source, address_t destination, uint8_t ct, const uint8_t *data, uint8_t data_len, bool sent)
+    {
+      knx_lock_take(&lock);
+      history_entry_t &e = entries[head % N];
+      e.ms = ms;
+      e.source = source;
+      e.destination = destination;
+      e.ct = ct;
+      e.len = data_len > HISTORY_DATA_LEN ? HISTORY_DATA_LEN : data_len;
+      e.truncated = data_len > HISTORY_DATA_LEN;
+      e.sent = sent;
+      memcpy(e.data, data, e.len);
+      if (e.len > 0)
+        e.data[0] &= 0x3F; // APCI bits
+      head++;
+      knx_lock_give(&lock);
+    }
+
+    void push(uint32_t ms, telegram_t const &telegram, bool sent)
+    {
+      push(ms, telegram.source, telegram.destination, telegram.ct, telegram.data, telegram.data_len, sent);
+    }
+
+    /* Sequence number of the next telegram */
+    uint32_t seq()
+    {
+      knx_lock_take(&lock);
+      uint32_t s = head;
+      knx_lock_give(&lock);
+      return s;
+    }
+
+    /* Copies out telegram s; false if it has not been pushed yet or was overwritten */
+    bool get(uint32_t s, history_entry_t &entry)
+    {
+      knx_lock_take(&lock);
+      bool held = head - s - 1 < (head < N ? head : N);
+      if (held)
+        entry = entries[s % N];
+      knx_lock_give(&lock);
+      return held;
+    }
+
+    static constexpr size_t capacity() { return N; }
+
+  private:
+    knx_lock_t lock;
+    uint32_t head;
+    history_entry_t entries[N];
+};
+
+#endif
@@ -0,0 +1,122 @@
+/**
+ * esp-knx-ip library for KNX/IP communication on an ESP32
+ * Group address -> callback assignment index used by the receive path
+ * License: MIT
+ */
+
+#include "esp-knx-ip-index.h"
+#include <string.h>
+
+GroupAddressIndex::GroupAddressIndex() : slots(nullptr), chain(nullptr), slot_mask(0), capacity(0), hash_shift(31)
+{
+  memset(bitmap, 0, sizeof(bitmap));
+}
+
+void GroupAddressIndex::init(ga_index_slot_t *slots, uint32_t slot_count, uint16_t *next, uint16_t capacity)
+{
+  this->slots = slots;
+  this->chain = next;
+  this->slot_mask = (uint16_t)(slot_count - 1);
+  this->capacity = capacity;
+  this->hash_shift = 32 - (31 - __builtin_clz((uint32_t)slot_count));
+  clear();
+}
+
+void GroupAddressIndex::clear()
+{
+  memset(bitmap, 0, sizeof(bitmap));
+  for (uint32_t i = 0; i <= slot_mask; ++i)
+    slots[i].head = GA_INDEX_NONE;
+  for (uint16_t i = 0; i < capacity; ++i)
+    chain[i] = GA_INDEX_NONE;
+}
+
+ga_index_slot_t *GroupAddressIndex::__find(uint16_t ga) const
+{
+  for (uint16_t pos = __bucket(ga);; pos = (pos + 1) & slot_mask)
+  {
+    if (slots[pos].head == GA_INDEX_NONE)
+      return nullptr;
+    if (slots[pos].ga == ga)
+      return &slots[pos];
+  }
+}
+
+uint16_t GroupAddressIndex::first(uint16_t ga) const
+{
+  if (!contains(ga))
+    return GA_INDEX_NONE;
+  ga_index_slot_t *slot = __find(ga);
+  return slot ? slot->head : GA_INDEX_NONE;
+}
+
+bool GroupAddressIndex::insert(uint16_t ga, uint16_t id)
+{
+  if (id >= capacity)
+    return false;
+  chain[id] = GA_INDEX_NONE;
+
+  uint16_t pos = __bucket(ga);
+  for (; slots[pos].head != GA_INDEX_NONE; pos = (pos + 1) & slot_mask)
+  {
+    if (slots[pos].ga != ga)
+      continue;
+    uint16_t cur = slots[pos].head;
+    while (chain[cur] != GA_INDEX_NONE)
+      cur = chain[cur];
+    chain[cur] = id;
+    return true;
+  }
+
+  // The table holds at most capacity addresses in at least twice as many slots, so a free one always exists.
+  slots[pos].ga = ga;
+  slots[pos].head = id;
+  bitmap[ga >> 5] |= (1u << (ga & 31));
+  return true;
+}
+
+void GroupAddressIndex::remove(uint16_t ga, uint16_t id)
+{
+  if (!contains(ga))
+    return;
+  ga_index_slot_t *slot = __find(ga);
+  if (slot == nullptr)
+    return;
+
+  if (slot->head == id)
+  {
+    slot->head = chain[id];
+  }
+  else
+  {
+    uint16_t cur = slot->head;
+    while (chain[cur] != GA_INDEX_NONE && chain[cur] != id)
+      cur = chain[cur];
+    if (chain[cur] == id)
+      chain[cur] = chain[id];
+  }
+  chain[id] = GA_INDEX_NONE;
+
+  if (slot->head == GA_INDEX_NONE)
+  {
+    bitmap[ga >> 5] &= ~(1u << (ga & 31));
+    __erase_slot((uint16_t)(slot - slots));
+  }
+}
+
+/* Backward-shift deletion keeps linear probe sequences intact without tombstones. */
+void GroupAddressIndex::__erase_slot(uint16_t pos)
+{
+  uint16_t hole = pos;
+  for (uint16_t cur = (pos + 1) & slot_mask; slots[cur].head != GA_INDEX_NONE; cur = (cur + 1) & slot_mask)
+  {
+    uint16_t home = __bucket(slots[cur].ga);
+    // Move the entry into the hole unless its home bucket lies cyclically in (hole, cur].
+    bool stays = (hole <= cur) ? (home > hole && home <= cur) : (home > hole || home <= cur);
+    if (stays)
+      continue;
+    slots[hole] = slots[cur];
+    hole = cur;
+  }
+  slots[hole].head = GA_INDEX_NONE;
+}
@@ -0,0 +1,66 @@
+/**
+ * esp-knx-ip library for KNX/IP communication on an ESP32
+ * Group address -> callback assignment index used by the receive path
+ * License: MIT
+ */
+
+#ifndef ESP_KNX_IP_INDEX_H
+#define ESP_KNX_IP_INDEX_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define GA_INDEX_NONE 0xFFFF
+
+typedef struct __ga_index_slot {
+  uint16_t ga;
+  uint16_t head; // first assignment id for ga, GA_INDEX_NONE if the slot is free
+} ga_index_slot_t;
+
+/* Number of hash slots to provide for a given number of assignments: a power of two at least twice as large. */
+constexpr size_t ga_index_slots_for(size_t assignments)
+{
+  return assignments < 2 ? 4 : ((size_t)1 << (sizeof(unsigned long long) * 8 - __builtin_clzll((unsigned long long)(assignments * 2 - 1))));
+}
+
+/*
+ * Constant-time lookup of all assignments for a group address.
+ *
+ * A 64K-bit presence bitmap rejects unassigned addresses with a single load.
+ * Assigned addresses live in an open-addressed (linear probing) table that
+ * maps the address to the first assignment id; further assignments for the
+ * same address are chained through a next[] array indexed by assignment id,
+ * in the order they were inserted.
+ *
+ * Storage for the table and the chain is provided by the caller.
+ */
+class GroupAddressIndex
+{
+  public:
+    GroupAddressIndex();
+
+    /* slot_count must be a power of two no larger than 65536, see ga_index_slots_for(). */
+    void init(ga_index_slot_t *slots, uint32_t slot_count, uint16_t *next, uint16_t capacity);
+    void clear();
+
+    bool insert(uint16_t ga, uint16_t id);
+    void remove(uint16_t ga, uint16_t id);
+
+    bool contains(uint16_t ga) const { return (bitmap[ga >> 5] >> (ga & 31)) & 1; }
+    uint16_t first(uint16_t ga) const;
+    uint16_t next(uint16_t id) const { return chain[id]; }
+
+  private:
+    uint16_t __bucket(uint16_t ga) const { return (uint16_t)(((uint32_t)ga * 0x9E3779B1u) >> hash_shift); }
+    ga_index_slot_t *__find(uint16_t ga) const;
+    void __erase_slot(uint16_t pos);
+
+    uint32_t bitmap[65536 / 32];
+    ga_index_slot_t *slots;
+    uint16_t *chain;
+    uint16_t slot_mask;
+    uint16_t capacity;
+    uint8_t hash_shift;
+};
+
+#endif
@@ -0,0 +1,401 @@
+/**
+ * esp-knx-ip library for KNX/IP communication on an ESP32
+ * Minimal JSON writer into a fixed buffer and in-place pull reader
+ * License: MIT
+ */
+
+#include "esp-knx-ip-json.h"
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+void KnxJsonWriter::raw(const char *s, size_t n)
+{
+  if (skip > 0)
+  {
+    size_t drop = n < skip ? n : skip;
+    skip -= drop;
+    s += drop;
+    n -= drop;
+  }
+  if (n > cap - len)
+  {
+    n = cap - len;
+    lost = true;
+  }
+  memcpy(buf + len, s, n);
+  len += n;
+}
+
+void KnxJsonWriter::raw(const char *s)
+{
+  raw(s, strlen(s));
+}
+
+void KnxJsonWriter::str(const char *s, size_t n)
+{
+  if (n == (size_t)-1)
+    n = strlen(s);
+  raw('"');
+  size_t run = 0; // characters that need no escaping are copied in one go
+  for (size_t i = 0; i < n; ++i)
+  {
+    uint8_t c = (uint8_t)s[i];
+    if (c >= 0x20 && c != '"' && c != '\\')
+      continue;
+    raw(s + run, i - run);
+    run = i + 1;
+    char esc[7];
+    switch (c)
+    {
+      case '"':  raw("\\\"", 2); break;
+      case '\\': raw("\\\\", 2); break;
+      case '\n': raw("\\n", 2); break;
+      case '\r': raw("\\r", 2); break;
+      case '\t': raw("\\t", 2); break;
+      default:
+        snprintf(esc, sizeof(esc), "\\u%04x", c);
+        raw(esc, 6);
+        break;
+    }
+  }
+  raw(s + run, n - run);
+  raw('"');
+}
+
+void KnxJsonWriter::num(int32_t v)
+{
+  char tmp[12];
+  raw(tmp, snprintf(tmp, sizeof(tmp), "%ld", (long)v));
+}
+
+void KnxJsonWriter::num(float v, uint8_t precision)
+{
+  if (isnan(v) || isinf(v))
+  {
+    raw("null", 4);
+    return;
+  }
+  char tmp[48];
+  int n = snprintf(tmp, sizeof(tmp), "%.*f", (int)precision, (double)v);
+  raw(tmp, n < (int)sizeof(tmp) ? n : sizeof(tmp) - 1);
+}
+
+void KnxJsonWriter::ga(address_t a)
+{
+  char tmp[16];
+  raw(tmp, snprintf(tmp, sizeof(tmp), "\"%u/%u/%u\"", a.ga.area, a.ga.line, a.ga.member));
+}
+
+void KnxJsonWriter::pa(address_t a)
+{
+  char tmp[16];
+  raw(tmp, snprintf(tmp, sizeof(tmp), "\"%u.%u.%u\"", a.pa.area, a.pa.line, a.pa.member));
+}
+
+void KnxJsonReader::__ws()
+{
+  while (p < end && (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r'))
+    p++;
+}
+
+bool KnxJsonReader::__open(char c)
+{
+  if (failed)
+    return false;
+  __ws();
+  if (p >= end || *p != c || depth >= JSON_MAX_DEPTH)
+    return __fail();
+  p++;
+  first[depth++] = true;
+  return true;
+}
+
+bool KnxJsonReader::__next(char close)
+{
+  if (failed || depth == 0)
+    return __fail();
+  __ws();
+  if (p < end && *p == close)
+  {
+    p++;
+    depth--;
+    return false;
+  }
+  if (first[depth - 1])
+  {
+    first[depth - 1] = false;
+    return true;
+  }
+  if (p >= end || *p != ',')
+    return __fail();
+  p++;
+  return true;
+}
+
+bool KnxJsonReader::next_member(const char *&key)
+{
+  if (!__next('}'))
+    return false;
+  size_t n;
+  if (!read_string(key, n))
+    return false;
+  __ws();
+  if (p >= end || *p != ':')
+    return __fail();
+  p++;
+  return true;
+}
+
+bool KnxJsonReader::next_element()
+{
+  return __next(']');
+}
+
+static int __hex(char c)
+{
+  if (c >= '0' && c <= '9') return c - '0';
+  if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+  if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+  return -1;
+}
+
+static bool __hex4(const char *s, const char *end, uint32_t &v)
+{
+  if (end - s < 4)
+    return false;
+  v = 0;
+  for (int i = 0; i < 4; ++i)
+  {
+    int h = __hex(s[i]);
+    if (h < 0)
+      return false;
+    v = (v << 4) | h;
+  }
+  return true;
+}
+
+bool KnxJsonReader::read_string(const char *&s, size_t &n)
+{
+  if (failed)
+    return false;
+  __ws();
+  if (p >= end || *p != '"')
+    return __fail();
+  char *src = p + 1;
+  char *dst = src;
+  s = dst;
+  for (;;)
+  {
+    if (src >= end)
+      return __fail();
+    char c = *src++;
+    if (c == '"')
+      break;
+    if ((uint8_t)c < 0x20)
+      return __fail();
+    if (c != '\\')
+    {
+      *dst++ = c;
+      continue;
+    }
+    if (src >= end)
+      return __fail();
+    c = *src++;
+    switch (c)
+    {
+      case '"': case '\\': case '/': *dst++ = c; break;
+      case 'b': *dst++ = '\b'; break;
+      case 'f': *dst++ = '\f'; break;
+      case 'n': *dst++ = '\n'; break;
+      case 'r': *dst++ = '\r'; break;
+      case 't': *dst++ = '\t'; break;
+      case 'u':
+      {
+        // Decoded to UTF-8, which is never longer than the escape it replaces
+        uint32_t cp;
+        if (!__hex4(src, end, cp))
+          return __fail();
+        src += 4;
+        if (cp >= 0xD800 && cp < 0xDC00)
+        {
+          uint32_t lo;
+          if (end - src < 6 || src[0] != '\\' || src[1] != 'u' || !__hex4(src + 2, end, lo) || lo < 0xDC00 || lo > 0xDFFF)
+            return __fail();
+          src += 6;
+          cp = 0x10000 + ((cp - 0xD800) << 10) + (lo - 0xDC00);
+        }
+        else if (cp >= 0xDC00 && cp < 0xE000)
+          return __fail();
+        if (cp < 0x80)
+          *dst++ = (char)cp;
+        else if (cp < 0x800)
+        {
+          *dst++ = (char)(0xC0 | (cp >> 6));
+          *dst++ = (char)(0x80 | (cp & 0x3F));
+        }
+        else if (cp < 0x10000)
+        {
+          *dst++ = (char)(0xE0 | (cp >> 12));
+          *dst++ = (char)(0x80 | ((cp >> 6) & 0x3F));
+          *dst++ = (char)(0x80 | (cp & 0x3F));
+        }
+        else
+        {
+          *dst++ = (char)(0xF0 | (cp >> 18));
+          *dst++ = (char)(0x80 | ((cp >> 12) & 0x3F));
+          *dst++ = (char)(0x80 | ((cp >> 6) & 0x3F));
+          *dst++ = (char)(0x80 | (cp & 0x3F));
+        }
+        break;
+      }
+      default:
+        return __fail();
+    }
+  }
+  n = dst - s;
+  *dst = '\0'; // at or before the closing quote, which has been consumed
+  p = src;
+  return true;
+}
+
+bool KnxJsonReader::read_int(int32_t &v)
+{
+  if (failed)
+    return false;
+  __ws();
+  bool neg = p < end && *p == '-';
+  if (neg)
+    p++;
+  if (p >= end || *p < '0' || *p > '9')
+    return __fail();
+  int64_t acc = 0;
+  while (p < end && *p >= '0' && *p <= '9')
+  {
+    acc = acc * 10 + (*p++ - '0');
+    if (acc > 0x80000000LL)
+      return __fail();
+  }
+  if (p < end && (*p == '.' || *p == 'e' || *p == 'E'))
+    return __fail();
+  if (neg)
+    acc = -acc;
+  if (acc > INT32_MAX)
+    return __fail();
+  v = (int32_t)acc;
+  return true;
+}
+
+bool KnxJsonReader::read_bool(bool &v)
+{
+  if (failed)
+    return false;
+  __ws();
+  if (end - p >= 4 && memcmp(p, "true", 4) == 0)
+  {
+    p += 4;
+    v = true;
+    return true;
+  }
+  if (end - p >= 5 && memcmp(p, "false", 5) == 0)
+  {
+    p += 5;
+    v = false;
+    return true;
+  }
+  return __fail();
+}
+
+bool KnxJsonReader::skip_value()
+{
+  if (failed)
+    return false;
+  __ws();
+  if (p >= end)
+    return __fail();
+  const char *s;
+  size_t n;
+  bool b;
+  switch (*p)
+  {
+    case '"':
+      return read_string(s, n);
+    case '{':
+      begin_object();
+      while (next_member(s))
+        skip_value();
+      return !failed;
+    case '[':
+      begin_array();
+      while (next_element())
+        skip_value();
+      return !failed;
+    case 't':
+    case 'f':
+      return read_bool(b);
+    case 'n':
+      if (end - p >= 4 && memcmp(p, "null", 4) == 0)
+      {
+        p += 4;
+        return true;
+      }
+      return __fail();
+    default:
+    {
+      const char *start = p;
+      while (p < end && strchr("+-.eE0123456789", *p) != nullptr)
+        p++;
+      return p > start ? true : __fail();
+    }
+  }
+}
+
+bool KnxJsonReader::finish()
+{
+  if (failed || depth != 0)
+    return false;
+  __ws();
+  return p == end;
+}
+
+// Three decimal parts of at most 255 separated by sep
+static bool __parse_triple(const char *s, size_t n, char sep, uint16_t parts[3])
+{
+  const char *end = s + n;
+  for (int i = 0; i < 3; ++i)
+  {
+    if (i > 0)
+    {
+      if (s >= end || *s != sep)
+        return false;
+      s++;
+    }
+    const char *start = s;
+    parts[i] = 0;
+    while (s < end && *s >= '0' && *s <= '9' && s - start < 3)
+      parts[i] = parts[i] * 10 + (*s++ - '0');
+    if (s == start || parts[i] > 255)
+      return false;
+  }
+  return s == end;
+}
+
+bool knx_json_parse_ga(const char *s, size_t n, address_t &a)
+{
+  uint16_t parts[3];
+  if (!__parse_triple(s, n, '/', parts) || parts[0] > 31 || parts[1] > 7)
+    return false;
+  a.bytes.high = (parts[0] << 3) | parts[1];
+  a.bytes.low = parts[2];
+  return true;
+}
+
+bool knx_json_parse_pa(const char *s, size_t n, address_t &a)
+{
+  uint16_t parts[3];
+  if (!__parse_triple(s, n, '.', parts) || parts[0] > 15 || parts[1] > 15)
+    return false;
+  a.bytes.high = (parts[0] << 4) | parts[1];
+  a.bytes.low = parts[2];
+  return true;
+}
@@ -0,0 +1,99 @@
+/**
+ * esp-knx-ip library for KNX/IP communication on an ESP32
+ * Minimal JSON writer into a fixed buffer and in-place pull reader
+ * License: MIT
+ */
+
+#ifndef ESP_KNX_IP_JSON_H
+#define ESP_KNX_IP_JSON_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "esp-knx-ip-frame.h"
+
+#define JSON_MAX_DEPTH 8
+
+/*
+ * Writes JSON text straight into a response buffer. Output that does not
+ * fit is dropped and flagged. The first skip bytes are dropped as well, so
+ * a value too large for one buffer can be produced again for the next one
+ * and continue where the previous one stopped.
+ */
+class KnxJsonWriter
+{
+  public:
+    KnxJsonWriter(uint8_t *buf, size_t cap, size_t skip = 0) : buf(buf), cap(cap), len(0), skip(skip), lost(false) {}
+
+    void raw(const char *s, size_t n);
+    void raw(const char *s);
+    void raw(char c) { raw(&c, 1); }
+    /* Quoted and escaped; n == (size_t)-1 means NUL-terminated */
+    void str(const char *s, size_t n = (size_t)-1);
+    void key(const char *k) { str(k); raw(':'); }
+    void num(int32_t v);
+    void num(float v, uint8_t precision);
+    void boolean(bool v) { raw(v ? "true" : "false"); }
+    /* "area/line/member" for a group address, "area.line.member" for a physical one */
+    void ga(address_t a);
+    void pa(address_t a);
+
+    size_t size() const { return len; }
+    bool overflowed() const { return lost; }
+    /* Drops everything after mark, which must come from size() */
+    void truncate(size_t mark) { len = mark; lost = false; }
+
+  private:
+    uint8_t *buf;
+    size_t cap;
+    size_t len;
+    size_t skip;
+    bool lost;
+};
+
+/*
+ * Pull reader over a mutable buffer. Strings are unescaped in place and
+ * returned as pointers into the buffer. Any syntax error latches error(),
+ * after which every call returns false.
+ */
+class KnxJsonReader
+{
+  public:
+    KnxJsonReader(char *buf, size_t len) : p(buf), end(buf + len), depth(0), failed(false) {}
+
+    bool begin_object() { return __open('{'); }
+    bool begin_array() { return __open('['); }
+    /* Moves to the next member of the current object and reads its key; false at the closing brace */
+    bool next_member(const char *&key);
+    /* Moves to the next element of the current array; false at the closing bracket */
+    bool next_element();
+
+    /* First character of the next value, '\0' at the end of input */
+    char peek() { __ws(); return p < end ? *p : '\0'; }
+
+    bool read_string(const char *&s, size_t &n);
+    bool read_int(int32_t &v);
+    bool read_bool(bool &v);
+    bool skip_value();
+    /* true once the whole input is consumed without error */
+    bool finish();
+
+    bool error() const { return failed; }
+
+  private:
+    bool __open(char c);
+    bool __next(char close);
+    bool __fail() { failed = true; return false; }
+    void __ws();
+
+    char *p;
+    char *end;
+    uint8_t depth;
+    bool first[JSON_MAX_DEPTH];
+    bool failed;
+};
+
+/* Parse "a/b/c" group and "a.b.c" physical addresses; false when malformed or out of range */
+bool knx_json_parse_ga(const char *s, size_t n, address_t &a);
+bool knx_json_parse_pa(const char *s, size_t n, address_t &a);
+
+#endif
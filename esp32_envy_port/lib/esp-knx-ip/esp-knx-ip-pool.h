@@ -0,0 +1,79 @@
+/**
+ * esp-knx-ip library for KNX/IP communication on an ESP32
+ * Fixed-capacity tables that can move into a caller-provided arena at load()
+ * License: MIT
+ */
+
+#ifndef ESP_KNX_IP_POOL_H
+#define ESP_KNX_IP_POOL_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <new>
+#include <utility>
+
+/* Bump allocator over a caller-provided block. Nothing is ever freed, so the block cannot fragment. */
+class KnxArena
+{
+  public:
+    KnxArena(void *base, size_t size) : base((uint8_t *)base), size(size), used(0) {}
+
+    void *take(size_t bytes, size_t align)
+    {
+      size_t start = (((uintptr_t)base + used + align - 1) & ~(uintptr_t)(align - 1)) - (uintptr_t)base;
+      if (start + bytes > size)
+        return nullptr;
+      used = start + bytes;
+      return base + start;
+    }
+
+    /* Worst-case bytes needed to take() count objects of type T */
+    template <typename T>
+    static constexpr size_t bytes_for(size_t count) { return count * sizeof(T) + alignof(T) - 1; }
+
+  private:
+    uint8_t *base;
+    size_t size;
+    size_t used;
+};
+
+/*
+ * A table of T that starts out in INLINE built-in slots, so entries can be
+ * registered before load(), and can later be relocated into arena memory
+ * with a larger capacity. Relocated slots are never handed back.
+ */
+template <typename T, uint16_t INLINE>
+class KnxStore
+{
+  public:
+    KnxStore() : items(inline_items), cap(INLINE), inline_items() {}
+
+    T &operator[](uint16_t i) { return items[i]; }
+    T const &operator[](uint16_t i) const { return items[i]; }
+    T *data() { return items; }
+    uint16_t capacity() const { return cap; }
+
+    /* Moves the first count entries into capacity slots taken from arena. */
+    bool relocate(KnxArena &arena, uint16_t capacity, uint16_t count)
+    {
+      if (capacity < count)
+        return false;
+      T *moved = (T *)arena.take(capacity * sizeof(T), alignof(T));
+      if (moved == nullptr)
+        return false;
+      for (uint16_t i = 0; i < capacity; ++i)
+        new (&moved[i]) T();
+      for (uint16_t i = 0; i < count; ++i)
+        moved[i] = std::move(items[i]);
+      items = moved;
+      cap = capacity;
+      return true;
+    }
+
+  private:
+    T *items;
+    uint16_t cap;
+    T inline_items[INLINE];
+};
+
+#endif
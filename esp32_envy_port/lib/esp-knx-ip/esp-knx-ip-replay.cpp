@@ -0,0 +1,218 @@
+/**
+ * esp-knx-ip library for KNX/IP communication on an ESP32
+ * Replay of a bus capture as a UDP receive source
+ * License: MIT
+ */
+
+#include "esp-knx-ip.h"
+#include <esp_log.h>
+#define DEBUG_TAG "KNXIP"
+
+KnxReplay::KnxReplay() : speed(1.0f), block_len(0), block_pos(0), block_left(0), block_ms(0), block_us(0),
+                         first_block(true), has_record(false), record_us(0), started(false), capture_start_us(0), replay_start_us(0),
+                         last_micros(0), clock_us(0), rx_len(0), rx_pos(0), due_us(0), first_us(0), latency(nullptr)
+{
+  memset(&record, 0, sizeof(record));
+  memset(&counters, 0, sizeof(counters));
+}
+
+KnxReplay::~KnxReplay()
+{
+  delete[] latency;
+}
+
+bool KnxReplay::begin(fs::File file, float speed)
+{
+  if (!file || file.isDirectory())
+    return false;
+  stop();
+  this->file = file;
+  this->speed = speed > 0 ? speed : 0;
+  if (latency == nullptr)
+    latency = new KnxLatencyHistogram[REPLAY_CALLBACKS];
+  first_block = true;
+  block_us = record_us = 0;
+  started = false;
+  last_micros = micros();
+  clock_us = last_micros;
+  return true;
+}
+
+void KnxReplay::clear()
+{
+  memset(&counters, 0, sizeof(counters));
+  if (latency != nullptr)
+    for (uint16_t i = 0; i < REPLAY_CALLBACKS; ++i)
+      latency[i].clear();
+}
+
+void KnxReplay::stop()
+{
+  file.close();
+  rx_len = rx_pos = 0;
+  block_left = 0;
+  has_record = false;
+}
+
+uint64_t KnxReplay::__now_us()
+{
+  uint32_t now = micros();
+  clock_us += (uint32_t)(now - last_micros);
+  last_micros = now;
+  return clock_us;
+}
+
+int KnxReplay::parsePacket()
+{
+  // Like the socket, a frame that was not read yet is not replaced
+  if (rx_pos < rx_len)
+    return 0;
+
+  for (;;)
+  {
+    if (!has_record && !__next_record())
+      return 0;
+
+    uint64_t now = __now_us();
+    if (!started)
+    {
+      started = true;
+      capture_start_us = record_us;
+      replay_start_us = now;
+      if (counters.frames == 0)
+        first_us = (uint32_t)now;
+    }
+    uint64_t due = now;
+    if (speed > 0)
+    {
+      due = replay_start_us + (uint64_t)((record_us - capture_start_us) / speed);
+      if (now < due)
+        return 0;
+    }
+    if (now - due > counters.lag_max_us)
+      counters.lag_max_us = now - due > 0xFFFFFFFF ? 0xFFFFFFFF : (uint32_t)(now - due);
+
+    has_record = false;
+    rx_len = knx_frame_encode(frame, record.source, record.destination, record.ct, record.data, record.data_len);
+    rx_pos = 0;
+    if (rx_len == 0)
+      continue; // no payload, nothing a live frame could carry either
+    due_us = (uint32_t)due;
+    counters.frames++;
+    counters.elapsed_us = (uint32_t)now - first_us;
+    return rx_len;
+  }
+}
+
+int KnxReplay::read(unsigned char *buf, size_t len)
+{
+  int n = available();
+  if ((size_t)n > len)
+    n = (int)len;
+  memcpy(buf, frame + rx_pos, n);
+  rx_pos += n;
+  return n;
+}
+
+void KnxReplay::callback_done(uint16_t id, uint32_t now_us)
+{
+  counters.calls++;
+  if (id < REPLAY_CALLBACKS && latency != nullptr)
+    latency[id].record(now_us - due_us);
+}
+
+bool KnxReplay::__next_block()
+{
+  uint8_t h[CAPTURE_HEADER_LEN];
+  bool skipping = false;
+  for (;;)
+  {
+    size_t pos = file.position();
+    if (file.read(h, sizeof(h)) != sizeof(h))
+      return false;
+    uint16_t len = h[4] | (h[5] << 8);
+    if (h[0] != CAPTURE_MAGIC_0 || h[1] != CAPTURE_MAGIC_1 || h[2] != CAPTURE_VERSION || len > sizeof(block))
+    {
+      // Look for the next header one byte further on
+      if (!skipping)
+        counters.bad_blocks++;
+      skipping = true;
+      file.seek(pos + 1);
+      continue;
+    }
+    if (file.read(block, len) != len)
+      return false;
+
+    uint32_t ms = h[6] | (h[7] << 8) | (h[8] << 16) | ((uint32_t)h[9] << 24);
+    uint32_t us = h[10] | (h[11] << 8) | (h[12] << 16) | ((uint32_t)h[13] << 24);
+    if (first_block)
+    {
+      first_block = false;
+      block_us = us;
+    }
+    else
+    {
+      // micros() wraps after about 71 minutes, so longer gaps come from millis()
+      uint32_t last_ms = block_ms + (uint32_t)((record_us - block_us) / 1000);
+      uint32_t gap_ms = ms - last_ms;
+      block_us = record_us + (gap_ms < 0x7FFFFFFF / 1000 ? (uint32_t)(us - (uint32_t)record_us) : (uint64_t)gap_ms * 1000);
+    }
+    block_ms = ms;
+    record_us = block_us;
+    block_len = len;
+    block_pos = 0;
+    block_left = h[3];
+    return true;
+  }
+}
+
+bool KnxReplay::__next_record()
+{
+  for (;;)
+  {
+    while (block_left == 0)
+    {
+      if (!file || !__next_block())
+      {
+        file.close();
+        return false;
+      }
+    }
+
+    uint32_t delta = 0;
+    uint8_t shift = 0;
+    uint16_t p = block_pos;
+    while (p < block_len && (block[p] & 0x80) && shift < 28)
+    {
+      delta |= (uint32_t)(block[p++] & 0x7F) << shift;
+      shift += 7;
+    }
+    if (p + 7 > block_len)
+    {
+      counters.bad_blocks++;
+      block_left = 0;
+      continue;
+    }
+    delta |= (uint32_t)block[p++] << shift;
+    uint8_t data_len = block[p + 5];
+    if (p + 6 + data_len > block_len)
+    {
+      counters.bad_blocks++;
+      block_left = 0;
+      continue;
+    }
+
+    record_us += delta;
+    record.source.bytes.high = block[p];
+    record.source.bytes.low = block[p + 1];
+    record.destination.bytes.high = block[p + 2];
+    record.destination.bytes.low = block[p + 3];
+    record.ct = (knx_command_type_t)(block[p + 4] & 0x0F);
+    record.data_len = data_len;
+    record.data = block + p + 6;
+    block_pos = p + 6 + data_len;
+    block_left--;
+    has_record = true;
+    return true;
+  }
+}
@@ -0,0 +1,112 @@
+/**
+ * esp-knx-ip library for KNX/IP communication on an ESP32
+ * Replay of a bus capture as a UDP receive source
+ * License: MIT
+ */
+
+#ifndef ESP_KNX_IP_REPLAY_H
+#define ESP_KNX_IP_REPLAY_H
+
+#include <FS.h>
+#include <Udp.h>
+#include "esp-knx-ip-frame.h"
+#include "esp-knx-ip-capture.h"
+#include "esp-knx-ip-txq.h"
+
+typedef struct __replay_stats {
+  uint32_t frames;      // handed to the library
+  uint32_t bad_blocks;  // damaged stretches skipped, up to the next block header
+  uint32_t elapsed_us;  // from the first frame to the last
+  uint32_t lag_max_us;  // furthest a frame was handed out behind its time
+  uint32_t calls;       // callbacks timed
+} replay_stats_t;
+
+/*
+ * Stands in for the socket in ESPKNXIP::replay_set(). Each record of a
+ * capture file (see KnxCapture) is turned back into a routing indication
+ * and handed out by parsePacket() once it is due, so it takes the same
+ * parse, dedup and dispatch path as a frame from the network. The file is
+ * read one block at a time.
+ *
+ * speed 1 keeps the captured timing, 10 plays it ten times faster, and 0
+ * hands out each frame as soon as the previous one was read. A frame's
+ * latency runs from when it was due, or handed out at speed 0, to when a
+ * callback it reached returns. It is kept per callback for the first
+ * REPLAY_CALLBACKS callback ids. Statistics add up over several files
+ * until clear().
+ */
+class KnxReplay : public UDP
+{
+  public:
+    KnxReplay();
+    ~KnxReplay();
+
+    bool begin(fs::File file, float speed = 1.0f);
+    void clear();
+    /* True once every record in the file has been handed out */
+    bool done() const { return !file && rx_pos >= rx_len && !has_record; }
+    replay_stats_t stats() const { return counters; }
+    KnxLatencyHistogram const *callback_latency(uint16_t id) const { return id < REPLAY_CALLBACKS ? &latency[id] : nullptr; }
+
+    /* Called by ESPKNXIP as each callback returns */
+    void callback_done(uint16_t id, uint32_t now_us);
+
+    /* UDP, receive side */
+    uint8_t begin(uint16_t /* port */) override { return 1; }
+    void stop() override;
+    int parsePacket() override;
+    int available() override { return rx_len - rx_pos; }
+    int read() override { return rx_pos < rx_len ? frame[rx_pos++] : -1; }
+    int read(unsigned char *buf, size_t len) override;
+    int read(char *buf, size_t len) override { return read((unsigned char *)buf, len); }
+    int peek() override { return rx_pos < rx_len ? frame[rx_pos] : -1; }
+    void flush() override { rx_pos = rx_len; }
+    IPAddress remoteIP() override { return IPAddress(0, 0, 0, 0); }
+    uint16_t remotePort() override { return 0; }
+
+    /* A replay sends nothing */
+    int beginPacket(IPAddress /* ip */, uint16_t /* port */) override { return 0; }
+    int beginPacket(const char * /* host */, uint16_t /* port */) override { return 0; }
+    int endPacket() override { return 0; }
+    size_t write(uint8_t /* c */) override { return 0; }
+    size_t write(const uint8_t * /* buf */, size_t /* len */) override { return 0; }
+
+  private:
+    bool __next_record();
+    bool __next_block();
+    uint64_t __now_us();
+
+    fs::File file;
+    float speed;
+
+    // Block being read and the record due next, whose payload points into block
+    uint8_t block[CAPTURE_BLOCK_SIZE];
+    uint16_t block_len;
+    uint16_t block_pos;
+    uint8_t block_left;
+    uint32_t block_ms;     // millis() at the block start, for gaps too long for micros()
+    uint64_t block_us;     // capture time of the block start
+    bool first_block;
+    bool has_record;
+    uint64_t record_us;    // capture time of the record
+    telegram_t record;
+
+    // Capture times are mapped onto clock_us, which is micros() without the wrap
+    bool started;
+    uint64_t capture_start_us;
+    uint64_t replay_start_us;
+    uint32_t last_micros;
+    uint64_t clock_us;
+
+    // Frame handed out by parsePacket()
+    uint8_t frame[KNX_FRAME_HEADER_LEN + 255];
+    int rx_len;
+    int rx_pos;
+    uint32_t due_us;
+    uint32_t first_us;
+
+    replay_stats_t counters;
+    KnxLatencyHistogram *latency;
+};
+
+#endif
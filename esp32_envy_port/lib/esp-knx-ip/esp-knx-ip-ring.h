@@ -0,0 +1,96 @@
+/**
+ * esp-knx-ip library for KNX/IP communication on an ESP32
+ * Single-producer/single-consumer ring used between the receive task and loop()
+ * License: MIT
+ */
+
+#ifndef ESP_KNX_IP_RING_H
+#define ESP_KNX_IP_RING_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <atomic>
+#include <new>
+
+/*
+ * Fixed-size lock-free ring for exactly one producer and one consumer thread.
+ * Slots are filled and consumed in place: the producer reserve()s a slot,
+ * writes it and commit()s it; the consumer reads front() and pop()s it.
+ * N must be a power of two.
+ */
+template <typename T, size_t N>
+class SpscRing
+{
+  static_assert(N >= 2 && (N & (N - 1)) == 0, "SpscRing size must be a power of two");
+
+  public:
+    SpscRing() : head(0), tail(0) {}
+
+    /* Producer side. Returns nullptr when the ring is full. */
+    T *reserve()
+    {
+      uint32_t h = head.load(std::memory_order_relaxed);
+      if (h - tail.load(std::memory_order_acquire) >= N)
+        return nullptr;
+      return &slots[h & (N - 1)];
+    }
+
+    void commit()
+    {
+      head.store(head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    /* Consumer side. Returns nullptr when the ring is empty. */
+    T *front()
+    {
+      uint32_t t = tail.load(std::memory_order_relaxed);
+      if (head.load(std::memory_order_acquire) == t)
+        return nullptr;
+      return &slots[t & (N - 1)];
+    }
+
+    void pop()
+    {
+      tail.store(tail.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    /* Either side; a snapshot that may be stale by the time it is used. */
+    uint32_t size() const
+    {
+      return head.load(std::memory_order_acquire) - tail.load(std::memory_order_acquire);
+    }
+
+    static constexpr size_t capacity() { return N; }
+
+    /*
+     * Before C++17 new ignores the cache-line alignment below, so a ring on
+     * the heap comes from here. Returns nullptr when out of memory.
+     */
+    static SpscRing *create()
+    {
+      void *raw = malloc(sizeof(SpscRing) + alignof(SpscRing) + sizeof(void *));
+      if (raw == nullptr)
+        return nullptr;
+      uintptr_t p = ((uintptr_t)raw + sizeof(void *) + alignof(SpscRing) - 1) & ~(uintptr_t)(alignof(SpscRing) - 1);
+      ((void **)p)[-1] = raw;
+      return new ((void *)p) SpscRing();
+    }
+
+    static void destroy(SpscRing *ring)
+    {
+      if (ring == nullptr)
+        return;
+      void *raw = ((void **)ring)[-1];
+      ring->~SpscRing();
+      free(raw);
+    }
+
+  private:
+    // Kept on separate cache lines so the two sides do not false-share on SMP hosts.
+    alignas(64) std::atomic<uint32_t> head;
+    alignas(64) std::atomic<uint32_t> tail;
+    T slots[N];
+};
+
+#endif
@@ -15,180 +15,239 @@
   * Send functions
   */
  
- void ESPKNXIP::send(address_t const &receiver, knx_command_type_t ct, uint8_t data_len, uint8_t *data)
+ void ESPKNXIP::send(address_t const &receiver, knx_command_type_t ct, uint8_t data_len, const uint8_t *data)
  {
    if (receiver.value == 0)
 	 return;
- #if SEND_CHECKSUM
-   uint32_t len = 6 + 2 + 8 + data_len + 1; // knx_pkt + cemi_msg + cemi_service + data + checksum
- #else
-   uint32_t len = 6 + 2 + 8 + data_len; // knx_pkt + cemi_msg + cemi_service + data
- #endif
-   DEBUG_PRINT("Creating packet with len %d", len);
-   uint8_t buf[len];
-   knx_ip_pkt_t *knx_pkt = (knx_ip_pkt_t *)buf;
-   knx_pkt->header_len = 0x06;
-   knx_pkt->protocol_version = 0x10;
-   knx_pkt->service_type = __ntohs(KNX_ST_ROUTING_INDICATION);
-   knx_pkt->total_len.len = __ntohs(len);
-   cemi_msg_t *cemi_msg = (cemi_msg_t *)knx_pkt->pkt_data;
-   cemi_msg->message_code = KNX_MT_L_DATA_IND;
-   cemi_msg->additional_info_len = 0;
-   cemi_service_t *cemi_data = &cemi_msg->data.service_information;
-   cemi_data->control_1.bits.confirm = 0;
-   cemi_data->control_1.bits.ack = 0;
-   cemi_data->control_1.bits.priority = B11;
-   cemi_data->control_1.bits.system_broadcast = 0x01;
-   cemi_data->control_1.bits.repeat = 0x01;
-   cemi_data->control_1.bits.reserved = 0;
-   cemi_data->control_1.bits.frame_type = 0x01;
-   cemi_data->control_2.bits.extended_frame_format = 0x00;
-   cemi_data->control_2.bits.hop_count = 0x06;
-   cemi_data->control_2.bits.dest_addr_type = 0x01;
-   cemi_data->source = physaddr;
-   cemi_data->destination = receiver;
-   cemi_data->data_len = data_len;
-   cemi_data->pci.apci = (ct & 0x0C) >> 2;
-   cemi_data->pci.tpci_seq_number = 0x00;
-   cemi_data->pci.tpci_comm_type = KNX_COT_UDP;
-   memcpy(cemi_data->data, data, data_len);
-   cemi_data->data[0] = (cemi_data->data[0] & 0x3F) | ((ct & 0x03) << 6);
+   // Any task may send: tx_frame, the state cache and the queue are shared
+   knx_lock_take(&udp_lock);
+   uint16_t len = __encode_frame(receiver, ct, data_len, data);
+   if (len > 0)
+   {
+	 __state_sent(receiver, ct, data, data_len);
+	 __send_frame(receiver, ct, tx_frame, len);
+   }
+   knx_lock_give(&udp_lock);
+ }
  
+ uint16_t ESPKNXIP::send_batch(knx_batch_entry_t const *entries, uint16_t count)
+ {
+   uint16_t accepted = 0;
+   // One lock round trip for the whole batch instead of one per telegram
+   knx_lock_take(&udp_lock);
+   for (uint16_t i = 0; i < count; ++i)
+   {
+	 knx_batch_entry_t const &e = entries[i];
+	 if (e.receiver.value == 0)
+	   continue;
+	 uint16_t len = __encode_frame(e.receiver, e.ct, e.data_len, e.data);
+	 if (len == 0)
+	   continue;
+	 __state_sent(e.receiver, e.ct, e.data, e.data_len);
+	 if (__send_frame(e.receiver, e.ct, tx_frame, len))
+	   accepted++;
+   }
+   knx_lock_give(&udp_lock);
+   return accepted;
+ }
+ 
+ // Encodes into tx_frame, which is reused for every telegram. Caller holds udp_lock.
+ uint16_t ESPKNXIP::__encode_frame(address_t const &receiver, knx_command_type_t ct, uint8_t data_len, const uint8_t *data)
+ {
+   uint16_t len = knx_frame_encode(tx_frame, physaddr, receiver, ct, data, data_len);
  #if SEND_CHECKSUM
-   uint8_t cs = buf[0] ^ buf[1];
+   if (len == 0)
+	 return 0;
+   len++;
+   tx_frame[4] = len >> 8;
+   tx_frame[5] = len & 0xFF;
+   uint8_t cs = tx_frame[0] ^ tx_frame[1];
    for (uint32_t i = 2; i < len - 1; ++i)
    {
-	 cs ^= buf[i];
+	 cs ^= tx_frame[i];
    }
-   buf[len - 1] = cs;
+   tx_frame[len - 1] = cs;
  #endif
+   return len;
+ }
+ 
+ // Sends the frame now, or queues it behind those already waiting so frames
+ // stay in order. Caller holds udp_lock.
+ bool ESPKNXIP::__send_frame(address_t const &receiver, knx_command_type_t ct, const uint8_t *buf, uint16_t len)
+ {
+   uint32_t now = micros();
+   if (tx_queue.size() == 0 && __may_transmit(now))
+   {
+	 __transmit(buf, len, now);
+	 return true;
+   }
+ 
+   tx_push_result_t res = tx_queue.push(receiver.value, ct, buf, len, now);
+   if (res == TX_FULL)
+   {
+	 tx_dropped++;
+	 return false;
+   }
+   if (res == TX_COALESCED)
+   {
+	 tx_coalesced++;
+	 KNX_TRACE(TRACE_TX_COALESCED, receiver.value, tx_queue.size());
+   }
+   else
+   {
+	 KNX_TRACE(TRACE_TX_DEFERRED, receiver.value, tx_queue.size());
+   }
+   // A sender on another task may have queued it while loop() sleeps in wait()
+   if (rx_ring != nullptr)
+	 knx_event_signal(&rx_event);
+   return true;
+ }
+ 
+ // Both routing flow control and the rate limit have to let the frame out.
+ // Caller holds udp_lock.
+ bool ESPKNXIP::__may_transmit(uint32_t now_us)
+ {
+   if (tx_interval_us > 0 && (int32_t)(now_us - tx_next_us) < 0)
+	 return false;
+   return flow.may_send(millis());
+ }
  
-   DEBUG_PRINT("Sending packet:");
-   for (int i = 0; i < len; ++i)
+ // Caller holds udp_lock: the receive task shares the socket and WiFiUDP
+ // keeps per-packet state, and loop() looks up the dedup cache under it.
+ void ESPKNXIP::__transmit(const uint8_t *buf, uint16_t len, uint32_t queued_us)
+ {
+   uint32_t now = micros();
+   // Keep the cadence when loop() is a little late, restart it after idling
+   if ((int32_t)(now - (tx_next_us + tx_interval_us)) < 0)
+	 tx_next_us += tx_interval_us;
+   else
+	 tx_next_us = now + tx_interval_us;
+ 
+   telegram_t telegram;
+   if (knx_frame_parse(buf, len, telegram) == KNX_PARSE_OK)
    {
-	 DEBUG_PRINT(" 0x%X", buf[i]);
+	 KNX_TRACE(TRACE_TX, telegram.destination.value, len);
+	 dedup.sent(KnxDedupCache::key(telegram.source.value, telegram.destination.value, telegram.ct, telegram.data, telegram.data_len), millis());
+	 if (stream.active())
+	   stream.push(telegram, STREAM_FLAG_SENT, millis());
    }
-   DEBUG_PRINTLN("");
  
    // ESP32 UDP multicast: use beginPacket() instead of specifying the local IP.
    udp.beginPacket(MULTICAST_IP, MULTICAST_PORT);
    udp.write(buf, len);
    udp.endPacket();
+   tx_sent++;
+   tx_latency.record(now - queued_us);
+ }
+ 
+ void ESPKNXIP::__flush_tx()
+ {
+   if (tx_queue.size() == 0)
+	 return;
+ 
+   knx_lock_take(&udp_lock);
+   tx_queue_t::tx_slot_t *slot;
+   while ((slot = tx_queue.front()) != nullptr && __may_transmit(micros()))
+   {
+	 __transmit(slot->buf, slot->len, slot->queued_us);
+	 tx_queue.pop();
+   }
+   knx_lock_give(&udp_lock);
+ }
+ 
+ void ESPKNXIP::tx_rate_set(uint16_t telegrams_per_second)
+ {
+   tx_interval_us = telegrams_per_second > 0 ? 1000000UL / telegrams_per_second : 0;
+ }
+ 
+ tx_stats_t ESPKNXIP::tx_stats()
+ {
+   tx_stats_t stats;
+   stats.depth = tx_queue.size();
+   stats.high_water = tx_queue.max_size();
+   stats.sent = tx_sent;
+   stats.coalesced = tx_coalesced;
+   stats.dropped = tx_dropped;
+   stats.latency_p50_us = tx_latency.percentile(50);
+   stats.latency_p90_us = tx_latency.percentile(90);
+   stats.latency_p99_us = tx_latency.percentile(99);
+   return stats;
  }
  
  void ESPKNXIP::send_1bit(address_t const &receiver, knx_command_type_t ct, uint8_t bit)
  {
-   uint8_t buf[] = {(uint8_t)(bit & 0b00000001)};
-   send(receiver, ct, 1, buf);
+   send<Dpt<1>>(receiver, ct, bit & 0x01);
  }
  
  void ESPKNXIP::send_2bit(address_t const &receiver, knx_command_type_t ct, uint8_t twobit)
  {
-   uint8_t buf[] = {(uint8_t)(twobit & 0b00000011)};
-   send(receiver, ct, 1, buf);
+   send<Dpt<2>>(receiver, ct, twobit);
  }
  
  void ESPKNXIP::send_4bit(address_t const &receiver, knx_command_type_t ct, uint8_t fourbit)
  {
-   uint8_t buf[] = {(uint8_t)(fourbit & 0b00001111)};
-   send(receiver, ct, 1, buf);
+   send<Dpt<3>>(receiver, ct, fourbit);
  }
  
  void ESPKNXIP::send_1byte_int(address_t const &receiver, knx_command_type_t ct, int8_t val)
  {
-   uint8_t buf[] = {0x00, (uint8_t)val};
-   send(receiver, ct, 2, buf);
+   send<Dpt<6>>(receiver, ct, val);
  }
  
  void ESPKNXIP::send_1byte_uint(address_t const &receiver, knx_command_type_t ct, uint8_t val)
  {
-   uint8_t buf[] = {0x00, val};
-   send(receiver, ct, 2, buf);
+   send<Dpt<5>>(receiver, ct, val);
  }
  
  void ESPKNXIP::send_2byte_int(address_t const &receiver, knx_command_type_t ct, int16_t val)
  {
-   uint8_t buf[] = {0x00, (uint8_t)(val >> 8), (uint8_t)(val & 0x00FF)};
-   send(receiver, ct, 3, buf);
+   send<Dpt<8>>(receiver, ct, val);
  }
  
  void ESPKNXIP::send_2byte_uint(address_t const &receiver, knx_command_type_t ct, uint16_t val)
  {
-   uint8_t buf[] = {0x00, (uint8_t)(val >> 8), (uint8_t)(val & 0x00FF)};
-   send(receiver, ct, 3, buf);
+   send<Dpt<7>>(receiver, ct, val);
  }
  
  void ESPKNXIP::send_2byte_float(address_t const &receiver, knx_command_type_t ct, float val)
  {
-   float v = val * 100.0f;
-   int e = 0;
-   for (; v < -2048.0f; v /= 2)
-   ++e;
-   for (; v > 2047.0f; v /= 2)
-   ++e;
-   long m = (long)round(v) & 0x7FF;
-   short msb = (short) (e << 3 | m >> 8);
-   if (val < 0.0f)
-   msb |= 0x80;
-   uint8_t buf[] = {0x00, (uint8_t)msb, (uint8_t)m};
-   send(receiver, ct, 3, buf);
+   send<Dpt<9>>(receiver, ct, val);
  }
  
  void ESPKNXIP::send_3byte_time(address_t const &receiver, knx_command_type_t ct, uint8_t weekday, uint8_t hours, uint8_t minutes, uint8_t seconds)
  {
-   weekday <<= 5;
-   uint8_t buf[] = {0x00, (uint8_t)(((weekday << 5) & 0xE0) | (hours & 0x1F)), (uint8_t)(minutes & 0x3F), (uint8_t)(seconds & 0x3F)};
-   send(receiver, ct, 4, buf);
+   time_of_day_t time = {(weekday_t)weekday, hours, minutes, seconds};
+   send<Dpt<10>>(receiver, ct, time);
  }
  
  void ESPKNXIP::send_3byte_date(address_t const &receiver, knx_command_type_t ct, uint8_t day, uint8_t month, uint8_t year)
  {
-   uint8_t buf[] = {0x00, (uint8_t)(day & 0x1F), (uint8_t)(month & 0x0F), year};
-   send(receiver, ct, 4, buf);
+   date_t date = {day, month, year};
+   send<Dpt<11>>(receiver, ct, date);
  }
  
  void ESPKNXIP::send_3byte_color(address_t const &receiver, knx_command_type_t ct, uint8_t red, uint8_t green, uint8_t blue)
  {
-   uint8_t buf[] = {0x00, red, green, blue};
-   send(receiver, ct, 4, buf);
+   color_t color = {red, green, blue};
+   send<Dpt<232>>(receiver, ct, color);
  }
  
  void ESPKNXIP::send_4byte_int(address_t const &receiver, knx_command_type_t ct, int32_t val)
  {
-   uint8_t buf[] = {0x00,
-					(uint8_t)((val & 0xFF000000) >> 24),
-					(uint8_t)((val & 0x00FF0000) >> 16),
-					(uint8_t)((val & 0x0000FF00) >> 8),
-					(uint8_t)((val & 0x000000FF) >> 0)};
-   send(receiver, ct, 5, buf);
+   send<Dpt<13>>(receiver, ct, val);
  }
  
  void ESPKNXIP::send_4byte_uint(address_t const &receiver, knx_command_type_t ct, uint32_t val)
  {
-   uint8_t buf[] = {0x00,
-					(uint8_t)((val & 0xFF000000) >> 24),
-					(uint8_t)((val & 0x00FF0000) >> 16),
-					(uint8_t)((val & 0x0000FF00) >> 8),
-					(uint8_t)((val & 0x000000FF) >> 0)};
-   send(receiver, ct, 5, buf);
+   send<Dpt<12>>(receiver, ct, val);
  }
  
  void ESPKNXIP::send_4byte_float(address_t const &receiver, knx_command_type_t ct, float val)
  {
-   uint8_t buf[] = {0x00, ((uint8_t *)&val)[3], ((uint8_t *)&val)[2], ((uint8_t *)&val)[1], ((uint8_t *)&val)[0]};
-   send(receiver, ct, 5, buf);
+   send<Dpt<14>>(receiver, ct, val);
  }
  
  void ESPKNXIP::send_14byte_string(address_t const &receiver, knx_command_type_t ct, const char *val)
  {
-   // DPT16 strings are always 14 bytes long, however the data array is one larger due to the telegram structure.
-   // The first byte needs to be zero, string start after that.
-   uint8_t buf[15] = {0x00};
-   int len = strlen(val);
-   if (len > 14)
-   {
-	 len = 14;
-   }
-   memcpy(buf+1, val, len);
-   send(receiver, ct, 15, buf);
- }
\ No newline at end of file
+   send<Dpt<16>>(receiver, ct, val);
+ }
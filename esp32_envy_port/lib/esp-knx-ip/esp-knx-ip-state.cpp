@@ -0,0 +1,65 @@
+/**
+ * esp-knx-ip library for KNX/IP communication on an ESP32
+ * Last known value per group address, for reading back and answering READ requests
+ * License: MIT
+ */
+
+#include "esp-knx-ip.h"
+
+static_assert((STATE_CACHE_SIZE & (STATE_CACHE_SIZE - 1)) == 0 && STATE_CACHE_SIZE < 32768, "STATE_CACHE_SIZE must be a power of two");
+
+KnxStateCache::KnxStateCache() : count(0)
+{
+  memset(entries, 0, sizeof(entries));
+  for (uint16_t i = 0; i < SLOTS; ++i)
+    slots[i] = EMPTY;
+}
+
+// Slot holding ga, or the empty slot where it would go. The table is never
+// more than half full, so the probe always ends.
+uint16_t KnxStateCache::__slot(uint16_t ga) const
+{
+  uint16_t pos = (uint16_t)(((uint32_t)ga * 0x9E3779B1u) >> 16) & (SLOTS - 1);
+  while (slots[pos] != EMPTY && entries[slots[pos]].ga.value != ga)
+    pos = (pos + 1) & (SLOTS - 1);
+  return pos;
+}
+
+bool KnxStateCache::track(address_t ga, bool owned)
+{
+  uint16_t pos = __slot(ga.value);
+  if (slots[pos] == EMPTY)
+  {
+    if (count >= STATE_CACHE_SIZE)
+      return false;
+    slots[pos] = count;
+    entries[count].ga = ga;
+    count++;
+  }
+  knx_state_t &e = entries[slots[pos]];
+  e.flags = owned ? (e.flags | STATE_FLAG_OWNED) : (e.flags & ~STATE_FLAG_OWNED);
+  return true;
+}
+
+knx_state_t *KnxStateCache::find(uint16_t ga)
+{
+  if (count == 0)
+    return nullptr;
+  uint16_t idx = slots[__slot(ga)];
+  return idx == EMPTY ? nullptr : &entries[idx];
+}
+
+knx_state_t *KnxStateCache::store(address_t ga, address_t source, const uint8_t *data, uint8_t data_len, uint32_t now_ms)
+{
+  knx_state_t *e = find(ga.value);
+  if (e == nullptr || data_len == 0 || data_len > STATE_PAYLOAD_SIZE)
+    return nullptr;
+  e->source = source;
+  e->updated_ms = now_ms;
+  e->data_len = data_len;
+  if (data != e->data) // answering from the cache hands the entry's own buffer to send()
+    memcpy(e->data, data, data_len);
+  e->data[0] &= 0x3F;
+  e->flags |= STATE_FLAG_VALID;
+  return e;
+}
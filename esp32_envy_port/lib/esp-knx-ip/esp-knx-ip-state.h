@@ -0,0 +1,63 @@
+/**
+ * esp-knx-ip library for KNX/IP communication on an ESP32
+ * Last known value per group address, for reading back and answering READ requests
+ * License: MIT
+ */
+
+#ifndef ESP_KNX_IP_STATE_H
+#define ESP_KNX_IP_STATE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "esp-knx-ip-frame.h"
+
+/* Group addresses whose last value is kept, see state_track(). STATE_CACHE_SIZE must be a power of two. */
+#ifndef STATE_CACHE_SIZE
+#define STATE_CACHE_SIZE   32
+#endif
+#define STATE_PAYLOAD_SIZE 15  // longest payload kept, a DPT 16 string with its APCI byte
+
+#define STATE_FLAG_OWNED  0x01 // READ requests are answered from the cache
+#define STATE_FLAG_VALID  0x02 // a value has been seen since tracking started
+
+typedef struct __knx_state {
+  address_t ga;
+  address_t source;     // who sent the value, our physical address for our own writes
+  uint32_t updated_ms;
+  uint8_t flags;
+  uint8_t data_len;
+  uint8_t data[STATE_PAYLOAD_SIZE]; // payload as passed to send(): the APCI bits of data[0] are cleared
+} knx_state_t;
+
+/*
+ * Fixed table of tracked group addresses. Addresses are added once and
+ * never removed; lookups hash the address into an open-addressed table of
+ * twice the size, so a telegram for an untracked address costs one or two
+ * probes.
+ */
+class KnxStateCache
+{
+  public:
+    KnxStateCache();
+
+    /* Adds ga, or updates its owned flag if it is already tracked. false when the table is full. */
+    bool track(address_t ga, bool owned);
+    knx_state_t *find(uint16_t ga);
+    /* Stores the value if ga is tracked; returns the entry or nullptr */
+    knx_state_t *store(address_t ga, address_t source, const uint8_t *data, uint8_t data_len, uint32_t now_ms);
+
+    uint16_t size() const { return count; }
+    knx_state_t const &operator[](uint16_t i) const { return entries[i]; }
+
+  private:
+    static const uint16_t SLOTS = STATE_CACHE_SIZE * 2;
+    static const uint16_t EMPTY = 0xFFFF;
+
+    uint16_t __slot(uint16_t ga) const;
+
+    knx_state_t entries[STATE_CACHE_SIZE];
+    uint16_t slots[SLOTS];
+    uint16_t count;
+};
+
+#endif
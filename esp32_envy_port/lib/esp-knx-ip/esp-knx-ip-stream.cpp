@@ -0,0 +1,127 @@
+/**
+ * esp-knx-ip library for KNX/IP communication on an ESP32
+ * Live telegram stream to browsers over a WebSocket
+ * License: MIT
+ */
+
+#include "esp-knx-ip.h"
+#include <esp_log.h>
+#define DEBUG_TAG "KNXIP"
+
+KnxStream::KnxStream() : ws(nullptr), clients(0), len(STREAM_HEADER_LEN), count(0), seq(0), first_ms(0), cleanup_ms(0)
+{
+  knx_lock_init(&lock);
+  memset(&counters, 0, sizeof(counters));
+}
+
+void KnxStream::begin(AsyncWebServer *server, const char *path)
+{
+  if (ws != nullptr)
+    return;
+  ws = new AsyncWebSocket(path);
+  ws->onEvent([this](AsyncWebSocket *, AsyncWebSocketClient *client, AwsEventType type, void *, uint8_t *, size_t) {
+    __event(client, type);
+  });
+  server->addHandler(ws);
+}
+
+// Runs in the AsyncTCP task, possibly while the web server holds its client
+// list lock, so it does not take lock; __send() holds lock while it waits for
+// the web server's locks.
+void KnxStream::__event(AsyncWebSocketClient *client, AwsEventType type)
+{
+  if (type == WS_EVT_CONNECT)
+  {
+    // A slow browser misses messages rather than being disconnected
+    client->setCloseClientOnQueueFull(false);
+    clients++;
+  }
+  else if (type == WS_EVT_DISCONNECT && clients > 0)
+  {
+    clients--;
+  }
+}
+
+void KnxStream::push(telegram_t const &telegram, uint8_t flags, uint32_t now_ms)
+{
+  knx_lock_take(&lock);
+  uint16_t need = STREAM_RECORD_LEN + telegram.data_len;
+  // A burst larger than the buffer goes out in several messages
+  if (len + need > STREAM_BUFFER_SIZE || count == 0xFF)
+    __send();
+  if (count == 0)
+    first_ms = now_ms;
+  uint8_t *r = buf + len;
+  r[0] = now_ms;
+  r[1] = now_ms >> 8;
+  r[2] = now_ms >> 16;
+  r[3] = now_ms >> 24;
+  r[4] = flags;
+  r[5] = telegram.source.bytes.high;
+  r[6] = telegram.source.bytes.low;
+  r[7] = telegram.destination.bytes.high;
+  r[8] = telegram.destination.bytes.low;
+  r[9] = telegram.ct;
+  r[10] = telegram.data_len;
+  if (telegram.data_len > 0)
+  {
+    memcpy(r + STREAM_RECORD_LEN, telegram.data, telegram.data_len);
+    r[STREAM_RECORD_LEN] &= 0x3F;
+  }
+  len += need;
+  count++;
+  seq++;
+  counters.telegrams++;
+  knx_lock_give(&lock);
+}
+
+void KnxStream::flush(uint32_t now_ms)
+{
+  // Closes the oldest clients over the limit
+  if (ws != nullptr && (uint32_t)(now_ms - cleanup_ms) >= STREAM_CLEANUP_MS)
+  {
+    cleanup_ms = now_ms;
+    ws->cleanupClients(STREAM_MAX_CLIENTS);
+  }
+
+  if (count == 0)
+    return;
+  // Collect bursts into one message unless the buffer is filling up
+  if ((uint32_t)(now_ms - first_ms) < STREAM_FLUSH_MS && len < STREAM_BUFFER_SIZE / 2)
+    return;
+  knx_lock_take(&lock);
+  __send();
+  knx_lock_give(&lock);
+}
+
+// Caller holds lock
+void KnxStream::__send()
+{
+  if (count == 0)
+    return;
+  uint16_t first = seq - count;
+  buf[0] = STREAM_VERSION;
+  buf[1] = count;
+  buf[2] = first;
+  buf[3] = first >> 8;
+  if (clients > 0)
+  {
+    // Copied once and queued to every client under the web server's locks
+    AsyncWebSocket::SendStatus status = ws->binaryAll(buf, len);
+    if (status != AsyncWebSocket::DISCARDED)
+      counters.messages++;
+    if (status != AsyncWebSocket::ENQUEUED)
+      counters.dropped += count;
+  }
+  len = STREAM_HEADER_LEN;
+  count = 0;
+}
+
+stream_stats_t KnxStream::stats()
+{
+  knx_lock_take(&lock);
+  stream_stats_t s = counters;
+  s.clients = clients;
+  knx_lock_give(&lock);
+  return s;
+}
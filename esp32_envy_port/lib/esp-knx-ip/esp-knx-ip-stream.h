@@ -0,0 +1,82 @@
+/**
+ * esp-knx-ip library for KNX/IP communication on an ESP32
+ * Live telegram stream to browsers over a WebSocket
+ * License: MIT
+ */
+
+#ifndef ESP_KNX_IP_STREAM_H
+#define ESP_KNX_IP_STREAM_H
+
+#include <ESPAsyncWebServer.h>
+#include "esp-knx-ip-frame.h"
+#include "esp-knx-ip-task.h"
+
+#define STREAM_VERSION      2
+#define STREAM_HEADER_LEN   4
+#define STREAM_RECORD_LEN   11  // without the payload
+
+#define STREAM_FLAG_SENT    0x01 // sent by us rather than received
+#define STREAM_CLEANUP_MS   1000 // how often clients over STREAM_MAX_CLIENTS are closed
+
+#if STREAM_BUFFER_SIZE < STREAM_HEADER_LEN + STREAM_RECORD_LEN + 255
+#error "STREAM_BUFFER_SIZE must hold a record with the largest payload"
+#endif
+
+typedef struct __stream_stats {
+  uint16_t clients;
+  uint32_t telegrams;  // records written to the buffer
+  uint32_t messages;   // WebSocket messages sent to the clients
+  uint32_t dropped;    // records at least one client missed because its send queue was full
+} stream_stats_t;
+
+/*
+ * Telegrams are appended to one buffer as they pass and sent to every
+ * client as a single binary message every STREAM_FLUSH_MS, or sooner when
+ * the buffer fills up. Each message is
+ *
+ *   version, record count, sequence number of the first record (uint16, LE)
+ *
+ * followed by records of
+ *
+ *   time ms (uint32, LE), flags, source (2), destination (2), ct, length, payload
+ *
+ * with the addresses in bus order and the APCI bits of the first payload
+ * byte cleared. Records are numbered consecutively, so a client sees what
+ * it missed from the gap to the previous message.
+ *
+ * Messages go out through AsyncWebSocket::binaryAll(), which locks the
+ * client list and each client's queue, so the loop task never touches a
+ * client the AsyncTCP task may be freeing. A client that already has
+ * WS_MAX_QUEUED_MESSAGES queued loses the message instead of being closed.
+ * The receive path never waits for a client.
+ */
+class KnxStream
+{
+  public:
+    KnxStream();
+
+    void begin(AsyncWebServer *server, const char *path);
+    /* Cheap check for the hot path; nothing is buffered without clients */
+    bool active() const { return clients > 0; }
+    bool pending() const { return count > 0; }
+    void push(telegram_t const &telegram, uint8_t flags, uint32_t now_ms);
+    void flush(uint32_t now_ms);
+    stream_stats_t stats();
+
+  private:
+    void __event(AsyncWebSocketClient *client, AwsEventType type);
+    void __send();
+
+    AsyncWebSocket *ws;
+    knx_lock_t lock;
+    volatile uint16_t clients; // only written by the AsyncTCP task
+    uint8_t buf[STREAM_BUFFER_SIZE];
+    uint16_t len;
+    uint8_t count;
+    uint16_t seq;      // sequence number of the next record
+    uint32_t first_ms; // when the oldest buffered record was added
+    uint32_t cleanup_ms;
+    stream_stats_t counters;
+};
+
+#endif
@@ -0,0 +1,109 @@
+/**
+ * esp-knx-ip library for KNX/IP communication on an ESP32
+ * Thin task and lock layer: FreeRTOS on the ESP32, std::thread on a host build
+ * License: MIT
+ */
+
+#include "esp-knx-ip-task.h"
+
+#ifdef ESP_PLATFORM
+
+bool knx_task_start(knx_task_t *task, const char *name, knx_task_fn_t fn, void *arg, uint32_t stack_size, uint8_t priority, int8_t core)
+{
+  BaseType_t res = xTaskCreatePinnedToCore(fn, name, stack_size, arg, priority, &task->handle, core < 0 ? tskNO_AFFINITY : core);
+  return res == pdPASS;
+}
+
+void knx_task_sleep_ms(uint32_t ms)
+{
+  vTaskDelay(ms > 0 ? pdMS_TO_TICKS(ms) : 1);
+}
+
+void knx_lock_init(knx_lock_t *lock)
+{
+  lock->handle = xSemaphoreCreateMutex();
+}
+
+void knx_lock_take(knx_lock_t *lock)
+{
+  xSemaphoreTake(lock->handle, portMAX_DELAY);
+}
+
+void knx_lock_give(knx_lock_t *lock)
+{
+  xSemaphoreGive(lock->handle);
+}
+
+void knx_event_init(knx_event_t *event)
+{
+  event->handle = xSemaphoreCreateBinary();
+}
+
+void knx_event_signal(knx_event_t *event)
+{
+  xSemaphoreGive(event->handle);
+}
+
+bool knx_event_wait(knx_event_t *event, uint32_t timeout_ms)
+{
+  return xSemaphoreTake(event->handle, pdMS_TO_TICKS(timeout_ms)) == pdTRUE;
+}
+
+#else
+
+bool knx_task_start(knx_task_t *task, const char *name, knx_task_fn_t fn, void *arg, uint32_t stack_size, uint8_t priority, int8_t core)
+{
+  (void)name;
+  (void)stack_size;
+  (void)priority;
+  (void)core;
+  task->thread = new std::thread(fn, arg);
+  task->thread->detach();
+  return true;
+}
+
+void knx_task_sleep_ms(uint32_t ms)
+{
+  std::this_thread::sleep_for(std::chrono::milliseconds(ms > 0 ? ms : 1));
+}
+
+void knx_lock_init(knx_lock_t *lock)
+{
+  lock->mutex = new std::mutex();
+}
+
+void knx_lock_take(knx_lock_t *lock)
+{
+  lock->mutex->lock();
+}
+
+void knx_lock_give(knx_lock_t *lock)
+{
+  lock->mutex->unlock();
+}
+
+void knx_event_init(knx_event_t *event)
+{
+  event->mutex = new std::mutex();
+  event->cond = new std::condition_variable();
+  event->set = false;
+}
+
+void knx_event_signal(knx_event_t *event)
+{
+  {
+    std::lock_guard<std::mutex> guard(*event->mutex);
+    event->set = true;
+  }
+  event->cond->notify_one();
+}
+
+bool knx_event_wait(knx_event_t *event, uint32_t timeout_ms)
+{
+  std::unique_lock<std::mutex> guard(*event->mutex);
+  bool signalled = event->cond->wait_for(guard, std::chrono::milliseconds(timeout_ms), [event] { return event->set; });
+  event->set = false;
+  return signalled;
+}
+
+#endif
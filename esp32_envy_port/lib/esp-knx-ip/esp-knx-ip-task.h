@@ -0,0 +1,64 @@
+/**
+ * esp-knx-ip library for KNX/IP communication on an ESP32
+ * Thin task and lock layer: FreeRTOS on the ESP32, std::thread on a host build
+ * License: MIT
+ */
+
+#ifndef ESP_KNX_IP_TASK_H
+#define ESP_KNX_IP_TASK_H
+
+#include <stdint.h>
+
+#ifdef ESP_PLATFORM
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/semphr.h>
+#else
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#endif
+
+typedef void (*knx_task_fn_t)(void *arg);
+
+typedef struct __knx_task {
+#ifdef ESP_PLATFORM
+  TaskHandle_t handle;
+#else
+  std::thread *thread;
+#endif
+} knx_task_t;
+
+typedef struct __knx_lock {
+#ifdef ESP_PLATFORM
+  SemaphoreHandle_t handle;
+#else
+  std::mutex *mutex;
+#endif
+} knx_lock_t;
+
+/* Starts fn(arg) in its own task. core < 0 leaves placement to the scheduler; priority and core are ignored on a host. */
+bool knx_task_start(knx_task_t *task, const char *name, knx_task_fn_t fn, void *arg, uint32_t stack_size, uint8_t priority, int8_t core);
+void knx_task_sleep_ms(uint32_t ms);
+
+void knx_lock_init(knx_lock_t *lock);
+void knx_lock_take(knx_lock_t *lock);
+void knx_lock_give(knx_lock_t *lock);
+
+/* Wakes one waiting task. Signals given while nobody waits are kept until the next wait, not counted. */
+typedef struct __knx_event {
+#ifdef ESP_PLATFORM
+  SemaphoreHandle_t handle;
+#else
+  std::mutex *mutex;
+  std::condition_variable *cond;
+  bool set;
+#endif
+} knx_event_t;
+
+void knx_event_init(knx_event_t *event);
+void knx_event_signal(knx_event_t *event);
+/* Returns true if signalled, false after timeout_ms */
+bool knx_event_wait(knx_event_t *event, uint32_t timeout_ms);
+
+#endif
@@ -0,0 +1,69 @@
+/**
+ * esp-knx-ip library for KNX/IP communication on an ESP32
+ * Binary hot-path trace ring
+ * License: MIT
+ */
+
+#include "esp-knx-ip.h"
+
+#if TRACE_ENABLED
+
+#include <atomic>
+
+static_assert((TRACE_RING_SIZE & (TRACE_RING_SIZE - 1)) == 0, "TRACE_RING_SIZE must be a power of two");
+
+static trace_record_t trace_ring[TRACE_RING_SIZE];
+static std::atomic<uint32_t> trace_head(0);
+
+static const char *const trace_event_names[TRACE_EVENT_COUNT] = {
+  "rx",
+  "drop",
+  "accept",
+  "ring_full",
+  "dispatch",
+  "disabled",
+  "tx",
+  "tx_deferred",
+  "tx_coalesced",
+  "busy",
+  "lost",
+  "state_answer",
+};
+
+void knx_trace_record(trace_event_t event, uint16_t ga, uint8_t len)
+{
+  // The receive task and loop() both record, so claim the slot atomically
+  uint32_t i = trace_head.fetch_add(1, std::memory_order_relaxed);
+  trace_record_t &r = trace_ring[i & (TRACE_RING_SIZE - 1)];
+  r.timestamp_us = micros();
+  r.ga = ga;
+  r.event = event;
+  r.len = len;
+}
+
+void knx_trace_dump(Print &out)
+{
+  uint32_t head = trace_head.load(std::memory_order_relaxed);
+  uint32_t count = head < TRACE_RING_SIZE ? head : TRACE_RING_SIZE;
+  out.printf("# %u records, %u total\n", (unsigned)count, (unsigned)head);
+  for (uint32_t i = head - count; i != head; ++i)
+  {
+    trace_record_t r = trace_ring[i & (TRACE_RING_SIZE - 1)];
+    address_t ga;
+    ga.value = r.ga;
+    out.printf("%10u %-9s %2u/%u/%-3u %u\n",
+      (unsigned)r.timestamp_us,
+      r.event < TRACE_EVENT_COUNT ? trace_event_names[r.event] : "?",
+      ga.ga.area, ga.ga.line, ga.ga.member,
+      r.len);
+  }
+}
+
+#else
+
+void knx_trace_dump(Print &out)
+{
+  out.print("# tracing disabled, build with TRACE_ENABLED=1\n");
+}
+
+#endif
@@ -0,0 +1,47 @@
+/**
+ * esp-knx-ip library for KNX/IP communication on an ESP32
+ * Binary hot-path trace ring. KNX_TRACE() compiles to nothing unless TRACE_ENABLED is set.
+ * License: MIT
+ */
+
+#ifndef ESP_KNX_IP_TRACE_H
+#define ESP_KNX_IP_TRACE_H
+
+#include <stdint.h>
+
+typedef enum __trace_event {
+  TRACE_RX_DATAGRAM,   // len: datagram size
+  TRACE_RX_DROP,       // len: knx_parse_result_t
+  TRACE_RX_ACCEPT,     // ga: destination, len: payload length
+  TRACE_RX_RING_FULL,
+  TRACE_DISPATCH,      // ga: destination, len: callback id
+  TRACE_CB_DISABLED,   // ga: destination, len: callback id
+  TRACE_TX,            // ga: destination, len: frame size
+  TRACE_TX_DEFERRED,   // ga: destination, len: frames queued
+  TRACE_TX_COALESCED,  // ga: destination, len: frames queued
+  TRACE_ROUTING_BUSY,  // ga: wait time in ms, len: busy counter
+  TRACE_ROUTING_LOST,  // ga: lost message count
+  TRACE_STATE_ANSWER,  // ga: destination, len: payload length
+  TRACE_EVENT_COUNT
+} trace_event_t;
+
+/* One fixed-size record, formatted only when the ring is dumped */
+typedef struct __trace_record {
+  uint32_t timestamp_us;
+  uint16_t ga;
+  uint8_t event;
+  uint8_t len;
+} trace_record_t;
+
+#if TRACE_ENABLED
+void knx_trace_record(trace_event_t event, uint16_t ga, uint8_t len);
+#define KNX_TRACE(event, ga, len) knx_trace_record(event, ga, len)
+#else
+#define KNX_TRACE(event, ga, len) do {} while (0)
+#endif
+
+class Print;
+/* Writes the ring oldest-first as text, one record per line */
+void knx_trace_dump(Print &out);
+
+#endif
@@ -0,0 +1,48 @@
+/**
+ * esp-knx-ip library for KNX/IP communication on an ESP32
+ * Outbound frame queue with per-destination coalescing, and a latency histogram for it
+ * License: MIT
+ */
+
+#include "esp-knx-ip.h"
+
+static inline uint8_t __bucket(uint32_t us)
+{
+  if (us < 4)
+    return us;
+  uint8_t msb = 31 - __builtin_clz(us);
+  uint32_t b = (msb - 1) * 4 + ((us >> (msb - 2)) & 3);
+  return b < LATENCY_BUCKETS ? b : LATENCY_BUCKETS - 1;
+}
+
+static inline uint32_t __bucket_upper(uint8_t b)
+{
+  if (b < 4)
+    return b;
+  uint8_t shift = b / 4 - 1;
+  return ((uint32_t)(4 + b % 4) << shift) + ((uint32_t)1 << shift) - 1;
+}
+
+void KnxLatencyHistogram::record(uint32_t us)
+{
+  counts[__bucket(us)]++;
+  total++;
+}
+
+uint32_t KnxLatencyHistogram::percentile(uint8_t p) const
+{
+  if (total == 0)
+    return 0;
+  // Rank of the sample, rounded up, at least the first
+  uint64_t rank = ((uint64_t)total * p + 99) / 100;
+  if (rank == 0)
+    rank = 1;
+  uint64_t seen = 0;
+  for (uint8_t b = 0; b < LATENCY_BUCKETS; ++b)
+  {
+    seen += counts[b];
+    if (seen >= rank)
+      return __bucket_upper(b);
+  }
+  return __bucket_upper(LATENCY_BUCKETS - 1);
+}
@@ -0,0 +1,110 @@
+/**
+ * esp-knx-ip library for KNX/IP communication on an ESP32
+ * Outbound frame queue with per-destination coalescing, and a latency histogram for it
+ * License: MIT
+ */
+
+#ifndef ESP_KNX_IP_TXQ_H
+#define ESP_KNX_IP_TXQ_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+typedef enum __tx_push_result {
+  TX_QUEUED,
+  TX_COALESCED, // replaced the frame already pending for the same destination and command
+  TX_FULL,      // no free slot, or the frame is longer than a slot
+} tx_push_result_t;
+
+/*
+ * FIFO of encoded frames, used from loop() and send() only. A frame for a
+ * destination and command type that is already queued replaces the queued
+ * frame in place. It keeps that frame's position and queue time, so a
+ * stream of writes to one group address never starves the others. N must
+ * be a power of two, S is the longest frame a slot holds.
+ */
+template <size_t N, size_t S>
+class KnxTxQueue
+{
+  static_assert(N >= 2 && (N & (N - 1)) == 0, "KnxTxQueue size must be a power of two");
+
+  public:
+    /* A fully encoded frame waiting to go out */
+    typedef struct __tx_slot {
+      uint16_t destination;
+      uint8_t ct;
+      uint8_t len;
+      uint32_t queued_us;
+      uint8_t buf[S];
+    } tx_slot_t;
+
+    KnxTxQueue() : head(0), tail(0), high_water(0) {}
+
+    tx_push_result_t push(uint16_t destination, uint8_t ct, const uint8_t *buf, uint8_t len, uint32_t now_us)
+    {
+      if (len > S)
+        return TX_FULL;
+      for (uint32_t i = head; i != tail; --i)
+      {
+        tx_slot_t &slot = slots[(i - 1) & (N - 1)];
+        if (slot.destination == destination && slot.ct == ct)
+        {
+          slot.len = len;
+          memcpy(slot.buf, buf, len);
+          return TX_COALESCED;
+        }
+      }
+
+      if (head - tail >= N)
+        return TX_FULL;
+      tx_slot_t &slot = slots[head & (N - 1)];
+      slot.destination = destination;
+      slot.ct = ct;
+      slot.len = len;
+      slot.queued_us = now_us;
+      memcpy(slot.buf, buf, len);
+      head++;
+      if (head - tail > high_water)
+        high_water = head - tail;
+      return TX_QUEUED;
+    }
+
+    /* nullptr when empty */
+    tx_slot_t *front() { return head == tail ? nullptr : &slots[tail & (N - 1)]; }
+    void pop() { tail++; }
+
+    uint16_t size() const { return head - tail; }
+    uint16_t max_size() const { return high_water; }
+
+  private:
+    uint32_t head;
+    uint32_t tail;
+    uint16_t high_water;
+    tx_slot_t slots[N];
+};
+
+/*
+ * Log-linear histogram of microsecond latencies: four buckets per power of
+ * two, so any percentile is within 25% of the true value. Values of 2^26 us
+ * (about 67 s) and more share the last bucket.
+ */
+#define LATENCY_BUCKETS 100
+
+class KnxLatencyHistogram
+{
+  public:
+    KnxLatencyHistogram() { clear(); }
+
+    void clear() { memset(counts, 0, sizeof(counts)); total = 0; }
+    void record(uint32_t us);
+    /* Upper bound of the bucket holding the p-th percentile, p in 0..100. 0 when empty. */
+    uint32_t percentile(uint8_t p) const;
+    uint32_t count() const { return total; }
+
+  private:
+    uint32_t counts[LATENCY_BUCKETS];
+    uint32_t total;
+};
+
+#endif
@@ -6,204 +6,378 @@
  */
 
 #include "esp-knx-ip.h"
+#include "esp-knx-ip-assets.h"
 #include <esp_log.h>
+#include <memory>
 #define DEBUG_TAG "KNXIP"
 #define DEBUG_PRINT(fmt, ...) ESP_LOGD(DEBUG_TAG, fmt, ##__VA_ARGS__)
 #define DEBUG_PRINTLN(fmt, ...) ESP_LOGD(DEBUG_TAG, fmt "\n", ##__VA_ARGS__)
 
+/*
+ * The root page is produced one item at a time while AsyncTCP asks for more
+ * data: a form, a table row or a fixed piece of markup. Only the item being
+ * sent is held in RAM, so memory use depends on the largest entry and not
+ * on how many are registered.
+ */
+enum __root_section {
+  ROOT_HEAD,
+  ROOT_PHYS,
+  ROOT_FEEDBACK_HEAD,
+  ROOT_FEEDBACK,
+  ROOT_CALLBACK_HEAD,
+  ROOT_CALLBACK,
+  ROOT_REGISTER_HEAD,
+  ROOT_REGISTER_OPTION,
+  ROOT_REGISTER_TAIL,
+  ROOT_CONFIG_HEAD,
+  ROOT_CONFIG,
+  ROOT_SYSTEM,
+  ROOT_END,
+  ROOT_DONE
+};
+
+struct __root_page {
+  uint8_t section;
+  uint16_t item;      // next entry within the section
+  String buf;         // text of the current item, reused
+  const char *text;   // buf or a constant
+  size_t len;
+  size_t pos;
+};
+
+static const char root_head[] =
+  "<!DOCTYPE html><html><head><meta charset=\"UTF-8\"><meta name=\"viewport\" content=\"width=device-width, initial-scale=1\"><title>KNX</title>"
+  "<link rel=\"stylesheet\" href=\"" ROOT_PREFIX "/knx.css?v=" KNX_ASSET_KNX_CSS_VERSION "\">"
+  "</head><body>"
+  "<h1>KNX</h1>"
+  "<div style=\"padding:1em\">"
+  "<p><a href=\"" ROOT_PREFIX "/live.html\">Live telegrams</a></p>";
+
+static const char root_system[] =
+#if !(DISABLE_EEPROM_BUTTONS && DISABLE_RESTORE_BUTTON && DISABLE_REBOOT_BUTTON)
+  "<h2>System</h2>"
+  "<div>"
+#if !DISABLE_EEPROM_BUTTONS
+  // Save to EEPROM
+  "<form action=\"" __EEPROM_PATH "\" method=\"POST\" style=\"display:inline-block;margin-right:10px;\">"
+  "<input type=\"hidden\" name=\"mode\" value=\"1\">"
+  "<button type=\"submit\">Save to Storage</button>"
+  "</form>"
+  // Restore from EEPROM
+  "<form action=\"" __EEPROM_PATH "\" method=\"POST\" style=\"display:inline-block;margin-right:10px;\">"
+  "<input type=\"hidden\" name=\"mode\" value=\"2\">"
+  "<button type=\"submit\">Restore from Storage</button>"
+  "</form>"
+#endif
+#if !DISABLE_RESTORE_BUTTON
+  // Load Defaults
+  "<form action=\"" __RESTORE_PATH "\" method=\"POST\" style=\"display:inline-block;margin-right:10px;\">"
+  "<button type=\"submit\">Restore defaults</button>"
+  "</form>"
+#endif
+#if !DISABLE_REBOOT_BUTTON
+  // Reboot
+  "<form action=\"" __REBOOT_PATH "\" method=\"POST\" style=\"display:inline-block;\">"
+  "<button type=\"submit\">Reboot</button>"
+  "</form>"
+#endif
+  "</div>"
+#endif
+  "";
+
+static const char root_register_head[] =
+  "<form action=\"" __REGISTER_PATH "\" method=\"POST\">"
+  "<div>"
+  "<input type=\"number\" name=\"area\" min=\"0\" max=\"31\" placeholder=\"Area\">/"
+  "<input type=\"number\" name=\"line\" min=\"0\" max=\"7\" placeholder=\"Line\">/"
+  "<input type=\"number\" name=\"member\" min=\"0\" max=\"255\" placeholder=\"Member\"> -> "
+  "<select name=\"cb\">";
+
+static const char root_register_tail[] =
+  "</select>"
+  "<button type=\"submit\">Set</button>"
+  "</div>"
+  "</form>";
+
+static void __root_const(__root_page &page, const char *text, size_t len)
+{
+  page.text = text;
+  page.len = len;
+  page.pos = 0;
+}
+
+void knx_asset_send(AsyncWebServerRequest *request, const knx_asset_t &asset)
+{
+  const AsyncWebHeader *match = request->getHeader("If-None-Match");
+  AsyncWebServerResponse *response;
+  if (match != nullptr && match->value() == asset.etag)
+    response = request->beginResponse(304);
+  else
+  {
+    response = request->beginResponse_P(200, asset.mime, asset.data, asset.len);
+    response->addHeader("Content-Encoding", "gzip");
+  }
+  response->addHeader("ETag", asset.etag);
+  response->addHeader("Cache-Control", asset.cache_control);
+  request->send(response);
+}
+
+void ESPKNXIP::__register_assets()
+{
+  for (size_t i = 0; i < KNX_ASSET_COUNT; ++i)
+  {
+    const knx_asset_t *asset = &knx_assets[i];
+    server->on(asset->path, HTTP_GET, [asset](AsyncWebServerRequest *request) {
+      knx_asset_send(request, *asset);
+    });
+  }
+}
+
 void ESPKNXIP::__handle_root(AsyncWebServerRequest *request)
 {
-  String response = "";
-  response += "<!DOCTYPE html><html><head><meta charset=\"UTF-8\"><meta name=\"viewport\" content=\"width=device-width, initial-scale=1\"><title>KNX</title>";
-  response += "<style>body{font-family:Arial;margin:0}h1{margin:0;background-color:#3db9e9;color:white;padding:1em}h2{margin-top:0.5em;margin-bottom:0.5em}form{margin-bottom:1em}label{margin-right:0.5em}input[type=text]{margin-right:0.5em}input[type=submit]{background-color:#3db9e9;color:white;border:0;padding:0.5em;cursor:pointer}table{border-collapse:collapse}td,th{border:1px solid #ddd;padding:8px}tr:nth-child(even){background-color:#f2f2f2}tr:hover{background-color:#ddd}th{padding-top:12px;padding-bottom:12px;text-align:left;background-color:#3db9e9;color:white}</style>";
-  response += "</head><body>";
-  response += "<h1>KNX</h1>";
-  response += "<div style=\"padding:1em\">";
-  response += "<h2>Physical Address</h2>";
-  response += "<form method=\"post\" action=\"" __PHYS_PATH "\">";
-  response += "<input type=\"text\" name=\"area\" value=\"" + String(physaddr.pa.area) + "\" size=\"3\">.";
-  response += "<input type=\"text\" name=\"line\" value=\"" + String(physaddr.pa.line) + "\" size=\"3\">.";
-  response += "<input type=\"text\" name=\"member\" value=\"" + String(physaddr.pa.member) + "\" size=\"3\">";
-  response += "<input type=\"submit\" value=\"Set\">";
-  response += "</form>";
-
-  // Feedback
-  if (registered_feedbacks > 0)
+  std::shared_ptr<__root_page> page(new __root_page());
+  page->section = ROOT_HEAD;
+  page->item = 0;
+  page->len = page->pos = 0;
+  page->buf.reserve(256);
+
+  AsyncWebServerResponse *response = request->beginChunkedResponse("text/html", [this, page](uint8_t *buffer, size_t max_len, size_t /* index */) -> size_t {
+    size_t written = 0;
+    while (written < max_len)
+    {
+      if (page->pos == page->len && !__root_next(*page))
+        break;
+      size_t n = page->len - page->pos;
+      if (n > max_len - written)
+        n = max_len - written;
+      memcpy(buffer + written, page->text + page->pos, n);
+      page->pos += n;
+      written += n;
+    }
+    return written;
+  });
+  request->send(response);
+}
+
+// Makes the next item current. Returns false once the page is complete.
+bool ESPKNXIP::__root_next(__root_page &page)
+{
+  String &response = page.buf;
+  for (;;)
   {
-    response += "<h2>Feedback</h2>";
-    for (feedback_id_t i = 0; i < registered_feedbacks; ++i)
+    response = "";
+    switch (page.section)
     {
-      if (feedbacks[i].cond && !feedbacks[i].cond())
-      {
-        continue;
-      }
-      response += "<form action=\"" __FEEDBACK_PATH "\" method=\"POST\">";
-      response += "<div>";
-      response += "<span>" + feedbacks[i].name + ": </span>";
-      switch (feedbacks[i].type)
+      case ROOT_HEAD:
+        page.section = ROOT_PHYS;
+        __root_const(page, root_head, sizeof(root_head) - 1);
+        return true;
+
+      case ROOT_PHYS:
+        response += "<h2>Physical Address</h2>";
+        response += "<form method=\"post\" action=\"" __PHYS_PATH "\">";
+        response += "<input type=\"text\" name=\"area\" value=\"" + String(physaddr.pa.area) + "\" size=\"3\">.";
+        response += "<input type=\"text\" name=\"line\" value=\"" + String(physaddr.pa.line) + "\" size=\"3\">.";
+        response += "<input type=\"text\" name=\"member\" value=\"" + String(physaddr.pa.member) + "\" size=\"3\">";
+        response += "<input type=\"submit\" value=\"Set\">";
+        response += "</form>";
+        page.section = ROOT_FEEDBACK_HEAD;
+        break;
+
+      case ROOT_FEEDBACK_HEAD:
+        page.section = ROOT_FEEDBACK;
+        page.item = 0;
+        if (registered_feedbacks > 0)
+          response += "<h2>Feedback</h2>";
+        break;
+
+      case ROOT_FEEDBACK:
       {
-        case FEEDBACK_TYPE_INT:
-          response += "<span>" + String(*(int32_t *)feedbacks[i].data) + "</span>";
-          break;
-        case FEEDBACK_TYPE_FLOAT:
-          response += "<span>" + String(*(float *)feedbacks[i].data, (int)feedbacks[i].options.float_options.precision) + "</span>";
-          break;
-        case FEEDBACK_TYPE_BOOL:
-          response += "<span>" + String((*(bool *)feedbacks[i].data) ? "True" : "False") + "</span>";
+        if (page.item >= registered_feedbacks)
+        {
+          page.section = ROOT_CALLBACK_HEAD;
           break;
-        case FEEDBACK_TYPE_ACTION:
-          response += "<input type=\"hidden\" name=\"id\" value=\"" + String(i) + "\">";
-          response += "<button type=\"submit\">Do this</button>";
+        }
+        feedback_id_t i = page.item++;
+        if (feedbacks[i].cond && !feedbacks[i].cond())
           break;
+        response += "<form action=\"" __FEEDBACK_PATH "\" method=\"POST\">";
+        response += "<div>";
+        response += "<span>" + feedbacks[i].name + ": </span>";
+        switch (feedbacks[i].type)
+        {
+          case FEEDBACK_TYPE_INT:
+            response += "<span>" + String(*(int32_t *)feedbacks[i].data) + "</span>";
+            break;
+          case FEEDBACK_TYPE_FLOAT:
+            response += "<span>" + String(*(float *)feedbacks[i].data, (int)feedbacks[i].options.float_options.precision) + "</span>";
+            break;
+          case FEEDBACK_TYPE_BOOL:
+            response += "<span>" + String((*(bool *)feedbacks[i].data) ? "True" : "False") + "</span>";
+            break;
+          case FEEDBACK_TYPE_ACTION:
+            response += "<input type=\"hidden\" name=\"id\" value=\"" + String(i) + "\">";
+            response += "<button type=\"submit\">Do this</button>";
+            break;
+        }
+        response += "</div>";
+        response += "</form>";
+        break;
       }
-      response += "</div>";
-      response += "</form>";
-    }
-  }
 
-  // Callbacks
-  if (registered_callbacks > 0)
-    response += "<h2>Callbacks</h2>";
+      case ROOT_CALLBACK_HEAD:
+        page.section = ROOT_CALLBACK;
+        page.item = 0;
+        if (registered_callbacks > 0)
+          response += "<h2>Callbacks</h2>";
+        break;
 
-  if (registered_callback_assignments > 0)
-  {
-    for (uint8_t i = 0; i < registered_callback_assignments; ++i)
-    {
-      if (callbacks[callback_assignments[i].callback_id].cond && !callbacks[callback_assignments[i].callback_id].cond())
+      case ROOT_CALLBACK:
       {
-        continue;
+        if (page.item >= registered_callback_assignments)
+        {
+          page.section = ROOT_REGISTER_HEAD;
+          break;
+        }
+        callback_assignment_id_t i = page.item++;
+        if (!__callback_assignment_used(i))
+          break;
+        if (callbacks[callback_assignments[i].callback_id].cond && !callbacks[callback_assignments[i].callback_id].cond())
+          break;
+        address_t &addr = callback_assignments[i].address;
+        response += "<form action=\"" __DELETE_PATH "\" method=\"POST\">";
+        response += "<div>";
+        response += "<span>" + String(addr.ga.area) + "/" + String(addr.ga.line) + "/" + String(addr.ga.member) + " - ";
+        response += callbacks[callback_assignments[i].callback_id].name + "</span>";
+        response += "<input type=\"hidden\" name=\"id\" value=\"" + String(i) + "\">";
+        response += "<button type=\"submit\">Delete</button>";
+        response += "</div>";
+        response += "</form>";
+        break;
       }
-      address_t &addr = callback_assignments[i].address;
-      response += "<form action=\"" __DELETE_PATH "\" method=\"POST\">";
-      response += "<div>";
-      response += "<span>" + String(addr.ga.area) + "/" + String(addr.ga.line) + "/" + String(addr.ga.member) + " - ";
-      response += callbacks[callback_assignments[i].callback_id].name + "</span>";
-      response += "<input type=\"hidden\" name=\"id\" value=\"" + String(i) + "\">";
-      response += "<button type=\"submit\">Delete</button>";
-      response += "</div>";
-      response += "</form>";
-    }
-  }
 
-  if (registered_callbacks > 0)
-  {
-    response += "<form action=\"" __REGISTER_PATH "\" method=\"POST\">";
-    response += "<div>";
-    response += "<input type=\"number\" name=\"area\" min=\"0\" max=\"31\" placeholder=\"Area\">/";
-    response += "<input type=\"number\" name=\"line\" min=\"0\" max=\"7\" placeholder=\"Line\">/";
-    response += "<input type=\"number\" name=\"member\" min=\"0\" max=\"255\" placeholder=\"Member\"> -> ";
-    response += "<select name=\"cb\">";
-    for (callback_id_t i = 0; i < registered_callbacks; ++i)
-    {
-      if (callbacks[i].cond && !callbacks[i].cond())
+      case ROOT_REGISTER_HEAD:
+        page.item = 0;
+        if (registered_callbacks == 0)
+        {
+          page.section = ROOT_CONFIG_HEAD;
+          break;
+        }
+        page.section = ROOT_REGISTER_OPTION;
+        __root_const(page, root_register_head, sizeof(root_register_head) - 1);
+        return true;
+
+      case ROOT_REGISTER_OPTION:
       {
-        continue;
+        if (page.item >= registered_callbacks)
+        {
+          page.section = ROOT_REGISTER_TAIL;
+          break;
+        }
+        callback_id_t i = page.item++;
+        if (callbacks[i].cond && !callbacks[i].cond())
+          break;
+        response += "<option value=\"" + String(i) + "\">" + callbacks[i].name + "</option>";
+        break;
       }
-      response += "<option value=\"" + String(i) + "\">" + callbacks[i].name + "</option>";
-    }
-    response += "</select>";
-    response += "<button type=\"submit\">Set</button>";
-    response += "</div>";
-    response += "</form>";
-  }
 
-  // Configuration
-  if (registered_configs > 0)
-  {
-    response += "<h2>Configuration</h2>";
-    for (config_id_t i = 0; i < registered_configs; ++i)
-    {
-      // Check if this config option has a enable condition and if so check that condition
-      if (custom_configs[i].cond && !custom_configs[i].cond())
-        continue;
+      case ROOT_REGISTER_TAIL:
+        page.section = ROOT_CONFIG_HEAD;
+        __root_const(page, root_register_tail, sizeof(root_register_tail) - 1);
+        return true;
 
-      response += "<form action=\"" __CONFIG_PATH "\" method=\"POST\">";
-      response += "<div>";
-      response += "<span>" + custom_configs[i].name + ": </span>";
+      case ROOT_CONFIG_HEAD:
+        page.section = ROOT_CONFIG;
+        page.item = 0;
+        if (registered_configs > 0)
+          response += "<h2>Configuration</h2>";
+        break;
 
-      switch (custom_configs[i].type)
+      case ROOT_CONFIG:
       {
-        case CONFIG_TYPE_STRING:
-          response += "<input type=\"text\" name=\"value\" value=\"" + config_get_string(i) + "\" maxlength=\"" + String(custom_configs[i].len - 1) + "\">";
-          break;
-        case CONFIG_TYPE_INT:
-          response += "<input type=\"number\" name=\"value\" value=\"" + String(config_get_int(i)) + "\">";
+        if (page.item >= registered_configs)
+        {
+          page.section = ROOT_SYSTEM;
           break;
-        case CONFIG_TYPE_BOOL:
-          response += "<input type=\"checkbox\" name=\"value\"";
-          if (config_get_bool(i))
-            response += " checked";
-          response += ">";
+        }
+        config_id_t i = page.item++;
+        // Check if this config option has a enable condition and if so check that condition
+        if (custom_configs[i].cond && !custom_configs[i].cond())
           break;
-        case CONFIG_TYPE_OPTIONS:
+
+        response += "<form action=\"" __CONFIG_PATH "\" method=\"POST\">";
+        response += "<div>";
+        response += "<span>" + custom_configs[i].name + ": </span>";
+
+        switch (custom_configs[i].type)
         {
-          response += "<select name=\"value\">";
-          option_entry_t *cur = custom_configs[i].data.options;
-          while (cur->name != nullptr)
+          case CONFIG_TYPE_STRING:
+            response += "<input type=\"text\" name=\"value\" value=\"" + config_get_string(i) + "\" maxlength=\"" + String(custom_configs[i].len - 1) + "\">";
+            break;
+          case CONFIG_TYPE_INT:
+            response += "<input type=\"number\" name=\"value\" value=\"" + String(config_get_int(i)) + "\">";
+            break;
+          case CONFIG_TYPE_BOOL:
+            response += "<input type=\"checkbox\" name=\"value\"";
+            if (config_get_bool(i))
+              response += " checked";
+            response += ">";
+            break;
+          case CONFIG_TYPE_OPTIONS:
           {
-            if (config_get_options(i) == cur->value)
-            {
-              response += "<option selected value=\"" + String(cur->value) + "\">";
-            }
-            else
+            response += "<select name=\"value\">";
+            option_entry_t *cur = custom_configs[i].data.options;
+            while (cur->name != nullptr)
             {
-              response += "<option value=\"" + String(cur->value) + "\">";
+              if (config_get_options(i) == cur->value)
+              {
+                response += "<option selected value=\"" + String(cur->value) + "\">";
+              }
+              else
+              {
+                response += "<option value=\"" + String(cur->value) + "\">";
+              }
+              response += String(cur->name);
+              response += "</option>";
+              cur++;
             }
-            response += String(cur->name);
-            response += "</option>";
-            cur++;
+            response += "</select>";
+            break;
           }
-          response += "</select>";
-          break;
+          case CONFIG_TYPE_GA:
+            address_t a = config_get_ga(i);
+            response += "<input type=\"number\" name=\"area\" min=\"0\" max=\"31\" value=\"" + String(a.ga.area) + "\">/";
+            response += "<input type=\"number\" name=\"line\" min=\"0\" max=\"7\" value=\"" + String(a.ga.line) + "\">/";
+            response += "<input type=\"number\" name=\"member\" min=\"0\" max=\"255\" value=\"" + String(a.ga.member) + "\">";
+            break;
         }
-        case CONFIG_TYPE_GA:
-          address_t a = config_get_ga(i);
-          response += "<input type=\"number\" name=\"area\" min=\"0\" max=\"31\" value=\"" + String(a.ga.area) + "\">/";
-          response += "<input type=\"number\" name=\"line\" min=\"0\" max=\"7\" value=\"" + String(a.ga.line) + "\">/";
-          response += "<input type=\"number\" name=\"member\" min=\"0\" max=\"255\" value=\"" + String(a.ga.member) + "\">";
-          break;
+        response += "<input type=\"hidden\" name=\"id\" value=\"" + String(i) + "\">";
+        response += "<button type=\"submit\">Set</button>";
+        response += "</div>";
+        response += "</form>";
+        break;
       }
-      response += "<input type=\"hidden\" name=\"id\" value=\"" + String(i) + "\">";
-      response += "<button type=\"submit\">Set</button>";
-      response += "</div>";
-      response += "</form>";
-    }
-  }
 
-  // Buttons
-#if !(DISABLE_EEPROM_BUTTONS && DISABLE_RESTORE_BUTTON && DISABLE_REBOOT_BUTTON)
-  response += "<h2>System</h2>";
-  response += "<div>";
-  // Save to EEPROM
-#if !DISABLE_EEPROM_BUTTONS
-  response += "<form action=\"" __EEPROM_PATH "\" method=\"POST\" style=\"display:inline-block;margin-right:10px;\">";
-  response += "<input type=\"hidden\" name=\"mode\" value=\"1\">";
-  response += "<button type=\"submit\">Save to Storage</button>";
-  response += "</form>";
-  // Restore from EEPROM
-  response += "<form action=\"" __EEPROM_PATH "\" method=\"POST\" style=\"display:inline-block;margin-right:10px;\">";
-  response += "<input type=\"hidden\" name=\"mode\" value=\"2\">";
-  response += "<button type=\"submit\">Restore from Storage</button>";
-  response += "</form>";
-#endif
-#if !DISABLE_RESTORE_BUTTON
-  // Load Defaults
-  response += "<form action=\"" __RESTORE_PATH "\" method=\"POST\" style=\"display:inline-block;margin-right:10px;\">";
-  response += "<button type=\"submit\">Restore defaults</button>";
-  response += "</form>";
-#endif
-#if !DISABLE_REBOOT_BUTTON
-  // Reboot
-  response += "<form action=\"" __REBOOT_PATH "\" method=\"POST\" style=\"display:inline-block;\">";
-  response += "<button type=\"submit\">Reboot</button>";
-  response += "</form>";
-#endif
-  response += "</div>";
-#endif
+      case ROOT_SYSTEM:
+        page.section = ROOT_END;
+        __root_const(page, root_system, sizeof(root_system) - 1);
+        return true;
 
-  // End of page
-  response += "</div></body></html>";
-  request->send(200, "text/html", response);
+      case ROOT_END:
+        page.section = ROOT_DONE;
+        __root_const(page, "</div></body></html>", 20);
+        return true;
+
+      default:
+        return false;
+    }
+
+    if (response.length() > 0)
+    {
+      __root_const(page, response.c_str(), response.length());
+      return true;
+    }
+  }
 }
 
 void ESPKNXIP::__handle_register(AsyncWebServerRequest *request)
@@ -230,15 +404,15 @@ void ESPKNXIP::__handle_register(AsyncWebServerRequest *request)
     return;
   }
   
-  if (cb >= registered_callbacks)
-  {
-    DEBUG_PRINTLN("Invalid callback id");
-    request->redirect(__ROOT_PATH);
-    return;
-  }
-  
+  // Runs in the AsyncTCP task: the lock keeps the table and index consistent
+  // for dispatch and for a JSON batch being applied
   address_t ga = {.ga={line, area, member}};
-  __callback_register_assignment(ga, cb);
+  knx_lock_take(&cfg_lock);
+  if (cb < registered_callbacks)
+    __callback_register_assignment(ga, cb);
+  else
+    DEBUG_PRINTLN("Invalid callback id");
+  knx_lock_give(&cfg_lock);
   
   request->redirect(__ROOT_PATH);
 }
@@ -256,14 +430,12 @@ void ESPKNXIP::__handle_delete(AsyncWebServerRequest *request)
   
   DEBUG_PRINT("Got args: %d", id);
   
-  if (id >= registered_callback_assignments)
-  {
+  knx_lock_take(&cfg_lock);
+  if (__callback_assignment_used(id))
+    __callback_delete_assignment(id);
+  else
     DEBUG_PRINTLN("ID wrong");
-    request->redirect(__ROOT_PATH);
-    return;
-  }
-  
-  __callback_delete_assignment(id);
+  knx_lock_give(&cfg_lock);
   request->redirect(__ROOT_PATH);
 }
 
@@ -289,8 +461,10 @@ void ESPKNXIP::__handle_set(AsyncWebServerRequest *request)
     return;
   }
   
+  knx_lock_take(&cfg_lock);
   physaddr.bytes.high = (area << 4) | line;
   physaddr.bytes.low = member;
+  knx_lock_give(&cfg_lock);
   
   request->redirect(__ROOT_PATH);
 }
@@ -330,8 +504,10 @@ void ESPKNXIP::__handle_config(AsyncWebServerRequest *request)
         request->redirect(__ROOT_PATH);
         return;
       }
+      knx_lock_take(&cfg_lock);
       __config_set_flags(id, CONFIG_FLAGS_VALUE_SET);
       __config_set_string(id, v);
+      knx_lock_give(&cfg_lock);
       break;
     }
     case CONFIG_TYPE_INT:
@@ -341,14 +517,20 @@ void ESPKNXIP::__handle_config(AsyncWebServerRequest *request)
         request->redirect(__ROOT_PATH);
         return;
       }
+      int32_t val = request->getParam("value", true)->value().toInt();
+      knx_lock_take(&cfg_lock);
       __config_set_flags(id, CONFIG_FLAGS_VALUE_SET);
-      __config_set_int(id, request->getParam("value", true)->value().toInt());
+      __config_set_int(id, val);
+      knx_lock_give(&cfg_lock);
       break;
     }
     case CONFIG_TYPE_BOOL:
     {
+      bool val = request->hasParam("value", true) && request->getParam("value", true)->value().equals("on");
+      knx_lock_take(&cfg_lock);
       __config_set_flags(id, CONFIG_FLAGS_VALUE_SET);
-      __config_set_bool(id, request->hasParam("value", true) && request->getParam("value", true)->value().equals("on"));
+      __config_set_bool(id, val);
+      knx_lock_give(&cfg_lock);
       break;
     }
     case CONFIG_TYPE_OPTIONS:
@@ -360,7 +542,9 @@ void ESPKNXIP::__handle_config(AsyncWebServerRequest *request)
       }
       uint8_t val = (uint8_t)request->getParam("value", true)->value().toInt();
       DEBUG_PRINT("Value: %d", val);
+      knx_lock_take(&cfg_lock);
       config_set_options(id, val);
+      knx_lock_give(&cfg_lock);
       break;
     }
     case CONFIG_TYPE_GA:
@@ -382,8 +566,10 @@ void ESPKNXIP::__handle_config(AsyncWebServerRequest *request)
       address_t tmp;
       tmp.bytes.high = (area << 3) | line;
       tmp.bytes.low = member;
+      knx_lock_take(&cfg_lock);
       __config_set_flags(id, CONFIG_FLAGS_VALUE_SET);
       __config_set_ga(id, tmp);
+      knx_lock_give(&cfg_lock);
       break;
     }
   }
@@ -428,11 +614,38 @@ void ESPKNXIP::__handle_feedback(AsyncWebServerRequest *request)
   request->redirect(__ROOT_PATH);
 }
 
+void ESPKNXIP::__handle_trace(AsyncWebServerRequest *request)
+{
+  AsyncResponseStream *response = request->beginResponseStream("text/plain");
+  knx_trace_dump(*response);
+  request->send(response);
+}
+
+void ESPKNXIP::__handle_capture(AsyncWebServerRequest *request)
+{
+  if (!capture.active())
+  {
+    request->send(404, "text/plain", "Capture not started");
+    return;
+  }
+  // Streamed from flash a chunk at a time, whatever the size of the files
+  std::shared_ptr<capture_cursor_t> cursor(new capture_cursor_t());
+  cursor->segment = 0;
+  cursor->offset = 0;
+  AsyncWebServerResponse *response = request->beginChunkedResponse("application/octet-stream", [this, cursor](uint8_t *buffer, size_t max_len, size_t /* index */) -> size_t {
+    return capture.read(*cursor, buffer, max_len);
+  });
+  response->addHeader("Content-Disposition", "attachment; filename=\"knx-capture.kc\"");
+  request->send(response);
+}
+
 #if !DISABLE_RESTORE_BUTTON
 void ESPKNXIP::__handle_restore(AsyncWebServerRequest *request)
 {
   DEBUG_PRINTLN("Restore called");
+  knx_lock_take(&cfg_lock);
   memcpy(custom_config_data, custom_config_default_data, MAX_CONFIG_SPACE);
+  knx_lock_give(&cfg_lock);
   request->redirect(__ROOT_PATH);
 }
 #endif
@@ -462,6 +675,7 @@ void ESPKNXIP::__handle_eeprom(AsyncWebServerRequest *request)
   
   DEBUG_PRINT("Got args: %d", mode);
   
+  knx_lock_take(&cfg_lock);
   if (mode == 1)
   {
     // save
@@ -469,9 +683,10 @@ void ESPKNXIP::__handle_eeprom(AsyncWebServerRequest *request)
   }
   else if (mode == 2)
   {
-    // restore
+    // restore, which rebuilds the assignment table and its index
     restore_from_preferences();
   }
+  knx_lock_give(&cfg_lock);
   
   request->redirect(__ROOT_PATH);
 }
@@ -16,7 +16,20 @@
 ESPKNXIP knx;
 
 ESPKNXIP::ESPKNXIP() : server(nullptr),
+                     rx_budget_packets(RX_BUDGET_PACKETS),
+                     rx_budget_us(RX_BUDGET_US),
+                     rx_staged_len(0),
+                     rx_udp(&udp),
+                     replay(nullptr),
+                     rx_ring(nullptr),
+                     rx_blocked(false),
+                     tx_interval_us(TX_RATE_LIMIT > 0 ? 1000000UL / TX_RATE_LIMIT : 0),
+                     tx_next_us(0),
+                     tx_sent(0),
+                     tx_coalesced(0),
+                     tx_dropped(0),
                      registered_callback_assignments(0),
+                     callback_assignment_free(CALLBACK_ASSIGNMENT_FREE),
                      registered_callbacks(0),
                      registered_configs(0),
                      registered_feedbacks(0)
@@ -25,11 +38,15 @@ ESPKNXIP::ESPKNXIP() : server(nullptr),
   // Default physical address is 1.1.0
   physaddr.bytes.high = (1 << 4) | 1;
   physaddr.bytes.low = 0;
-  memset(callback_assignments, 0, MAX_CALLBACK_ASSIGNMENTS * sizeof(callback_assignment_t));
-  memset(callbacks, 0, MAX_CALLBACKS * sizeof(callback_t));
   memset(custom_config_data, 0, MAX_CONFIG_SPACE * sizeof(uint8_t));
   memset(custom_config_default_data, 0, MAX_CONFIG_SPACE * sizeof(uint8_t));
-  memset(custom_configs, 0, MAX_CONFIGS * sizeof(config_t));
+  memset(&rx_stats, 0, sizeof(rx_stats));
+  memset(&rx_parse_stats, 0, sizeof(rx_parse_stats));
+  memset(&routing, 0, sizeof(routing));
+  dedup.window_set(DEDUP_WINDOW_MS);
+  knx_lock_init(&cfg_lock);
+  knx_lock_init(&udp_lock);
+  ga_index.init(ga_index_slots, ga_index_slots_for(MAX_CALLBACK_ASSIGNMENTS), ga_index_next, MAX_CALLBACK_ASSIGNMENTS);
 }
 
 void ESPKNXIP::load()
@@ -38,6 +55,45 @@ void ESPKNXIP::load()
   restore_from_preferences();
 }
 
+size_t ESPKNXIP::storage_size(storage_layout_t const &layout)
+{
+  return KnxArena::bytes_for<callback_assignment_t>(layout.callback_assignments) +
+         KnxArena::bytes_for<ga_index_slot_t>(ga_index_slots_for(layout.callback_assignments)) +
+         KnxArena::bytes_for<uint16_t>(layout.callback_assignments) +
+         KnxArena::bytes_for<callback_t>(layout.callbacks) +
+         KnxArena::bytes_for<config_t>(layout.configs) +
+         KnxArena::bytes_for<feedback_t>(layout.feedbacks);
+}
+
+bool ESPKNXIP::load(void *arena, size_t arena_size, storage_layout_t const &layout)
+{
+  if (arena_size < storage_size(layout) ||
+      layout.callback_assignments > 32768 ||
+      layout.callback_assignments < registered_callback_assignments ||
+      layout.callbacks < registered_callbacks ||
+      layout.configs < registered_configs ||
+      layout.feedbacks < registered_feedbacks)
+  {
+    ESP_LOGE(DEBUG_TAG, "Storage arena too small for the requested layout");
+    return false;
+  }
+
+  // Cannot fail past this point, the size check above covers every take()
+  KnxArena a(arena, arena_size);
+  callback_assignments.relocate(a, layout.callback_assignments, registered_callback_assignments);
+  uint32_t index_slots = ga_index_slots_for(layout.callback_assignments);
+  ga_index_slot_t *slots = (ga_index_slot_t *)a.take(index_slots * sizeof(ga_index_slot_t), alignof(ga_index_slot_t));
+  uint16_t *next = (uint16_t *)a.take(layout.callback_assignments * sizeof(uint16_t), alignof(uint16_t));
+  ga_index.init(slots, index_slots, next, layout.callback_assignments);
+  __callback_rebuild_index();
+  callbacks.relocate(a, layout.callbacks, registered_callbacks);
+  custom_configs.relocate(a, layout.configs, registered_configs);
+  feedbacks.relocate(a, layout.feedbacks, registered_feedbacks);
+
+  load();
+  return true;
+}
+
 void ESPKNXIP::start(AsyncWebServer *srv)
 {
   server = srv;
@@ -70,6 +126,13 @@ void ESPKNXIP::__start()
 #endif
       server->on(__CONFIG_PATH, HTTP_POST, std::bind(&ESPKNXIP::__handle_config, this, std::placeholders::_1));
       server->on(__FEEDBACK_PATH, HTTP_POST, std::bind(&ESPKNXIP::__handle_feedback, this, std::placeholders::_1));
+      server->on(__TRACE_PATH, HTTP_GET, std::bind(&ESPKNXIP::__handle_trace, this, std::placeholders::_1));
+      server->on(__CAPTURE_PATH, HTTP_GET, std::bind(&ESPKNXIP::__handle_capture, this, std::placeholders::_1));
+      server->on(__API_PATH, HTTP_GET, std::bind(&ESPKNXIP::__handle_api_get, this, std::placeholders::_1));
+      server->on(__API_PATH, HTTP_POST, std::bind(&ESPKNXIP::__handle_api_post, this, std::placeholders::_1), nullptr,
+                 std::bind(&ESPKNXIP::__handle_api_body, this, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3, std::placeholders::_4, std::placeholders::_5));
+      __register_assets();
+      stream.begin(server, __STREAM_PATH);
 #if !DISABLE_RESTORE_BUTTON
       server->on(__RESTORE_PATH, HTTP_POST, std::bind(&ESPKNXIP::__handle_restore, this, std::placeholders::_1));
 #endif
@@ -98,8 +161,8 @@ void ESPKNXIP::save_to_preferences()
   prefs.begin("KNX", false);
   uint64_t magic = EEPROM_MAGIC;
   prefs.putBytes("magic", &magic, sizeof(magic));
-  prefs.putUChar("reg_cb_assign", registered_callback_assignments);
-  prefs.putBytes("cb_assign", callback_assignments, MAX_CALLBACK_ASSIGNMENTS * sizeof(callback_assignment_t));
+  prefs.putUShort("reg_cb_assign", registered_callback_assignments);
+  prefs.putBytes("cb_assign", callback_assignments.data(), registered_callback_assignments * sizeof(callback_assignment_t));
   prefs.putBytes("physaddr", &physaddr, sizeof(address_t));
   prefs.putBytes("config", custom_config_data, sizeof(custom_config_data));
   prefs.end();
@@ -118,11 +181,19 @@ void ESPKNXIP::restore_from_preferences()
     prefs.end();
     return;
   }
-  registered_callback_assignments = prefs.getUChar("reg_cb_assign", 0);
-  prefs.getBytes("cb_assign", callback_assignments, MAX_CALLBACK_ASSIGNMENTS * sizeof(callback_assignment_t));
+  callback_assignment_id_t count = prefs.getUShort("reg_cb_assign", 0);
+  if (count > callback_assignments.capacity())
+  {
+    DEBUG_PRINTLN("Stored callback assignments do not fit, aborting restore.");
+    prefs.end();
+    return;
+  }
+  registered_callback_assignments = count;
+  prefs.getBytes("cb_assign", callback_assignments.data(), count * sizeof(callback_assignment_t));
   prefs.getBytes("physaddr", &physaddr, sizeof(address_t));
   prefs.getBytes("config", custom_config_data, sizeof(custom_config_data));
   prefs.end();
+  __callback_rebuild_index();
   DEBUG_PRINT("Restored from Preferences");
 }
 
@@ -133,49 +204,59 @@ uint16_t ESPKNXIP::__ntohs(uint16_t n)
 
 callback_assignment_id_t ESPKNXIP::__callback_register_assignment(address_t address, callback_id_t id)
 {
-  if (registered_callback_assignments >= MAX_CALLBACK_ASSIGNMENTS)
-    return -1;
+  callback_assignment_id_t aid;
+  if (callback_assignment_free != CALLBACK_ASSIGNMENT_FREE)
+  {
+    aid = callback_assignment_free;
+    callback_assignment_free = callback_assignments[aid].address.value;
+  }
+  else
+  {
+    if (registered_callback_assignments >= callback_assignments.capacity())
+      return -1;
+    aid = registered_callback_assignments++;
+  }
 
-  callback_assignment_id_t aid = registered_callback_assignments;
   callback_assignments[aid].address = address;
   callback_assignments[aid].callback_id = id;
-  registered_callback_assignments++;
+  ga_index.insert(address.value, aid);
   return aid;
 }
 
 void ESPKNXIP::__callback_delete_assignment(callback_assignment_id_t id)
 {
-  if (id >= registered_callback_assignments)
+  if (!__callback_assignment_used(id))
     return;
 
-  uint32_t dest_offset = 0;
-  uint32_t src_offset = 0;
-  uint32_t len = 0;
-  if (id == 0)
-  {
-    src_offset = 1;
-    len = (registered_callback_assignments - 1);
-  }
-  else if (id == registered_callback_assignments - 1)
-  {
-    // Last element; nothing to move.
-  }
-  else
+  // Ids stay stable: the slot is marked free and pushed onto the free list
+  ga_index.remove(callback_assignments[id].address.value, id);
+  callback_assignments[id].callback_id = CALLBACK_ASSIGNMENT_FREE;
+  callback_assignments[id].address.value = callback_assignment_free;
+  callback_assignment_free = id;
+}
+
+void ESPKNXIP::__callback_rebuild_index()
+{
+  ga_index.clear();
+  callback_assignment_free = CALLBACK_ASSIGNMENT_FREE;
+  for (callback_assignment_id_t i = registered_callback_assignments; i-- > 0;)
   {
-    dest_offset = id;
-    src_offset = dest_offset + 1;
-    len = (registered_callback_assignments - 1 - id);
+    if (callback_assignments[i].callback_id == CALLBACK_ASSIGNMENT_FREE)
+    {
+      callback_assignments[i].address.value = callback_assignment_free;
+      callback_assignment_free = i;
+    }
   }
-  if (len > 0)
+  for (callback_assignment_id_t i = 0; i < registered_callback_assignments; ++i)
   {
-    memmove(callback_assignments + dest_offset, callback_assignments + src_offset, len * sizeof(callback_assignment_t));
+    if (callback_assignments[i].callback_id != CALLBACK_ASSIGNMENT_FREE)
+      ga_index.insert(callback_assignments[i].address.value, i);
   }
-  registered_callback_assignments--;
 }
 
 callback_id_t ESPKNXIP::callback_register(String name, callback_fptr_t cb, void *arg, enable_condition_t cond)
 {
-  if (registered_callbacks >= MAX_CALLBACKS)
+  if (registered_callbacks >= callbacks.capacity())
     return -1;
 
   callback_id_t id = registered_callbacks;
@@ -198,7 +279,7 @@ void ESPKNXIP::callback_assign(callback_id_t id, address_t val)
 
 feedback_id_t ESPKNXIP::feedback_register_int(String name, int32_t *value, enable_condition_t cond)
 {
-  if (registered_feedbacks >= MAX_FEEDBACKS)
+  if (registered_feedbacks >= feedbacks.capacity())
     return -1;
   feedback_id_t id = registered_feedbacks;
   feedbacks[id].type = FEEDBACK_TYPE_INT;
@@ -211,7 +292,7 @@ feedback_id_t ESPKNXIP::feedback_register_int(String name, int32_t *value, enabl
 
 feedback_id_t ESPKNXIP::feedback_register_float(String name, float *value, uint8_t precision, enable_condition_t cond)
 {
-  if (registered_feedbacks >= MAX_FEEDBACKS)
+  if (registered_feedbacks >= feedbacks.capacity())
     return -1;
   feedback_id_t id = registered_feedbacks;
   feedbacks[id].type = FEEDBACK_TYPE_FLOAT;
@@ -225,7 +306,7 @@ feedback_id_t ESPKNXIP::feedback_register_float(String name, float *value, uint8
 
 feedback_id_t ESPKNXIP::feedback_register_bool(String name, bool *value, enable_condition_t cond)
 {
-  if (registered_feedbacks >= MAX_FEEDBACKS)
+  if (registered_feedbacks >= feedbacks.capacity())
     return -1;
   feedback_id_t id = registered_feedbacks;
   feedbacks[id].type = FEEDBACK_TYPE_BOOL;
@@ -238,7 +319,7 @@ feedback_id_t ESPKNXIP::feedback_register_bool(String name, bool *value, enable_
 
 feedback_id_t ESPKNXIP::feedback_register_action(String name, feedback_action_fptr_t value, void *arg, enable_condition_t cond)
 {
-  if (registered_feedbacks >= MAX_FEEDBACKS)
+  if (registered_feedbacks >= feedbacks.capacity())
     return -1;
   feedback_id_t id = registered_feedbacks;
   feedbacks[id].type = FEEDBACK_TYPE_ACTION;
@@ -250,121 +331,357 @@ feedback_id_t ESPKNXIP::feedback_register_action(String name, feedback_action_fp
   return id;
 }
 
-void ESPKNXIP::loop()
+rx_pass_t ESPKNXIP::loop()
 {
-  __loop_knx();
-  
   // No need to call handleClient() for AsyncWebServer as it's asynchronous
   // The AsyncWebServer handles clients automatically
+  __flush_tx();
+  rx_pass_t pass = rx_ring != nullptr ? __loop_ring() : __loop_knx();
+  stream.flush(millis());
+  if (capture.active())
+    capture.flush(millis());
+  return pass;
 }
 
-void ESPKNXIP::__loop_knx()
+void ESPKNXIP::wait(uint32_t max_ms)
 {
-  int read = udp.parsePacket();
-  if (!read)
+  if (rx_ring != nullptr && rx_ring->size() > 0)
     return;
-  DEBUG_PRINTLN("");
-  DEBUG_PRINT("LEN: ");
-  DEBUG_PRINTLN(read);
 
-  uint8_t buf[read];
-  udp.read(buf, read);
+  uint32_t ms = max_ms;
+  if (tx_queue.size() > 0)
+  {
+    // loop() just sent what it could, so the head waits for pacing or flow control
+    int32_t due_us = (int32_t)(tx_next_us - micros());
+    uint32_t due = due_us > 1000 ? ((uint32_t)due_us + 999) / 1000 : 1;
+    if (due < ms)
+      ms = due;
+  }
+  if (stream.pending() && ms > STREAM_FLUSH_MS)
+    ms = STREAM_FLUSH_MS;
+  if (capture.pending() && ms > CAPTURE_FLUSH_MS)
+    ms = CAPTURE_FLUSH_MS;
+  if (ms == 0)
+    return;
+
+  if (rx_ring == nullptr)
+    knx_task_sleep_ms(1);
+  else
+    knx_event_wait(&rx_event, ms);
+}
+
+void ESPKNXIP::wake()
+{
+  if (rx_ring != nullptr)
+    knx_event_signal(&rx_event);
+}
+
+void ESPKNXIP::rx_budget_set(uint16_t packets, uint32_t us)
+{
+  rx_budget_packets = packets > 0 ? packets : 1;
+  rx_budget_us = us;
+}
+
+bool ESPKNXIP::rx_task_start(int8_t core, uint8_t priority)
+{
+  if (rx_ring != nullptr)
+    return true;
+  if (replay != nullptr)
+    return false;
+
+  knx_event_init(&rx_event);
+  rx_ring = SpscRing<rx_slot_t, RX_RING_SIZE>::create();
+  if (rx_ring == nullptr || !knx_task_start(&rx_task, "knx_rx", &ESPKNXIP::__rx_task, this, RX_TASK_STACK_SIZE, priority, core))
+  {
+    ESP_LOGE(DEBUG_TAG, "Could not start receive task");
+    SpscRing<rx_slot_t, RX_RING_SIZE>::destroy(rx_ring);
+    rx_ring = nullptr;
+    return false;
+  }
+  ESP_LOGI(DEBUG_TAG, "Receive task started");
+  return true;
+}
+
+bool ESPKNXIP::replay_set(KnxReplay *replay)
+{
+  if (rx_ring != nullptr)
+    return false;
+  this->replay = replay;
+  rx_udp = replay != nullptr ? (UDP *)replay : (UDP *)&udp;
+  rx_staged_len = 0;
+  return true;
+}
+
+void ESPKNXIP::__rx_task(void *arg)
+{
+  ESPKNXIP *self = (ESPKNXIP *)arg;
+  for (;;)
+  {
+    if (!self->__rx_task_poll())
+      knx_task_sleep_ms(1);
+  }
+}
+
+bool ESPKNXIP::__rx_task_poll()
+{
+  // While loop() is behind, leave datagrams queued in the socket rather than
+  // reading them only to throw them away.
+  rx_slot_t *slot = rx_ring->reserve();
+  if (slot == nullptr)
+  {
+    if (!rx_blocked)
+      KNX_TRACE(TRACE_RX_RING_FULL, 0, 0);
+    rx_blocked = true;
+    return false;
+  }
+
+  knx_lock_take(&udp_lock);
+  int read = udp.parsePacket();
+  // The task polls every millisecond while the ring is full; only a frame
+  // that was actually held up by it is counted, and only once
+  if (rx_blocked && read > 0)
+    rx_stats.ring_full++;
+  rx_blocked = false;
+  if (read <= 0)
+  {
+    knx_lock_give(&udp_lock);
+    return false;
+  }
+  if (read > RX_SLOT_SIZE)
+  {
+    udp.flush();
+    knx_lock_give(&udp_lock);
+    rx_stats.oversized++;
+    return true;
+  }
+  udp.read(slot->buf, read);
   udp.flush();
+  knx_lock_give(&udp_lock);
+  KNX_TRACE(TRACE_RX_DATAGRAM, 0, read);
 
-  DEBUG_PRINT("Got packet:");
-  for (int i = 0; i < read; ++i)
+  if (__parse_packet(slot->buf, read, slot->telegram))
   {
-    DEBUG_PRINT(" 0x");
-    DEBUG_PRINT(buf[i], 16);
+    rx_ring->commit();
+    uint32_t depth = rx_ring->size();
+    if (depth > rx_stats.high_water)
+      rx_stats.high_water = depth;
+    knx_event_signal(&rx_event);
   }
-  DEBUG_PRINTLN("");
+  return true;
+}
 
-  knx_ip_pkt_t *knx_pkt = (knx_ip_pkt_t *)buf;
-  DEBUG_PRINT("ST: 0x");
-  DEBUG_PRINTLN(__ntohs(knx_pkt->service_type), 16);
+rx_pass_t ESPKNXIP::__loop_ring()
+{
+  rx_pass_t pass = {0, 0};
+  uint32_t started = micros();
 
-  if (knx_pkt->header_len != 0x06 && knx_pkt->protocol_version != 0x10 && knx_pkt->service_type != KNX_ST_ROUTING_INDICATION)
-    return;
+  rx_slot_t *slot;
+  while ((slot = rx_ring->front()) != nullptr)
+  {
+    if (pass.handled >= rx_budget_packets || (rx_budget_us > 0 && (uint32_t)(micros() - started) >= rx_budget_us))
+      break;
+    __process_telegram(slot->telegram);
+    rx_ring->pop();
+    pass.handled++;
+  }
+
+  pass.left_over = rx_ring->size();
+  return pass;
+}
+
+rx_pass_t ESPKNXIP::__loop_knx()
+{
+  rx_pass_t pass = {0, 0};
+  uint32_t started = micros();
+
+  for (;;)
+  {
+    // Another task may be sending on the same socket
+    knx_lock_take(&udp_lock);
+    // A datagram staged by the previous pass is still sitting in the socket
+    // buffer, and parsePacket() would not report a new one until it is read.
+    int read = rx_staged_len;
+    rx_staged_len = 0;
+    if (read == 0)
+      read = rx_udp->parsePacket();
+    if (read <= 0)
+    {
+      knx_lock_give(&udp_lock);
+      break;
+    }
+
+    if (pass.handled >= rx_budget_packets || (rx_budget_us > 0 && (uint32_t)(micros() - started) >= rx_budget_us))
+    {
+      rx_staged_len = read;
+      pass.left_over = 1;
+      knx_lock_give(&udp_lock);
+      break;
+    }
+
+    uint8_t buf[read];
+    rx_udp->read(buf, read);
+    rx_udp->flush();
+    knx_lock_give(&udp_lock);
+    pass.handled++;
+    KNX_TRACE(TRACE_RX_DATAGRAM, 0, read > 0xFF ? 0xFF : read);
+
+    __handle_packet(buf, read);
+  }
+
+  return pass;
+}
+
+void ESPKNXIP::__handle_packet(uint8_t *buf, int len)
+{
+  telegram_t telegram;
+  if (__parse_packet(buf, len, telegram))
+    __process_telegram(telegram);
+}
+
+bool ESPKNXIP::__parse_packet(uint8_t *buf, int len, telegram_t &telegram)
+{
+  knx_parse_result_t res = knx_frame_parse(buf, len, telegram, &rx_parse_stats);
+  if (res != KNX_PARSE_OK)
+  {
+    knx_routing_ctrl_t ctrl;
+    if (res == KNX_PARSE_FOREIGN_SERVICE && knx_routing_ctrl_parse(buf, len, ctrl))
+      __routing_ctrl(ctrl);
+    KNX_TRACE(TRACE_RX_DROP, 0, res);
+    return false;
+  }
+  KNX_TRACE(TRACE_RX_ACCEPT, telegram.destination.value, telegram.data_len);
+  return true;
+}
 
-  cemi_msg_t *cemi_msg = (cemi_msg_t *)knx_pkt->pkt_data;
-  DEBUG_PRINT("MT: 0x");
-  DEBUG_PRINTLN(cemi_msg->message_code, 16);
-  if (cemi_msg->message_code != KNX_MT_L_DATA_IND)
+void ESPKNXIP::__routing_ctrl(knx_routing_ctrl_t const &ctrl)
+{
+  // Called from the receive task when it runs, send() reads the same state
+  knx_lock_take(&udp_lock);
+  if (ctrl.service == KNX_ST_ROUTING_LOST_MESSAGE)
+  {
+    routing.lost_reports++;
+    routing.lost_messages += ctrl.lost;
+    KNX_TRACE(TRACE_ROUTING_LOST, ctrl.lost, 0);
+  }
+  else if (ctrl.control == 0x0000)
+  {
+    // Other control field values are reserved and do not concern routing devices
+    routing.busy_received++;
+    flow.busy(ctrl.wait_ms, millis(), random(0x7FFFFFFF));
+    KNX_TRACE(TRACE_ROUTING_BUSY, ctrl.wait_ms, flow.busy_counter() > 0xFF ? 0xFF : flow.busy_counter());
+  }
+  knx_lock_give(&udp_lock);
+}
+
+knx_routing_stats_t ESPKNXIP::routing_stats()
+{
+  knx_lock_take(&udp_lock);
+  knx_routing_stats_t stats = routing;
+  stats.busy_counter = flow.busy_counter();
+  knx_lock_give(&udp_lock);
+  return stats;
+}
+
+void ESPKNXIP::__process_telegram(telegram_t const &telegram)
+{
+  // Before dedup, so a post-mortem also shows repeats and our own echoes
+  if (capture.active())
+    capture.push(telegram, micros(), millis());
+
+  // send() records our own frames in the same cache from whichever task calls it
+  uint64_t key = KnxDedupCache::key(telegram.source.value, telegram.destination.value, telegram.ct, telegram.data, telegram.data_len);
+  knx_lock_take(&udp_lock);
+  dedup_verdict_t verdict = dedup.received(key, millis(), telegram.repeated);
+  knx_lock_give(&udp_lock);
+  if (verdict != DEDUP_NEW)
     return;
 
-  DEBUG_PRINT("ADDI: 0x");
-  DEBUG_PRINTLN(cemi_msg->additional_info_len, 16);
-  cemi_service_t *cemi_data = &cemi_msg->data.service_information;
-  if (cemi_msg->additional_info_len > 0)
-    cemi_data = (cemi_service_t *)(((uint8_t *)cemi_data) + cemi_msg->additional_info_len);
-
-  DEBUG_PRINT("C1: 0x");
-  DEBUG_PRINTLN(cemi_data->control_1.byte, 16);
-  DEBUG_PRINT("C2: 0x");
-  DEBUG_PRINTLN(cemi_data->control_2.byte, 16);
-  DEBUG_PRINT("DT: 0x");
-  DEBUG_PRINTLN(cemi_data->control_2.bits.dest_addr_type, 16);
-  if (cemi_data->control_2.bits.dest_addr_type != 0x01)
+  if (stream.active())
+    stream.push(telegram, 0, millis());
+  if (state.size() > 0)
+    __state_received(telegram);
+  __dispatch(telegram);
+}
+
+void ESPKNXIP::__state_received(telegram_t const &telegram)
+{
+  // send() stores our own writes from whichever task calls it, under udp_lock
+  if (telegram.ct == KNX_CT_WRITE || telegram.ct == KNX_CT_ANSWER)
+  {
+    knx_lock_take(&udp_lock);
+    state.store(telegram.destination, telegram.source, telegram.data, telegram.data_len, millis());
+    knx_lock_give(&udp_lock);
+    return;
+  }
+  if (telegram.ct != KNX_CT_READ)
     return;
 
-  DEBUG_PRINT("HC: 0x");
-  DEBUG_PRINTLN(cemi_data->control_2.bits.hop_count, 16);
-  DEBUG_PRINT("EFF: 0x");
-  DEBUG_PRINTLN(cemi_data->control_2.bits.extended_frame_format, 16);
-  DEBUG_PRINT("Source: 0x");
-  DEBUG_PRINT(cemi_data->source.bytes.high, 16);
-  DEBUG_PRINT(" 0x");
-  DEBUG_PRINTLN(cemi_data->source.bytes.low, 16);
-  DEBUG_PRINT("Dest: 0x");
-  DEBUG_PRINT(cemi_data->destination.bytes.high, 16);
-  DEBUG_PRINT(" 0x");
-  DEBUG_PRINTLN(cemi_data->destination.bytes.low, 16);
-
-  knx_command_type_t ct = (knx_command_type_t)(((cemi_data->data[0] & 0xC0) >> 6) | ((cemi_data->pci.apci & 0x03) << 2));
-  DEBUG_PRINT("CT: 0x");
-  DEBUG_PRINTLN(ct, 16);
-  for (int i = 0; i < cemi_data->data_len; ++i)
+  // Answered before any callback runs; callbacks still see the READ. The
+  // value is copied out because send() takes the lock itself.
+  uint8_t data[STATE_PAYLOAD_SIZE];
+  uint8_t data_len = 0;
+  bool answer = false;
+  knx_lock_take(&udp_lock);
+  knx_state_t *e = state.find(telegram.destination.value);
+  if (e != nullptr && (e->flags & (STATE_FLAG_OWNED | STATE_FLAG_VALID)) == (STATE_FLAG_OWNED | STATE_FLAG_VALID))
+  {
+    data_len = e->data_len;
+    memcpy(data, e->data, data_len);
+    answer = true;
+  }
+  knx_lock_give(&udp_lock);
+  if (answer)
   {
-    DEBUG_PRINT(" 0x");
-    DEBUG_PRINT(cemi_data->data[i], 16);
+    KNX_TRACE(TRACE_STATE_ANSWER, telegram.destination.value, data_len);
+    send(telegram.destination, KNX_CT_ANSWER, data_len, data);
   }
-  DEBUG_PRINTLN("==");
+}
+
+// Caller holds udp_lock
+void ESPKNXIP::__state_sent(address_t const &receiver, knx_command_type_t ct, const uint8_t *data, uint8_t data_len)
+{
+  if (state.size() > 0 && (ct == KNX_CT_WRITE || ct == KNX_CT_ANSWER))
+    state.store(receiver, physaddr, data, data_len, millis());
+}
+
+void ESPKNXIP::__dispatch(telegram_t const &telegram)
+{
+  // Fast reject for group addresses nobody listens to
+  if (!ga_index.contains(telegram.destination.value))
+    return;
+
+  // One view of the receive buffer serves every callback
+  message_t msg = {};
+  msg.ct = telegram.ct;
+  msg.received_on = telegram.destination;
+  msg.source = telegram.source;
+  msg.data_len = telegram.data_len;
+  msg.data = telegram.data;
 
   // Call callbacks
-  for (int i = 0; i < registered_callback_assignments; ++i)
+  knx_lock_take(&cfg_lock);
+  for (uint16_t i = ga_index.first(telegram.destination.value); i != GA_INDEX_NONE; i = ga_index.next(i))
   {
-    DEBUG_PRINT("Testing: 0x");
-    DEBUG_PRINT(callback_assignments[i].address.bytes.high, 16);
-    DEBUG_PRINT(" 0x");
-    DEBUG_PRINTLN(callback_assignments[i].address.bytes.low, 16);
-    if (cemi_data->destination.value == callback_assignments[i].address.value)
+    callback_id_t cb_id = callback_assignments[i].callback_id;
+    callback_t &cb = callbacks[cb_id];
+    if (cb.cond && !cb.cond())
     {
-      DEBUG_PRINTLN("Found match");
-      if (callbacks[callback_assignments[i].callback_id].cond && !callbacks[callback_assignments[i].callback_id].cond())
-      {
-        DEBUG_PRINTLN("But it's disabled");
-#if ALLOW_MULTIPLE_CALLBACKS_PER_ADDRESS
-        continue;
-#else
-        return;
-#endif
-      }
-      uint8_t data[cemi_data->data_len];
-      memcpy(data, cemi_data->data, cemi_data->data_len);
-      data[0] = data[0] & 0x3F;
-      message_t msg = {};
-      msg.ct = ct;
-      msg.received_on = cemi_data->destination;
-      msg.data_len = cemi_data->data_len;
-      msg.data = data;
-      callbacks[callback_assignments[i].callback_id].fkt(msg, callbacks[callback_assignments[i].callback_id].arg);
+      KNX_TRACE(TRACE_CB_DISABLED, telegram.destination.value, cb_id);
 #if ALLOW_MULTIPLE_CALLBACKS_PER_ADDRESS
       continue;
 #else
-      return;
+      break;
 #endif
     }
+    KNX_TRACE(TRACE_DISPATCH, telegram.destination.value, cb_id);
+    cb.fkt(msg, cb.arg);
+    if (replay != nullptr)
+      replay->callback_done(cb_id, micros());
+#if !ALLOW_MULTIPLE_CALLBACKS_PER_ADDRESS
+    break;
+#endif
   }
+  knx_lock_give(&cfg_lock);
 }
 
 void ESPKNXIP::physical_address_set(address_t const &addr)
@@ -8,16 +8,74 @@
  */
 
 /* CONFIGURATION */
+#ifndef MAX_CALLBACK_ASSIGNMENTS
 #define MAX_CALLBACK_ASSIGNMENTS  10
+#endif
+#ifndef MAX_CALLBACKS
 #define MAX_CALLBACKS             10
+#endif
 #define MAX_CONFIGS               20
 #define MAX_CONFIG_SPACE          0x0200
 #define MAX_FEEDBACKS             20
 
 #define ALLOW_MULTIPLE_CALLBACKS_PER_ADDRESS  0
 
+/* Receive budget per loop() pass. 0 for RX_BUDGET_US disables the time limit. */
+#define RX_BUDGET_PACKETS         16
+#define RX_BUDGET_US              2000
+
+/* Receive task, see rx_task_start(). RX_RING_SIZE must be a power of two. */
+#define RX_RING_SIZE              32
+#define RX_SLOT_SIZE              64
+#define RX_TASK_STACK_SIZE        4096
+#define RX_TASK_PRIORITY          5
+#define RX_TASK_CORE              0
+
+/* Outbound queue, paced to TX_RATE_LIMIT telegrams/s (0 for no limit). TX_QUEUE_SIZE must be a power of two. */
+#define TX_RATE_LIMIT             50
+#define TX_QUEUE_SIZE             64
+#define TX_SLOT_SIZE              32
+
+/* Echo and repeat suppression window, 0 to deliver every received telegram */
+#define DEDUP_WINDOW_MS           250
+
+/* Live telegram stream at __STREAM_PATH: clients, bytes batched per message and how often it is sent.
+   How many messages a client may have queued is the web server's WS_MAX_QUEUED_MESSAGES. */
+#define STREAM_MAX_CLIENTS        4
+#define STREAM_BUFFER_SIZE        512
+#define STREAM_FLUSH_MS           50
+
+/* JSON API at __API_PATH: largest accepted POST body and changes per list in one batch */
+#define API_BODY_MAX              4096
+#define API_BATCH_MAX             32
+
+/* Bus capture to flash, see capture_start(). Telegrams are written a block of CAPTURE_BLOCK_SIZE bytes
+   at a time into files of CAPTURE_FILE_SIZE, of which the last CAPTURE_FILES are kept. CAPTURE_BLOCKS
+   must be a power of two. */
+#define CAPTURE_BLOCK_SIZE        512
+#define CAPTURE_BLOCKS            4
+#define CAPTURE_FLUSH_MS          1000
+#define CAPTURE_FILE_SIZE         65536
+#define CAPTURE_FILES             8
+#define CAPTURE_DIR               "/capture"
+#define CAPTURE_TASK_STACK_SIZE   4096
+#define CAPTURE_TASK_PRIORITY     1
+
+/* Capture replay, see replay_set(): how many callback ids get a latency histogram */
+#ifndef REPLAY_CALLBACKS
+#define REPLAY_CALLBACKS          MAX_CALLBACKS
+#endif
+
+/* Hot-path tracing into a RAM ring, dumped at __TRACE_PATH. TRACE_RING_SIZE must be a power of two. */
+#ifndef TRACE_ENABLED
+#define TRACE_ENABLED             0
+#endif
+#define TRACE_RING_SIZE           256
+
 #define USE_BOOTSTRAP             1
-#define ROOT_PREFIX               ""
+#ifndef ROOT_PREFIX
+#define ROOT_PREFIX               "" // set with -DROOT_PREFIX to mount the pages below a path
+#endif
 #define DISABLE_EEPROM_BUTTONS    0
 #define DISABLE_REBOOT_BUTTON     0
 #define DISABLE_RESTORE_BUTTON    0
@@ -39,8 +97,25 @@
 #include <AsyncTCP.h>
 #include <ESPAsyncWebServer.h>
 #include "DPT.h"
-
-#define EEPROM_MAGIC (0xDEADBEEF00000000ULL + (MAX_CONFIG_SPACE) + ((uint64_t)MAX_CALLBACK_ASSIGNMENTS << 16) + ((uint64_t)MAX_CALLBACKS << 8))
+#include "esp-knx-ip-dpt.h"
+#include "esp-knx-ip-frame.h"
+#include "esp-knx-ip-ring.h"
+#include "esp-knx-ip-task.h"
+#include "esp-knx-ip-index.h"
+#include "esp-knx-ip-pool.h"
+#include "esp-knx-ip-trace.h"
+#include "esp-knx-ip-dedup.h"
+#include "esp-knx-ip-flow.h"
+#include "esp-knx-ip-txq.h"
+#include "esp-knx-ip-state.h"
+#include "esp-knx-ip-asset.h"
+#include "esp-knx-ip-stream.h"
+#include "esp-knx-ip-history.h"
+#include "esp-knx-ip-capture.h"
+#include "esp-knx-ip-replay.h"
+
+#define STORAGE_FORMAT_VERSION 2
+#define EEPROM_MAGIC (0xDEADBEEF00000000ULL + (MAX_CONFIG_SPACE) + ((uint64_t)STORAGE_FORMAT_VERSION << 24))
 
 #ifndef DEBUG_PRINTER
 #define DEBUG_PRINTER Serial
@@ -63,149 +138,13 @@
 #define __FEEDBACK_PATH   ROOT_PREFIX"/feedback"
 #define __RESTORE_PATH    ROOT_PREFIX"/restore"
 #define __REBOOT_PATH     ROOT_PREFIX"/reboot"
+#define __TRACE_PATH      ROOT_PREFIX"/trace"
+#define __API_PATH        ROOT_PREFIX"/api"
+#define __STREAM_PATH     ROOT_PREFIX"/stream"
+#define __CAPTURE_PATH    ROOT_PREFIX"/capture"
 
 /* Type Definitions */
 
-typedef struct __cemi_addi {
-    uint8_t type_id;
-    uint8_t len;
-    uint8_t data[]; // flexible array member (last element)
-} cemi_addi_t;
-
-typedef union __address {
-  uint16_t value;
-  struct {
-    uint8_t high;
-    uint8_t low;
-  } bytes;
-  struct __attribute__((packed)) {
-    uint8_t line:3;
-    uint8_t area:5;
-    uint8_t member;
-  } ga;
-  struct __attribute__((packed)) {
-    uint8_t line:4;
-    uint8_t area:4;
-    uint8_t member;
-  } pa;
-  uint8_t array[2];
-} address_t;
-
-/* Service and Command Types */
-typedef enum __knx_service_type {
-  KNX_ST_SEARCH_REQUEST           = 0x0201,
-  KNX_ST_SEARCH_RESPONSE          = 0x0202,
-  KNX_ST_DESCRIPTION_REQUEST      = 0x0203,
-  KNX_ST_DESCRIPTION_RESPONSE     = 0x0204,
-  KNX_ST_CONNECT_REQUEST          = 0x0205,
-  KNX_ST_CONNECT_RESPONSE         = 0x0206,
-  KNX_ST_CONNECTIONSTATE_REQUEST  = 0x0207,
-  KNX_ST_CONNECTIONSTATE_RESPONSE = 0x0208,
-  KNX_ST_DISCONNECT_REQUEST       = 0x0209,
-  KNX_ST_DISCONNECT_RESPONSE      = 0x020A,
-  KNX_ST_DEVICE_CONFIGURATION_REQUEST = 0x0310,
-  KNX_ST_DEVICE_CONFIGURATION_ACK     = 0x0311,
-  KNX_ST_TUNNELING_REQUEST = 0x0420,
-  KNX_ST_TUNNELING_ACK     = 0x0421,
-  KNX_ST_ROUTING_INDICATION   = 0x0530,
-  KNX_ST_ROUTING_LOST_MESSAGE = 0x0531,
-  KNX_ST_ROUTING_BUSY         = 0x0532,
-  KNX_ST_REMOTE_DIAGNOSTIC_REQUEST          = 0x0740,
-  KNX_ST_REMOTE_DIAGNOSTIC_RESPONSE         = 0x0741,
-  KNX_ST_REMOTE_BASIC_CONFIGURATION_REQUEST = 0x0742,
-  KNX_ST_REMOTE_RESET_REQUEST               = 0x0743,
-} knx_service_type_t;
-
-typedef enum __knx_command_type {
-  KNX_CT_READ                     = 0x00,
-  KNX_CT_ANSWER                   = 0x01,
-  KNX_CT_WRITE                    = 0x02,
-  KNX_CT_INDIVIDUAL_ADDR_WRITE    = 0x03,
-  KNX_CT_INDIVIDUAL_ADDR_REQUEST  = 0x04,
-  KNX_CT_INDIVIDUAL_ADDR_RESPONSE = 0x05,
-  KNX_CT_ADC_READ                 = 0x06,
-  KNX_CT_ADC_ANSWER               = 0x07,
-  KNX_CT_MEM_READ                 = 0x08,
-  KNX_CT_MEM_ANSWER               = 0x09,
-  KNX_CT_MEM_WRITE                = 0x0A,
-  KNX_CT_MASK_VERSION_READ        = 0x0C,
-  KNX_CT_MASK_VERSION_RESPONSE    = 0x0D,
-  KNX_CT_RESTART                  = 0x0E,
-  KNX_CT_ESCAPE                   = 0x0F,
-} knx_command_type_t;
-
-typedef enum __knx_cemi_msg_type {
-  KNX_MT_L_DATA_REQ = 0x11,
-  KNX_MT_L_DATA_IND = 0x29,
-  KNX_MT_L_DATA_CON = 0x2E,
-} knx_cemi_msg_type_t;
-
-typedef enum __knx_communication_type {
-  KNX_COT_UDP = 0x00,
-  KNX_COT_NDP = 0x01,
-  KNX_COT_UCD = 0x02,
-  KNX_COT_NCD = 0x03,
-} knx_communication_type_t;
-
-/* KNX/IP Packet */
-typedef struct __knx_ip_pkt {
-  uint8_t header_len;
-  uint8_t protocol_version;
-  uint16_t service_type;
-  union {
-    struct {
-      uint8_t first_byte;
-      uint8_t second_byte;
-    } bytes;
-    uint16_t len;
-  } total_len;
-  uint8_t pkt_data[]; // Contains the cEMI message (cemi_msg_t)
-} knx_ip_pkt_t;
-
-/* cEMI Service */
-typedef struct __cemi_service {
-  union {
-    struct {
-      uint8_t confirm:1;
-      uint8_t ack:1;
-      uint8_t priority:2;
-      uint8_t system_broadcast:1;
-      uint8_t repeat:1;
-      uint8_t reserved:1;
-      uint8_t frame_type:1;
-    } bits;
-    uint8_t byte;
-  } control_1;
-  union {
-    struct {
-      uint8_t extended_frame_format:4;
-      uint8_t hop_count:3;
-      uint8_t dest_addr_type:1;
-    } bits;
-    uint8_t byte;
-  } control_2;
-  address_t source;
-  address_t destination;
-  uint8_t data_len;
-  struct {
-    uint8_t apci:2;
-    uint8_t tpci_seq_number:4;
-    uint8_t tpci_comm_type:2;
-  } pci;
-  uint8_t data[];
-} cemi_service_t;
-
-/* cEMI Message */
-typedef struct __cemi_msg {
-  uint8_t message_code;
-  uint8_t additional_info_len;
-  union {
-    /* Changed from a flexible array member to a fixed-size one-element array */
-    cemi_addi_t additional_info[1];
-    cemi_service_t service_information;
-  } data;
-} cemi_msg_t;
-
 /* Configuration and Feedback */
 typedef enum __config_type {
   CONFIG_TYPE_UNKNOWN,
@@ -229,21 +168,74 @@ typedef enum __config_flags {
   CONFIG_FLAGS_VALUE_SET = 1,
 } config_flags_t;
 
+/*
+ * A received telegram as handed to callbacks. data points straight into the
+ * receive buffer and is shared by every callback for the telegram, so data[0]
+ * still carries the two low APCI bits: use first_byte() for its value.
+ */
 typedef struct __message {
   knx_command_type_t ct;
   address_t received_on;
+  address_t source;
   uint8_t data_len;
-  uint8_t *data;
+  const uint8_t *data;
+
+  uint8_t first_byte() const { return data[0] & 0x3F; }
 } message_t;
 
+/* Receive ring slot: the raw datagram and the telegram parsed out of it */
+typedef struct __rx_slot {
+  telegram_t telegram;
+  uint8_t buf[RX_SLOT_SIZE];
+} rx_slot_t;
+
+typedef struct __rx_task_stats {
+  uint32_t ring_full;  // times a frame had to wait in the socket because the ring was full
+  uint32_t oversized;  // datagrams larger than RX_SLOT_SIZE
+  uint16_t high_water; // deepest the ring has been
+} rx_task_stats_t;
+
+/* Render state of the chunked root page, defined in esp-knx-ip-webserver.cpp */
+struct __root_page;
+struct __api_page;
+class KnxJsonWriter;
+
+/* One telegram of a send_batch() call. data follows the send() convention. */
+typedef struct __knx_batch_entry {
+  address_t receiver;
+  knx_command_type_t ct;
+  uint8_t data_len;
+  const uint8_t *data;
+} knx_batch_entry_t;
+
+typedef struct __tx_stats {
+  uint16_t depth;          // frames queued right now
+  uint16_t high_water;     // deepest the queue has been
+  uint32_t sent;
+  uint32_t coalesced;      // writes that replaced a pending frame for the same group address
+  uint32_t dropped;        // frames discarded because the queue was full
+  uint32_t latency_p50_us; // from send() to the socket, upper bucket bounds
+  uint32_t latency_p90_us;
+  uint32_t latency_p99_us;
+} tx_stats_t;
+
+/* Outcome of one receive pass of loop() */
+typedef struct __rx_pass {
+  uint16_t handled;   // datagrams taken from the socket during this pass
+  uint16_t left_over; // datagrams still waiting when the budget ran out (the socket only lets us see one ahead)
+} rx_pass_t;
+
 typedef bool (*enable_condition_t)(void);
 typedef void (*callback_fptr_t)(message_t const &msg, void *arg);
 typedef void (*feedback_action_fptr_t)(void *arg);
 
-typedef uint8_t callback_id_t;
-typedef uint8_t callback_assignment_id_t;
-typedef uint8_t config_id_t;
-typedef uint8_t feedback_id_t;
+typedef uint16_t callback_id_t;
+typedef uint16_t callback_assignment_id_t;
+typedef uint16_t config_id_t;
+typedef uint16_t feedback_id_t;
+
+/* callback_id of a deleted assignment slot; its address.value then links to the next free slot */
+#define CALLBACK_ASSIGNMENT_FREE 0xFFFF
 
 typedef struct __option_entry {
   char *name;
@@ -253,7 +245,7 @@ typedef struct __option_entry {
 typedef struct __config {
   config_type_t type;
   String name;
-  uint8_t offset;
+  uint16_t offset;
   uint8_t len;
   enable_condition_t cond;
   union {
@@ -292,14 +284,80 @@ typedef struct __callback_assignment {
   callback_id_t callback_id;
 } callback_assignment_t;
 
+/* Table capacities for load() with an arena */
+typedef struct __storage_layout {
+  uint16_t callback_assignments; // at most 32768
+  uint16_t callbacks;
+  uint16_t configs;
+  uint16_t feedbacks;
+} storage_layout_t;
+
 /* Main Class */
 class ESPKNXIP {
   public:
     ESPKNXIP();
     void load();
+    /* Like load(), but first moves all tables into arena, sized per layout. Registered entries are kept. */
+    bool load(void *arena, size_t arena_size, storage_layout_t const &layout);
+    static size_t storage_size(storage_layout_t const &layout);
     void start();
     void start(AsyncWebServer *srv);
-    void loop();
+    rx_pass_t loop();
+    /*
+     * Sleeps until loop() has work: a telegram from the receive task, a queued
+     * frame falling due, stream data to send, or max_ms at the latest. Without
+     * the receive task incoming telegrams cannot wake it, so it sleeps 1 ms.
+     */
+    void wait(uint32_t max_ms);
+    /* Ends a wait() early, for a task that has just handed loop() work of its own */
+    void wake();
+
+    void rx_budget_set(uint16_t packets, uint32_t us);
+
+    /* Moves socket reads and parsing into a dedicated task; loop() then only dispatches. Call after start(). */
+    bool rx_task_start(int8_t core = RX_TASK_CORE, uint8_t priority = RX_TASK_PRIORITY);
+    rx_task_stats_t rx_task_stats() { return rx_stats; }
+
+    /* Frames accepted and dropped by the receive parser, per knx_parse_result_t */
+    knx_parse_stats_t parse_stats() { return rx_parse_stats; }
+
+    /* Drops echoes of our own frames and repeated telegrams seen within window_ms */
+    void dedup_window_set(uint32_t window_ms) { dedup.window_set(window_ms); }
+    dedup_stats_t dedup_stats() { return dedup.stats(); }
+
+    /* ROUTING_BUSY / ROUTING_LOST_MESSAGE counters and the frames held back because of them */
+    knx_routing_stats_t routing_stats();
+
+    /*
+     * Keeps the last value written to ga, by anyone including us. Owned
+     * addresses get READ requests answered from the cache right in loop().
+     */
+    bool state_track(address_t ga, bool owned = false) { return state.track(ga, owned); }
+    knx_state_t const *state_get(address_t ga) { return state.find(ga.value); }
+
+    /* Outbound pacing. Writes to a group address that is still queued only update the queued value. */
+    void tx_rate_set(uint16_t telegrams_per_second);
+    uint16_t tx_pending() { return tx_queue.size(); }
+    tx_stats_t tx_stats();
+
+    /* Live stream at __STREAM_PATH: connected clients and what they missed */
+    stream_stats_t stream_stats() { return stream.stats(); }
+
+    /*
+     * Records every received telegram, repeats included, into rotating files
+     * below dir on fs, e.g. LittleFS after LittleFS.begin(). Flash is written
+     * from a task of its own. The files download as one at __CAPTURE_PATH.
+     */
+    bool capture_start(fs::FS &fs, const char *dir = CAPTURE_DIR) { return capture.begin(fs, dir); }
+    capture_stats_t capture_stats() { return capture.stats(); }
+
+    /*
+     * Takes received frames from replay instead of the socket, through the
+     * same parse and dispatch path, and reports each callback's latency to
+     * it. Sending still uses the socket. nullptr goes back to the socket.
+     * Only without the receive task, so that latency covers the whole path.
+     */
+    bool replay_set(KnxReplay *replay);
 
     void save_to_preferences();
     void restore_from_preferences();
@@ -336,7 +394,9 @@ class ESPKNXIP {
     feedback_id_t feedback_register_action(String name, feedback_action_fptr_t value, void *arg = nullptr, enable_condition_t = nullptr);
 
     /* Send functions */
-    void send(address_t const &receiver, knx_command_type_t ct, uint8_t data_len, uint8_t *data);
+    void send(address_t const &receiver, knx_command_type_t ct, uint8_t data_len, const uint8_t *data);
+    /* Encodes and sends count telegrams under one lock; returns how many were sent or queued */
+    uint16_t send_batch(knx_batch_entry_t const *entries, uint16_t count);
 
     void send_1bit(address_t const &receiver, knx_command_type_t ct, uint8_t bit);
     void send_2bit(address_t const &receiver, knx_command_type_t ct, uint8_t twobit);
@@ -395,18 +455,36 @@ class ESPKNXIP {
     void answer_4byte_float(address_t const &receiver, float val) { send_4byte_float(receiver, KNX_CT_ANSWER, val); }
     void answer_14byte_string(address_t const &receiver, const char *val) { send_14byte_string(receiver, KNX_CT_ANSWER, val); }
 
-    bool          data_to_bool(uint8_t *data);
-    int8_t        data_to_1byte_int(uint8_t *data);
-    uint8_t       data_to_1byte_uint(uint8_t *data);
-    int16_t       data_to_2byte_int(uint8_t *data);
-    uint16_t      data_to_2byte_uint(uint8_t *data);
-    float         data_to_2byte_float(uint8_t *data);
-    color_t       data_to_3byte_color(uint8_t *data);
-    time_of_day_t data_to_3byte_time(uint8_t *data);
-    date_t        data_to_3byte_data(uint8_t *data);
-    int32_t       data_to_4byte_int(uint8_t *data);
-    uint32_t      data_to_4byte_uint(uint8_t *data);
-    float         data_to_4byte_float(uint8_t *data);
+    /* Typed access through the Dpt<Main, Sub> codecs, e.g. write<Dpt<9, 1>>(ga, 21.5f) */
+    template <typename D>
+    void send(address_t const &receiver, knx_command_type_t ct, typename D::value_type val)
+    {
+      dpt_bytes_t<D::size> payload = D::encode(val);
+      send(receiver, ct, D::size, payload.data);
+    }
+    template <typename D>
+    void write(address_t const &receiver, typename D::value_type val) { send<D>(receiver, KNX_CT_WRITE, val); }
+    template <typename D>
+    void answer(address_t const &receiver, typename D::value_type val) { send<D>(receiver, KNX_CT_ANSWER, val); }
+    /* A default-constructed value when the payload is too short for D */
+    template <typename D>
+    static typename D::value_type decode(message_t const &msg)
+    {
+      return msg.data_len >= D::size ? D::decode(msg.data) : typename D::value_type();
+    }
+
+    bool          data_to_bool(const uint8_t *data);
+    int8_t        data_to_1byte_int(const uint8_t *data);
+    uint8_t       data_to_1byte_uint(const uint8_t *data);
+    int16_t       data_to_2byte_int(const uint8_t *data);
+    uint16_t      data_to_2byte_uint(const uint8_t *data);
+    float         data_to_2byte_float(const uint8_t *data);
+    color_t       data_to_3byte_color(const uint8_t *data);
+    time_of_day_t data_to_3byte_time(const uint8_t *data);
+    date_t        data_to_3byte_data(const uint8_t *data);
+    int32_t       data_to_4byte_int(const uint8_t *data);
+    uint32_t      data_to_4byte_uint(const uint8_t *data);
+    float         data_to_4byte_float(const uint8_t *data);
 
     static address_t GA_to_address(uint8_t area, uint8_t line, uint8_t member)
     {
@@ -421,11 +499,35 @@ class ESPKNXIP {
     }
 
   private:
+    friend class KnxBench; // src/bench times the private hot paths directly
+
     void __start();
-    void __loop_knx();
+    rx_pass_t __loop_knx();
+    rx_pass_t __loop_ring();
+    void __handle_packet(uint8_t *buf, int len);
+    bool __parse_packet(uint8_t *buf, int len, telegram_t &telegram);
+    void __process_telegram(telegram_t const &telegram);
+    void __dispatch(telegram_t const &telegram);
+    void __routing_ctrl(knx_routing_ctrl_t const &ctrl);
+    void __state_received(telegram_t const &telegram);
+    void __state_sent(address_t const &receiver, knx_command_type_t ct, const uint8_t *data, uint8_t data_len);
+    uint16_t __encode_frame(address_t const &receiver, knx_command_type_t ct, uint8_t data_len, const uint8_t *data);
+    bool __send_frame(address_t const &receiver, knx_command_type_t ct, const uint8_t *buf, uint16_t len);
+    bool __may_transmit(uint32_t now_us);
+    void __transmit(const uint8_t *buf, uint16_t len, uint32_t queued_us);
+    void __flush_tx();
+
+    static void __rx_task(void *arg);
+    bool __rx_task_poll();
 
     /* Webserver functions */
+    void __register_assets();
     void __handle_root(AsyncWebServerRequest *request);
+    bool __root_next(__root_page &page);
+    void __handle_api_get(AsyncWebServerRequest *request);
+    void __api_item(KnxJsonWriter &out, __api_page &page);
+    void __handle_api_body(AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total);
+    void __handle_api_post(AsyncWebServerRequest *request);
     void __handle_register(AsyncWebServerRequest *request);
     void __handle_delete(AsyncWebServerRequest *request);
     void __handle_set(AsyncWebServerRequest *request);
@@ -434,6 +536,8 @@ class ESPKNXIP {
 #endif
     void __handle_config(AsyncWebServerRequest *request);
     void __handle_feedback(AsyncWebServerRequest *request);
+    void __handle_trace(AsyncWebServerRequest *request);
+    void __handle_capture(AsyncWebServerRequest *request);
 #if !DISABLE_RESTORE_BUTTON
     void __handle_restore(AsyncWebServerRequest *request);
 #endif
@@ -451,6 +555,8 @@ class ESPKNXIP {
 
     callback_assignment_id_t __callback_register_assignment(address_t address, callback_id_t id);
     void __callback_delete_assignment(callback_assignment_id_t id);
+    void __callback_rebuild_index();
+    bool __callback_assignment_used(callback_assignment_id_t id) { return id < registered_callback_assignments && callback_assignments[id].callback_id != CALLBACK_ASSIGNMENT_FREE; }
 
     /* Use the ESP32 AsyncWebServer type */
     AsyncWebServer *server;
@@ -458,19 +564,56 @@ class ESPKNXIP {
     WiFiUDP udp;
     Preferences prefs;
 
+    uint16_t rx_budget_packets;
+    uint32_t rx_budget_us;
+    int rx_staged_len;
+    UDP *rx_udp;        // where __loop_knx() reads from: udp, or the replay
+    KnxReplay *replay;
+
+    SpscRing<rx_slot_t, RX_RING_SIZE> *rx_ring; // from SpscRing::create(), which keeps its alignment
+    bool rx_blocked; // the receive task found the ring full and is waiting for loop()
+    knx_task_t rx_task;
+    knx_lock_t udp_lock; // socket, send path, dedup and state cache; taken by every task that sends
+    knx_event_t rx_event; // receive task committed a telegram or a frame was queued
+    knx_lock_t cfg_lock; // held while a batch is applied and while a telegram is dispatched
+    rx_task_stats_t rx_stats;
+    knx_parse_stats_t rx_parse_stats;
+    KnxDedupCache dedup;
+    KnxStateCache state;
+    KnxStream stream;
+    KnxCapture capture;
+
+    // Shared with the receive task and other senders, guarded by udp_lock
+    KnxFlowControl flow;
+    knx_routing_stats_t routing;
+    typedef KnxTxQueue<TX_QUEUE_SIZE, TX_SLOT_SIZE> tx_queue_t;
+    tx_queue_t tx_queue;
+    uint8_t tx_frame[KNX_FRAME_MAX_LEN + 1]; // room for SEND_CHECKSUM
+    uint32_t tx_interval_us;
+    uint32_t tx_next_us;
+    uint32_t tx_sent;
+    uint32_t tx_coalesced;
+    uint32_t tx_dropped;
+    KnxLatencyHistogram tx_latency;
+
+    // Slots in use including deleted ones, which are chained from callback_assignment_free
     callback_assignment_id_t registered_callback_assignments;
-    callback_assignment_t callback_assignments[MAX_CALLBACK_ASSIGNMENTS];
+    callback_assignment_id_t callback_assignment_free;
+    KnxStore<callback_assignment_t, MAX_CALLBACK_ASSIGNMENTS> callback_assignments;
+    GroupAddressIndex ga_index;
+    ga_index_slot_t ga_index_slots[ga_index_slots_for(MAX_CALLBACK_ASSIGNMENTS)];
+    uint16_t ga_index_next[MAX_CALLBACK_ASSIGNMENTS];
 
     callback_id_t registered_callbacks;
-    callback_t callbacks[MAX_CALLBACKS];
+    KnxStore<callback_t, MAX_CALLBACKS> callbacks;
 
     config_id_t registered_configs;
     uint8_t custom_config_data[MAX_CONFIG_SPACE];
     uint8_t custom_config_default_data[MAX_CONFIG_SPACE];
-    config_t custom_configs[MAX_CONFIGS];
+    KnxStore<config_t, MAX_CONFIGS> custom_configs;
 
     feedback_id_t registered_feedbacks;
-    feedback_t feedbacks[MAX_FEEDBACKS];
+    KnxStore<feedback_t, MAX_FEEDBACKS> feedbacks;
 
     uint16_t __ntohs(uint16_t);
 };
@@ -0,0 +1,139 @@
+/**
+ * Host shim for the subset of the Arduino core used by esp-knx-ip
+ * License: MIT
+ */
+
+#include "Arduino.h"
+#include "esp_log.h"
+#include "WiFi.h"
+#include <stdarg.h>
+#include <chrono>
+#include <thread>
+#include <stdlib.h>
+#include <unistd.h>
+
+HardwareSerial Serial;
+WiFiClass WiFi;
+EspClass ESP;
+esp_log_level_t esp_log_host_level = ESP_LOG_INFO;
+
+static const std::chrono::steady_clock::time_point boot = std::chrono::steady_clock::now();
+
+unsigned long millis()
+{
+  return (unsigned long)std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - boot).count();
+}
+
+unsigned long micros()
+{
+  return (unsigned long)std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - boot).count();
+}
+
+void delay(unsigned long ms)
+{
+  std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+void yield()
+{
+  std::this_thread::yield();
+}
+
+size_t Print::print(long v, int base)
+{
+  return print(String(v, (unsigned char)base).c_str());
+}
+
+size_t Print::print(unsigned long v, int base)
+{
+  return print(String(v, (unsigned char)base).c_str());
+}
+
+size_t Print::print(double v, int digits)
+{
+  return print(String(v, (unsigned int)digits).c_str());
+}
+
+size_t Print::print(IPAddress ip)
+{
+  return printf("%u.%u.%u.%u", ip[0], ip[1], ip[2], ip[3]);
+}
+
+size_t Print::printf(const char *fmt, ...)
+{
+  char buf[256];
+  va_list ap;
+  va_start(ap, fmt);
+  int n = vsnprintf(buf, sizeof(buf), fmt, ap);
+  va_end(ap);
+  if (n < 0)
+    return 0;
+  if ((size_t)n < sizeof(buf))
+    return write((const uint8_t *)buf, n);
+
+  std::string big(n + 1, '\0');
+  va_start(ap, fmt);
+  vsnprintf(&big[0], big.size(), fmt, ap);
+  va_end(ap);
+  return write((const uint8_t *)big.data(), n);
+}
+
+std::string String::fmt_uint(unsigned long v, unsigned char base)
+{
+  if (base < 2 || base > 16)
+    base = 10;
+  char buf[sizeof(unsigned long) * 8 + 1];
+  char *p = buf + sizeof(buf);
+  *--p = '\0';
+  do
+  {
+    *--p = "0123456789abcdef"[v % base];
+    v /= base;
+  } while (v);
+  return std::string(p);
+}
+
+std::string String::fmt_int(long v, unsigned char base)
+{
+  if (base == 10 && v < 0)
+    return "-" + fmt_uint(-(unsigned long)v, base);
+  return fmt_uint((unsigned long)v, base);
+}
+
+std::string String::fmt_float(double v, unsigned int decimals)
+{
+  char buf[64];
+  snprintf(buf, sizeof(buf), "%.*f", (int)decimals, v);
+  return std::string(buf);
+}
+
+size_t HardwareSerial::write(uint8_t c)
+{
+  return fwrite(&c, 1, 1, stdout);
+}
+
+size_t HardwareSerial::write(const uint8_t *buf, size_t len)
+{
+  return fwrite(buf, 1, len, stdout);
+}
+
+void EspClass::restart()
+{
+  fflush(stdout);
+  exit(0);
+}
+
+uint32_t EspClass::getFreeHeap()
+{
+  return 0;
+}
+
+long random(long howbig)
+{
+  return howbig <= 0 ? 0 : (long)(::random() % howbig);
+}
+
+long random(long howsmall, long howbig)
+{
+  return howsmall >= howbig ? howsmall : howsmall + random(howbig - howsmall);
+}
@@ -0,0 +1,116 @@
+/**
+ * Host shim for the subset of the Arduino core used by esp-knx-ip
+ * License: MIT
+ */
+#ifndef KNX_HOST_ARDUINO_H
+#define KNX_HOST_ARDUINO_H
+
+#define PROGMEM
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <string>
+#include "IPAddress.h"
+
+#define HEX 16
+#define DEC 10
+#define B11 3
+
+unsigned long millis();
+unsigned long micros();
+long random(long howbig);
+long random(long howsmall, long howbig);
+void delay(unsigned long ms);
+void yield();
+
+class Print
+{
+  public:
+    virtual ~Print() {}
+    virtual size_t write(uint8_t c) = 0;
+    virtual size_t write(const uint8_t *buf, size_t len)
+    {
+      size_t n = 0;
+      while (len--)
+        n += write(*buf++);
+      return n;
+    }
+    size_t write(const char *s) { return write((const uint8_t *)s, strlen(s)); }
+    size_t print(const char *s) { return write(s); }
+    size_t print(char c) { return write((uint8_t)c); }
+    size_t print(const class String &s);
+    size_t print(IPAddress ip);
+    size_t print(long v, int base = DEC);
+    size_t print(int v, int base = DEC) { return print((long)v, base); }
+    size_t print(unsigned long v, int base = DEC);
+    size_t print(unsigned int v, int base = DEC) { return print((unsigned long)v, base); }
+    size_t print(double v, int digits = 2);
+    size_t println() { return write("\r\n"); }
+    template <typename T> size_t println(T v) { size_t n = print(v); return n + println(); }
+    template <typename T> size_t println(T v, int f) { size_t n = print(v, f); return n + println(); }
+    size_t printf(const char *fmt, ...) __attribute__((format(printf, 2, 3)));
+};
+
+class String
+{
+  public:
+    String() {}
+    String(const char *s) : s(s ? s : "") {}
+    String(const std::string &s) : s(s) {}
+    String(char c) : s(1, c) {}
+    String(int v, unsigned char base = DEC) : s(fmt_int(v, base)) {}
+    String(unsigned int v, unsigned char base = DEC) : s(fmt_uint(v, base)) {}
+    String(long v, unsigned char base = DEC) : s(fmt_int(v, base)) {}
+    String(unsigned long v, unsigned char base = DEC) : s(fmt_uint(v, base)) {}
+    String(float v, unsigned int decimals = 2) : s(fmt_float(v, decimals)) {}
+    String(double v, unsigned int decimals = 2) : s(fmt_float(v, decimals)) {}
+
+    const char *c_str() const { return s.c_str(); }
+    unsigned int length() const { return s.length(); }
+    bool equals(const String &o) const { return s == o.s; }
+    bool operator==(const String &o) const { return s == o.s; }
+    bool operator==(const char *o) const { return s == o; }
+    bool operator!=(const String &o) const { return s != o.s; }
+    char operator[](unsigned int i) const { return s[i]; }
+    long toInt() const { return strtol(s.c_str(), nullptr, 10); }
+    float toFloat() const { return strtof(s.c_str(), nullptr); }
+    bool reserve(unsigned int n) { s.reserve(n); return true; }
+
+    String &operator+=(const String &o) { s += o.s; return *this; }
+    String &operator+=(const char *o) { s += o; return *this; }
+    String &operator+=(char c) { s += c; return *this; }
+    friend String operator+(const String &a, const String &b) { return String(a.s + b.s); }
+    friend String operator+(const String &a, const char *b) { return String(a.s + b); }
+    friend String operator+(const char *a, const String &b) { return String(a + b.s); }
+
+  private:
+    static std::string fmt_int(long v, unsigned char base);
+    static std::string fmt_uint(unsigned long v, unsigned char base);
+    static std::string fmt_float(double v, unsigned int decimals);
+    std::string s;
+};
+
+class HardwareSerial : public Print
+{
+  public:
+    void begin(unsigned long) { setvbuf(stdout, nullptr, _IOLBF, 0); } // lines show up as they would on a UART
+    size_t write(uint8_t c) override;
+    size_t write(const uint8_t *buf, size_t len) override;
+    using Print::write;
+};
+inline size_t Print::print(const String &s) { return write(s.c_str()); }
+
+extern HardwareSerial Serial;
+
+class EspClass
+{
+  public:
+    void restart();
+    uint32_t getFreeHeap();
+};
+extern EspClass ESP;
+
+#endif
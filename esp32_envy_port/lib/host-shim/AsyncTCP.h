@@ -0,0 +1,10 @@
+/**
+ * Host shim for AsyncTCP
+ * License: MIT
+ */
+#ifndef KNX_HOST_ASYNCTCP_H
+#define KNX_HOST_ASYNCTCP_H
+
+#include "Arduino.h"
+
+#endif
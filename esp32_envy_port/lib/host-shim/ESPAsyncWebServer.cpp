@@ -0,0 +1,175 @@
+/**
+ * Host shim for ESPAsyncWebServer
+ * License: MIT
+ */
+
+#include "ESPAsyncWebServer.h"
+#include <stdlib.h>
+
+namespace {
+
+class BasicResponse : public AsyncWebServerResponse
+{
+  public:
+    BasicResponse(const uint8_t *data, size_t len) : body((const char *)data, len) {}
+    void render(std::string &out) override { out = body; }
+  private:
+    std::string body;
+};
+
+class ChunkedResponse : public AsyncWebServerResponse
+{
+  public:
+    ChunkedResponse(AwsResponseFiller filler) : filler(filler) {}
+    void render(std::string &out) override
+    {
+      // Pull in TCP-window sized pieces the way AsyncTCP does.
+      uint8_t buf[1436];
+      size_t piece = getenv("KNX_HOST_CHUNK") ? (size_t)atoi(getenv("KNX_HOST_CHUNK")) : sizeof(buf);
+      if (piece == 0 || piece > sizeof(buf))
+        piece = sizeof(buf);
+      out.clear();
+      for (;;)
+      {
+        size_t n = filler(buf, piece, out.size());
+        if (n == 0)
+          break;
+        out.append((const char *)buf, n);
+      }
+    }
+  private:
+    AwsResponseFiller filler;
+};
+
+}
+
+AsyncWebServerRequest::~AsyncWebServerRequest()
+{
+  if (_tempObject)
+    free(_tempObject);
+}
+
+bool AsyncWebServerRequest::hasParam(const String &name, bool post) const
+{
+  return getParam(name, post) != nullptr;
+}
+
+const AsyncWebParameter *AsyncWebServerRequest::getParam(const String &name, bool post) const
+{
+  for (auto const &p : params)
+  {
+    if (p.name() == name && p.isPost() == post)
+      return &p;
+  }
+  return nullptr;
+}
+
+const String &AsyncWebServerRequest::arg(const char *name) const
+{
+  static const String empty;
+  const AsyncWebParameter *p = getParam(name);
+  if (!p)
+    p = getParam(name, true);
+  return p ? p->value() : empty;
+}
+
+bool AsyncWebServerRequest::hasHeader(const String &name) const
+{
+  return getHeader(name) != nullptr;
+}
+
+const AsyncWebHeader *AsyncWebServerRequest::getHeader(const String &name) const
+{
+  for (auto const &h : headers)
+  {
+    if (strcasecmp(h.name().c_str(), name.c_str()) == 0)
+      return &h;
+  }
+  return nullptr;
+}
+
+void AsyncWebServerRequest::send(int code, const String &contentType, const String &content)
+{
+  send(beginResponse(code, contentType, content));
+}
+
+void AsyncWebServerRequest::send(AsyncWebServerResponse *response)
+{
+  response_code = response->code;
+  response_type = response->content_type;
+  response_headers = response->headers;
+  response->render(response_body);
+  delete response;
+}
+
+void AsyncWebServerRequest::redirect(const String &url)
+{
+  AsyncWebServerResponse *response = beginResponse(302);
+  response->addHeader("Location", url);
+  send(response);
+}
+
+AsyncWebServerResponse *AsyncWebServerRequest::beginResponse(int code, const String &contentType, const String &content)
+{
+  AsyncWebServerResponse *r = new BasicResponse((const uint8_t *)content.c_str(), content.length());
+  r->code = code;
+  r->content_type = contentType;
+  return r;
+}
+
+AsyncWebServerResponse *AsyncWebServerRequest::beginResponse_P(int code, const String &contentType, const uint8_t *content, size_t len)
+{
+  AsyncWebServerResponse *r = new BasicResponse(content, len);
+  r->code = code;
+  r->content_type = contentType;
+  return r;
+}
+
+AsyncWebServerResponse *AsyncWebServerRequest::beginChunkedResponse(const String &contentType, AwsResponseFiller callback)
+{
+  AsyncWebServerResponse *r = new ChunkedResponse(callback);
+  r->content_type = contentType;
+  return r;
+}
+
+AsyncResponseStream *AsyncWebServerRequest::beginResponseStream(const String &contentType, size_t)
+{
+  AsyncResponseStream *r = new AsyncResponseStream();
+  r->content_type = contentType;
+  return r;
+}
+
+AsyncWebHandler &AsyncWebServer::on(const char *uri, WebRequestMethodComposite method, ArRequestHandlerFunction onRequest)
+{
+  return on(uri, method, onRequest, nullptr, nullptr);
+}
+
+AsyncWebHandler &AsyncWebServer::on(const char *uri, WebRequestMethodComposite method, ArRequestHandlerFunction onRequest, ArUploadHandlerFunction, ArBodyHandlerFunction onBody)
+{
+  AsyncWebHandler h;
+  h.uri = uri;
+  h.method = method;
+  h.onRequest = onRequest;
+  h.onBody = onBody;
+  handlers.push_back(h);
+  return handlers.back();
+}
+
+bool AsyncWebServer::handle(AsyncWebServerRequest &request, const uint8_t *body, size_t body_len)
+{
+  for (auto &h : handlers)
+  {
+    if (!(h.method & request.method()) || !(h.uri == request.url()))
+      continue;
+    if (body_len && h.onBody)
+      h.onBody(&request, (uint8_t *)body, body_len, 0, body_len);
+    h.onRequest(&request);
+    return true;
+  }
+  if (not_found)
+  {
+    not_found(&request);
+    return true;
+  }
+  return false;
+}
@@ -0,0 +1,242 @@
+/**
+ * Host shim for ESPAsyncWebServer. Handlers are registered as usual and can be
+ * driven in-process through AsyncWebServer::handle(), which returns the full
+ * response body. There is no listening socket.
+ * License: MIT
+ */
+#ifndef KNX_HOST_ESPASYNCWEBSERVER_H
+#define KNX_HOST_ESPASYNCWEBSERVER_H
+
+#include "Arduino.h"
+#include <functional>
+#include <vector>
+#include <string>
+
+typedef enum {
+  HTTP_GET     = 0b00000001,
+  HTTP_POST    = 0b00000010,
+  HTTP_ANY     = 0b01111111,
+} WebRequestMethod;
+typedef uint8_t WebRequestMethodComposite;
+
+class AsyncWebServerRequest;
+class AsyncWebServerResponse;
+
+typedef std::function<void(AsyncWebServerRequest *request)> ArRequestHandlerFunction;
+typedef std::function<void(AsyncWebServerRequest *request, const String &filename, size_t index, uint8_t *data, size_t len, bool final)> ArUploadHandlerFunction;
+typedef std::function<void(AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total)> ArBodyHandlerFunction;
+typedef std::function<size_t(uint8_t *buffer, size_t maxLen, size_t index)> AwsResponseFiller;
+
+class AsyncWebParameter
+{
+  public:
+    AsyncWebParameter(const String &name, const String &value, bool form) : _name(name), _value(value), _form(form) {}
+    const String &name() const { return _name; }
+    const String &value() const { return _value; }
+    bool isPost() const { return _form; }
+  private:
+    String _name;
+    String _value;
+    bool _form;
+};
+
+class AsyncWebHeader
+{
+  public:
+    AsyncWebHeader(const String &name, const String &value) : _name(name), _value(value) {}
+    const String &name() const { return _name; }
+    const String &value() const { return _value; }
+  private:
+    String _name;
+    String _value;
+};
+
+class AsyncWebServerResponse
+{
+  public:
+    virtual ~AsyncWebServerResponse() {}
+    void addHeader(const String &name, const String &value) { headers.push_back(AsyncWebHeader(name, value)); }
+    void setCode(int c) { code = c; }
+    /* Produces the whole body, the way the TCP side would pull it. */
+    virtual void render(std::string &out) = 0;
+
+    int code = 200;
+    String content_type;
+    std::vector<AsyncWebHeader> headers;
+};
+
+class AsyncResponseStream : public AsyncWebServerResponse, public Print
+{
+  public:
+    size_t write(uint8_t c) override { body += (char)c; return 1; }
+    size_t write(const uint8_t *buf, size_t len) override { body.append((const char *)buf, len); return len; }
+    using Print::write;
+    void render(std::string &out) override { out = body; }
+  private:
+    std::string body;
+};
+
+class AsyncWebServerRequest
+{
+  public:
+    AsyncWebServerRequest(WebRequestMethodComposite method, const String &url) : _method(method), _url(url) {}
+    ~AsyncWebServerRequest();
+
+    WebRequestMethodComposite method() const { return _method; }
+    const String &url() const { return _url; }
+
+    bool hasParam(const String &name, bool post = false) const;
+    const AsyncWebParameter *getParam(const String &name, bool post = false) const;
+    bool hasArg(const char *name) const { return hasParam(name) || hasParam(name, true); }
+    const String &arg(const char *name) const;
+    bool hasHeader(const String &name) const;
+    const AsyncWebHeader *getHeader(const String &name) const;
+
+    void send(int code, const String &contentType = String(), const String &content = String());
+    void send(AsyncWebServerResponse *response);
+    void redirect(const String &url);
+    AsyncWebServerResponse *beginResponse(int code, const String &contentType = String(), const String &content = String());
+    AsyncWebServerResponse *beginResponse_P(int code, const String &contentType, const uint8_t *content, size_t len);
+    AsyncWebServerResponse *beginChunkedResponse(const String &contentType, AwsResponseFiller callback);
+    AsyncResponseStream *beginResponseStream(const String &contentType, size_t bufferSize = 1460);
+
+    /* Host side helpers used to build a request */
+    void addParam(const String &name, const String &value, bool post) { params.push_back(AsyncWebParameter(name, value, post)); }
+    void addHeader(const String &name, const String &value) { headers.push_back(AsyncWebHeader(name, value)); }
+
+    void *_tempObject = nullptr;
+
+    /* Result, filled by send() */
+    int response_code = 0;
+    std::string response_body;
+    String response_type;
+    std::vector<AsyncWebHeader> response_headers;
+
+  private:
+    WebRequestMethodComposite _method;
+    String _url;
+    std::vector<AsyncWebParameter> params;
+    std::vector<AsyncWebHeader> headers;
+};
+
+class AsyncWebHandler
+{
+  public:
+    String uri;
+    WebRequestMethodComposite method;
+    ArRequestHandlerFunction onRequest;
+    ArBodyHandlerFunction onBody;
+};
+
+
+#ifndef WS_MAX_QUEUED_MESSAGES
+#define WS_MAX_QUEUED_MESSAGES 32
+#endif
+
+typedef enum { WS_EVT_CONNECT, WS_EVT_DISCONNECT, WS_EVT_PONG, WS_EVT_ERROR, WS_EVT_DATA } AwsEventType;
+typedef enum { WS_DISCONNECTED, WS_CONNECTED, WS_DISCONNECTING } AwsClientStatus;
+class AsyncWebSocket;
+class AsyncWebSocketClient
+{
+  public:
+    AsyncWebSocketClient(uint32_t id) : _id(id) {}
+    uint32_t id() const { return _id; }
+    AwsClientStatus status() const { return closed ? WS_DISCONNECTING : WS_CONNECTED; }
+    size_t queueLen() const { return queued; }
+    bool queueIsFull() const { return queued >= WS_MAX_QUEUED_MESSAGES; }
+    void setCloseClientOnQueueFull(bool close) { close_when_full = close; }
+    bool binary(const uint8_t *m, size_t len) { return __queue(std::string((const char *)m, len)); }
+    bool text(const char *m) { return __queue(std::string(m)); }
+    void close() { closed = true; }
+    /* host side: hold keeps messages queued, like a browser that does not read */
+    size_t queued = 0;
+    bool hold = false;
+    bool closed = false;
+    bool close_when_full = true;
+    std::vector<std::string> messages;
+  private:
+    bool __queue(std::string const &m)
+    {
+      if (closed)
+        return false;
+      if (queueIsFull())
+      {
+        if (close_when_full)
+          close();
+        return false;
+      }
+      messages.push_back(m);
+      if (hold)
+        queued++;
+      return true;
+    }
+    uint32_t _id;
+};
+typedef std::function<void(AsyncWebSocket *, AsyncWebSocketClient *, AwsEventType, void *, uint8_t *, size_t)> AwsEventHandler;
+class AsyncWebSocket
+{
+  public:
+    AsyncWebSocket(const String &url) : _url(url) {}
+    void onEvent(AwsEventHandler h) { handler = h; }
+    typedef enum { DISCARDED = 0, ENQUEUED = 1, PARTIALLY_ENQUEUED = 2 } SendStatus;
+    AsyncWebSocketClient *client(uint32_t id) { for (auto *c : clients) if (c->id() == id) return c; return nullptr; }
+    size_t count() const { size_t n = 0; for (auto *c : clients) n += !c->closed; return n; }
+    SendStatus binaryAll(const uint8_t *m, size_t len)
+    {
+      size_t open = 0, queued = 0;
+      for (auto *c : clients)
+      {
+        if (c->closed)
+          continue;
+        open++;
+        queued += c->binary(m, len);
+      }
+      return queued == 0 ? DISCARDED : queued == open ? ENQUEUED : PARTIALLY_ENQUEUED;
+    }
+    /* Closes the oldest clients while more than max are open */
+    void cleanupClients(uint16_t max)
+    {
+      for (auto *c : clients)
+      {
+        if (count() <= max)
+          break;
+        c->close();
+      }
+    }
+    const String &url() const { return _url; }
+    /* host side */
+    AsyncWebSocketClient *connect(uint32_t id) { auto *c = new AsyncWebSocketClient(id); clients.push_back(c); if (handler) handler(this, c, WS_EVT_CONNECT, nullptr, nullptr, 0); return c; }
+    void disconnect(AsyncWebSocketClient *c)
+    {
+      if (handler) handler(this, c, WS_EVT_DISCONNECT, nullptr, nullptr, 0);
+      for (size_t i = 0; i < clients.size(); ++i) if (clients[i] == c) { clients.erase(clients.begin() + i); break; }
+      delete c;
+    }
+  private:
+    String _url;
+    AwsEventHandler handler;
+    std::vector<AsyncWebSocketClient *> clients;
+};
+
+class AsyncWebServer
+{
+  public:
+    AsyncWebServer(uint16_t port) : port(port) {}
+    void begin() {}
+    AsyncWebHandler &on(const char *uri, WebRequestMethodComposite method, ArRequestHandlerFunction onRequest);
+    AsyncWebHandler &on(const char *uri, WebRequestMethodComposite method, ArRequestHandlerFunction onRequest, ArUploadHandlerFunction onUpload, ArBodyHandlerFunction onBody = nullptr);
+    void onNotFound(ArRequestHandlerFunction fn) { not_found = fn; }
+    void addHandler(AsyncWebSocket *ws) { sockets.push_back(ws); }
+    AsyncWebSocket *socket(const char *url) { for (auto *w : sockets) if (w->url() == url) return w; return nullptr; }
+
+    /* Runs the matching handler in-process. Returns false if no handler matched. */
+    bool handle(AsyncWebServerRequest &request, const uint8_t *body = nullptr, size_t body_len = 0);
+
+  private:
+    uint16_t port;
+    std::vector<AsyncWebHandler> handlers;
+    ArRequestHandlerFunction not_found;
+    std::vector<AsyncWebSocket *> sockets;
+};
+
+#endif
@@ -0,0 +1,194 @@
+/**
+ * Host shim for the Arduino fs::FS and fs::File API backed by a directory
+ * License: MIT
+ */
+
+#include "FS.h"
+#include <dirent.h>
+#include <errno.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace fs
+{
+
+class FileImpl
+{
+  public:
+    FileImpl(const std::string &path, const std::string &host_path) : path(path), host_path(host_path), file(nullptr), dir(nullptr)
+    {
+      size_t slash = path.find_last_of('/');
+      name = slash == std::string::npos ? path : path.substr(slash + 1);
+    }
+    ~FileImpl() { close(); }
+
+    void close()
+    {
+      if (file != nullptr)
+        fclose(file);
+      if (dir != nullptr)
+        closedir(dir);
+      file = nullptr;
+      dir = nullptr;
+    }
+
+    std::string path;
+    std::string host_path;
+    std::string name;
+    FILE *file;
+    DIR *dir;
+};
+
+size_t File::write(const uint8_t *buf, size_t size)
+{
+  if (!impl || impl->file == nullptr)
+    return 0;
+  return fwrite(buf, 1, size, impl->file);
+}
+
+size_t File::read(uint8_t *buf, size_t size)
+{
+  if (!impl || impl->file == nullptr)
+    return 0;
+  return fread(buf, 1, size, impl->file);
+}
+
+bool File::seek(uint32_t pos, SeekMode mode)
+{
+  if (!impl || impl->file == nullptr)
+    return false;
+  return fseek(impl->file, pos, mode == SeekSet ? SEEK_SET : mode == SeekCur ? SEEK_CUR : SEEK_END) == 0;
+}
+
+size_t File::position() const
+{
+  if (!impl || impl->file == nullptr)
+    return 0;
+  return ftell(impl->file);
+}
+
+size_t File::size() const
+{
+  if (!impl)
+    return 0;
+  if (impl->file != nullptr)
+    fflush(impl->file);
+  struct stat st;
+  if (stat(impl->host_path.c_str(), &st) != 0)
+    return 0;
+  return st.st_size;
+}
+
+void File::flush()
+{
+  if (impl && impl->file != nullptr)
+    fflush(impl->file);
+}
+
+void File::close()
+{
+  if (impl)
+    impl->close();
+  impl.reset();
+}
+
+File::operator bool() const
+{
+  return impl && (impl->file != nullptr || impl->dir != nullptr);
+}
+
+const char *File::path() const
+{
+  return impl ? impl->path.c_str() : nullptr;
+}
+
+const char *File::name() const
+{
+  return impl ? impl->name.c_str() : nullptr;
+}
+
+bool File::isDirectory() const
+{
+  return impl && impl->dir != nullptr;
+}
+
+File File::openNextFile(const char *mode)
+{
+  if (!impl || impl->dir == nullptr)
+    return File();
+  struct dirent *e;
+  while ((e = readdir(impl->dir)) != nullptr)
+  {
+    if (strcmp(e->d_name, ".") == 0 || strcmp(e->d_name, "..") == 0)
+      continue;
+    std::string path = impl->path + (impl->path.empty() || impl->path.back() != '/' ? "/" : "") + e->d_name;
+    std::shared_ptr<FileImpl> f(new FileImpl(path, impl->host_path + "/" + e->d_name));
+    struct stat st;
+    if (stat(f->host_path.c_str(), &st) == 0 && S_ISDIR(st.st_mode))
+      f->dir = opendir(f->host_path.c_str());
+    else
+      f->file = fopen(f->host_path.c_str(), strcmp(mode, FILE_READ) == 0 ? "rb" : mode);
+    return File(f);
+  }
+  return File();
+}
+
+bool FS::mount(const std::string &dir)
+{
+  root = dir;
+  ::mkdir(root.c_str(), 0755);
+  struct stat st;
+  return stat(root.c_str(), &st) == 0 && S_ISDIR(st.st_mode);
+}
+
+std::string FS::__host_path(const char *path) const
+{
+  return root + (path[0] == '/' ? "" : "/") + path;
+}
+
+File FS::open(const char *path, const char *mode, bool create)
+{
+  (void)create;
+  if (root.empty())
+    return File();
+  std::shared_ptr<FileImpl> f(new FileImpl(path, __host_path(path)));
+  struct stat st;
+  if (stat(f->host_path.c_str(), &st) == 0 && S_ISDIR(st.st_mode))
+    f->dir = opendir(f->host_path.c_str());
+  else
+  {
+    const char *m = strcmp(mode, FILE_WRITE) == 0 ? "wb" : strcmp(mode, FILE_APPEND) == 0 ? "ab" : "rb";
+    f->file = fopen(f->host_path.c_str(), m);
+  }
+  if (f->file == nullptr && f->dir == nullptr)
+    return File();
+  return File(f);
+}
+
+bool FS::exists(const char *path)
+{
+  struct stat st;
+  return !root.empty() && stat(__host_path(path).c_str(), &st) == 0;
+}
+
+bool FS::remove(const char *path)
+{
+  return !root.empty() && ::unlink(__host_path(path).c_str()) == 0;
+}
+
+bool FS::rename(const char *from, const char *to)
+{
+  return !root.empty() && ::rename(__host_path(from).c_str(), __host_path(to).c_str()) == 0;
+}
+
+bool FS::mkdir(const char *path)
+{
+  return !root.empty() && (::mkdir(__host_path(path).c_str(), 0755) == 0 || errno == EEXIST);
+}
+
+bool FS::rmdir(const char *path)
+{
+  return !root.empty() && ::rmdir(__host_path(path).c_str()) == 0;
+}
+
+}
@@ -0,0 +1,74 @@
+/**
+ * Host shim for the Arduino fs::FS and fs::File API backed by a directory
+ * License: MIT
+ */
+#ifndef KNX_HOST_FS_H
+#define KNX_HOST_FS_H
+
+#include "Arduino.h"
+#include <memory>
+
+#define FILE_READ   "r"
+#define FILE_WRITE  "w"
+#define FILE_APPEND "a"
+
+namespace fs
+{
+
+enum SeekMode { SeekSet = 0, SeekCur = 1, SeekEnd = 2 };
+
+class FileImpl;
+
+/* Copies share one open file, as on the ESP32 */
+class File
+{
+  public:
+    File() {}
+    File(std::shared_ptr<FileImpl> impl) : impl(impl) {}
+
+    size_t write(const uint8_t *buf, size_t size);
+    size_t read(uint8_t *buf, size_t size);
+    bool seek(uint32_t pos, SeekMode mode = SeekSet);
+    size_t position() const;
+    size_t size() const;
+    void flush();
+    void close();
+    operator bool() const;
+    const char *path() const;
+    const char *name() const;
+    bool isDirectory() const;
+    File openNextFile(const char *mode = FILE_READ);
+
+  private:
+    std::shared_ptr<FileImpl> impl;
+};
+
+/* Paths are absolute below the mount, "/" is the directory given to mount() */
+class FS
+{
+  public:
+    File open(const char *path, const char *mode = FILE_READ, bool create = false);
+    File open(const String &path, const char *mode = FILE_READ, bool create = false) { return open(path.c_str(), mode, create); }
+    bool exists(const char *path);
+    bool remove(const char *path);
+    bool rename(const char *from, const char *to);
+    bool mkdir(const char *path);
+    bool rmdir(const char *path);
+
+  protected:
+    bool mount(const std::string &dir);
+    std::string __host_path(const char *path) const;
+
+    std::string root;
+};
+
+}
+
+using fs::FS;
+using fs::File;
+using fs::SeekMode;
+using fs::SeekSet;
+using fs::SeekCur;
+using fs::SeekEnd;
+
+#endif
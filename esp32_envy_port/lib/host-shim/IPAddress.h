@@ -0,0 +1,22 @@
+/**
+ * Host shim for the Arduino IPAddress type
+ * License: MIT
+ */
+#ifndef KNX_HOST_IPADDRESS_H
+#define KNX_HOST_IPADDRESS_H
+
+#include <stdint.h>
+
+class IPAddress
+{
+  public:
+    IPAddress() : addr(0) {}
+    IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d) : addr((uint32_t)a | ((uint32_t)b << 8) | ((uint32_t)c << 16) | ((uint32_t)d << 24)) {}
+    explicit IPAddress(uint32_t network_order) : addr(network_order) {}
+    operator uint32_t() const { return addr; }
+    uint8_t operator[](int i) const { return (addr >> (8 * i)) & 0xFF; }
+  private:
+    uint32_t addr; // network byte order, like the ESP32 core
+};
+
+#endif
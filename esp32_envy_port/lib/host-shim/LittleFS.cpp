@@ -0,0 +1,23 @@
+/**
+ * Host shim for LittleFS, mounted on a directory
+ * License: MIT
+ */
+
+#include "LittleFS.h"
+
+fs::LittleFSFS LittleFS;
+
+namespace fs
+{
+
+bool LittleFSFS::begin(bool formatOnFail, const char *basePath, uint8_t maxOpenFiles, const char *partitionLabel)
+{
+  (void)formatOnFail;
+  (void)basePath;
+  (void)maxOpenFiles;
+  (void)partitionLabel;
+  const char *dir = getenv("KNX_HOST_FS_DIR");
+  return mount(dir ? dir : "littlefs");
+}
+
+}
@@ -0,0 +1,27 @@
+/**
+ * Host shim for LittleFS, mounted on a directory
+ * License: MIT
+ */
+#ifndef KNX_HOST_LITTLEFS_H
+#define KNX_HOST_LITTLEFS_H
+
+#include "FS.h"
+
+namespace fs
+{
+
+/* begin() mounts KNX_HOST_FS_DIR, or ./littlefs, which is created if needed */
+class LittleFSFS : public FS
+{
+  public:
+    bool begin(bool formatOnFail = false, const char *basePath = "/littlefs", uint8_t maxOpenFiles = 10, const char *partitionLabel = "spiffs");
+    void end() { root.clear(); }
+    size_t totalBytes() { return 0; }
+    size_t usedBytes() { return 0; }
+};
+
+}
+
+extern fs::LittleFSFS LittleFS;
+
+#endif
@@ -0,0 +1,101 @@
+/**
+ * Host shim for ESP32 Preferences backed by one file per namespace
+ * License: MIT
+ */
+
+#include "Preferences.h"
+
+bool Preferences::begin(const char *name, bool readOnly)
+{
+  const char *dir = getenv("KNX_HOST_PREFS_DIR");
+  path = std::string(dir ? dir : ".") + "/" + name + ".prefs";
+  read_only = readOnly;
+  dirty = false;
+  __load();
+  return true;
+}
+
+void Preferences::end()
+{
+  if (dirty && !read_only)
+    __store();
+  entries.clear();
+  dirty = false;
+}
+
+size_t Preferences::putBytes(const char *key, const void *value, size_t len)
+{
+  if (read_only)
+    return 0;
+  entries[key].assign((const uint8_t *)value, (const uint8_t *)value + len);
+  dirty = true;
+  return len;
+}
+
+size_t Preferences::getBytes(const char *key, void *buf, size_t maxLen)
+{
+  auto it = entries.find(key);
+  if (it == entries.end() || it->second.size() > maxLen)
+    return 0;
+  memcpy(buf, it->second.data(), it->second.size());
+  return it->second.size();
+}
+
+size_t Preferences::getBytesLength(const char *key)
+{
+  auto it = entries.find(key);
+  return it == entries.end() ? 0 : it->second.size();
+}
+
+uint8_t Preferences::getUChar(const char *key, uint8_t defaultValue)
+{
+  uint8_t v = defaultValue;
+  getBytes(key, &v, sizeof(v));
+  return v;
+}
+
+uint16_t Preferences::getUShort(const char *key, uint16_t defaultValue)
+{
+  uint16_t v = defaultValue;
+  getBytes(key, &v, sizeof(v));
+  return v;
+}
+
+/* File format: repeated [key_len:u8][key][value_len:u32][value] */
+void Preferences::__load()
+{
+  entries.clear();
+  FILE *f = fopen(path.c_str(), "rb");
+  if (!f)
+    return;
+  uint8_t klen;
+  while (fread(&klen, 1, 1, f) == 1)
+  {
+    std::string key(klen, '\0');
+    uint32_t vlen;
+    if (fread(&key[0], 1, klen, f) != klen || fread(&vlen, sizeof(vlen), 1, f) != 1)
+      break;
+    std::vector<uint8_t> value(vlen);
+    if (vlen && fread(value.data(), 1, vlen, f) != vlen)
+      break;
+    entries[key] = value;
+  }
+  fclose(f);
+}
+
+void Preferences::__store()
+{
+  FILE *f = fopen(path.c_str(), "wb");
+  if (!f)
+    return;
+  for (auto const &e : entries)
+  {
+    uint8_t klen = (uint8_t)e.first.size();
+    uint32_t vlen = (uint32_t)e.second.size();
+    fwrite(&klen, 1, 1, f);
+    fwrite(e.first.data(), 1, klen, f);
+    fwrite(&vlen, sizeof(vlen), 1, f);
+    fwrite(e.second.data(), 1, vlen, f);
+  }
+  fclose(f);
+}
@@ -0,0 +1,36 @@
+/**
+ * Host shim for ESP32 Preferences backed by one file per namespace
+ * License: MIT
+ */
+#ifndef KNX_HOST_PREFERENCES_H
+#define KNX_HOST_PREFERENCES_H
+
+#include "Arduino.h"
+#include <map>
+#include <vector>
+
+class Preferences
+{
+  public:
+    bool begin(const char *name, bool readOnly = false);
+    void end();
+
+    size_t putBytes(const char *key, const void *value, size_t len);
+    size_t getBytes(const char *key, void *buf, size_t maxLen);
+    size_t getBytesLength(const char *key);
+    size_t putUChar(const char *key, uint8_t value) { return putBytes(key, &value, sizeof(value)); }
+    uint8_t getUChar(const char *key, uint8_t defaultValue = 0);
+    size_t putUShort(const char *key, uint16_t value) { return putBytes(key, &value, sizeof(value)); }
+    uint16_t getUShort(const char *key, uint16_t defaultValue = 0);
+
+  private:
+    void __load();
+    void __store();
+
+    std::string path;
+    bool read_only = true;
+    bool dirty = false;
+    std::map<std::string, std::vector<uint8_t>> entries;
+};
+
+#endif
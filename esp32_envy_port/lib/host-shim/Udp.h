@@ -0,0 +1,31 @@
+/**
+ * Host shim for the Arduino UDP interface
+ * License: MIT
+ */
+#ifndef KNX_HOST_UDP_H
+#define KNX_HOST_UDP_H
+
+#include "Arduino.h"
+
+/* The same pure virtuals as the ESP32 core, so a UDP source written here builds there */
+class UDP : public Print
+{
+  public:
+    virtual uint8_t begin(uint16_t port) = 0;
+    virtual void stop() = 0;
+    virtual int parsePacket() = 0;
+    virtual int available() = 0;
+    virtual int read() = 0;
+    virtual int read(unsigned char *buf, size_t len) = 0;
+    virtual int read(char *buf, size_t len) = 0;
+    virtual int peek() = 0;
+    virtual void flush() = 0;
+    virtual int beginPacket(IPAddress ip, uint16_t port) = 0;
+    virtual int beginPacket(const char *host, uint16_t port) = 0;
+    virtual int endPacket() = 0;
+    virtual IPAddress remoteIP() = 0;
+    virtual uint16_t remotePort() = 0;
+    using Print::write;
+};
+
+#endif
@@ -0,0 +1,24 @@
+/**
+ * Host shim for the ESP32 WiFi header
+ * License: MIT
+ */
+#ifndef KNX_HOST_WIFI_H
+#define KNX_HOST_WIFI_H
+
+#include "Arduino.h"
+#include "IPAddress.h"
+
+#define WL_CONNECTED 3
+
+// The host is always on the network
+class WiFiClass
+{
+  public:
+    void begin(const char *, const char *) {}
+    int status() { return WL_CONNECTED; }
+    IPAddress localIP() { return IPAddress(127, 0, 0, 1); }
+};
+
+extern WiFiClass WiFi;
+
+#endif
@@ -0,0 +1,169 @@
+/**
+ * Host shim for WiFiUDP backed by a POSIX UDP socket
+ * License: MIT
+ */
+
+#include "WiFiUdp.h"
+#include <arpa/inet.h>
+#include <errno.h>
+#include <stdlib.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+WiFiUDP::WiFiUDP() : fd(-1), remote_port(0), rx_len(0), rx_pos(0), tx_len(0)
+{
+}
+
+WiFiUDP::~WiFiUDP()
+{
+  stop();
+}
+
+void WiFiUDP::stop()
+{
+  if (fd >= 0)
+    close(fd);
+  fd = -1;
+}
+
+uint8_t WiFiUDP::begin(uint16_t port)
+{
+  stop();
+  fd = socket(AF_INET, SOCK_DGRAM, 0);
+  if (fd < 0)
+    return 0;
+  struct sockaddr_in addr = {};
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(port);
+  addr.sin_addr.s_addr = htonl(INADDR_ANY);
+  if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0)
+  {
+    stop();
+    return 0;
+  }
+  return 1;
+}
+
+uint8_t WiFiUDP::beginMulticast(IPAddress ip, uint16_t port)
+{
+  stop();
+  fd = socket(AF_INET, SOCK_DGRAM, 0);
+  if (fd < 0)
+    return 0;
+
+  int one = 1;
+  setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+  setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &one, sizeof(one));
+
+  struct sockaddr_in addr = {};
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(port);
+  addr.sin_addr.s_addr = htonl(INADDR_ANY);
+  if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0)
+  {
+    stop();
+    return 0;
+  }
+
+  // Loopback is the default transport on the host, so processes on one machine
+  // form a bus of their own. KNX_HOST_IF=<local address> joins a real LAN instead.
+  // Our own frames stay visible the same way the routing multicast echoes them.
+  struct in_addr ifaddr = {};
+  const char *iface = getenv("KNX_HOST_IF");
+  if (iface == nullptr || inet_pton(AF_INET, iface, &ifaddr) != 1)
+    ifaddr.s_addr = htonl(INADDR_LOOPBACK);
+  struct ip_mreq mreq = {};
+  mreq.imr_multiaddr.s_addr = (uint32_t)ip;
+  mreq.imr_interface = ifaddr;
+  setsockopt(fd, IPPROTO_IP, IP_ADD_MEMBERSHIP, &mreq, sizeof(mreq));
+  setsockopt(fd, IPPROTO_IP, IP_MULTICAST_IF, &ifaddr, sizeof(ifaddr));
+  unsigned char loop = 1;
+  setsockopt(fd, IPPROTO_IP, IP_MULTICAST_LOOP, &loop, sizeof(loop));
+  int rcvbuf = 1 << 20;
+  setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
+  return 1;
+}
+
+int WiFiUDP::parsePacket()
+{
+  if (fd < 0)
+    return 0;
+  if (rx_pos < rx_len)
+    return 0;
+
+  struct sockaddr_in from = {};
+  socklen_t from_len = sizeof(from);
+  ssize_t n = recvfrom(fd, rx_buf, sizeof(rx_buf), MSG_DONTWAIT, (struct sockaddr *)&from, &from_len);
+  if (n <= 0)
+    return 0;
+  remote_ip = IPAddress((uint32_t)from.sin_addr.s_addr);
+  remote_port = ntohs(from.sin_port);
+  rx_len = (int)n;
+  rx_pos = 0;
+  return rx_len;
+}
+
+int WiFiUDP::read()
+{
+  if (rx_pos >= rx_len)
+    return -1;
+  return rx_buf[rx_pos++];
+}
+
+int WiFiUDP::read(unsigned char *buf, size_t len)
+{
+  int n = available();
+  if ((size_t)n > len)
+    n = (int)len;
+  memcpy(buf, rx_buf + rx_pos, n);
+  rx_pos += n;
+  return n;
+}
+
+int WiFiUDP::beginPacket(IPAddress ip, uint16_t port)
+{
+  if (fd < 0)
+  {
+    fd = socket(AF_INET, SOCK_DGRAM, 0);
+    if (fd < 0)
+      return 0;
+  }
+  remote_ip = ip;
+  remote_port = port;
+  tx_len = 0;
+  return 1;
+}
+
+int WiFiUDP::beginPacket(const char *host, uint16_t port)
+{
+  struct in_addr addr;
+  if (inet_pton(AF_INET, host, &addr) != 1)
+    return 0; // no resolver on the host
+  return beginPacket(IPAddress((uint32_t)addr.s_addr), port);
+}
+
+size_t WiFiUDP::write(uint8_t c)
+{
+  return write(&c, 1);
+}
+
+size_t WiFiUDP::write(const uint8_t *buf, size_t len)
+{
+  if (tx_len + len > sizeof(tx_buf))
+    len = sizeof(tx_buf) - tx_len;
+  memcpy(tx_buf + tx_len, buf, len);
+  tx_len += len;
+  return len;
+}
+
+int WiFiUDP::endPacket()
+{
+  struct sockaddr_in to = {};
+  to.sin_family = AF_INET;
+  to.sin_port = htons(remote_port);
+  to.sin_addr.s_addr = (uint32_t)remote_ip;
+  ssize_t n = sendto(fd, tx_buf, tx_len, 0, (struct sockaddr *)&to, sizeof(to));
+  tx_len = 0;
+  return n < 0 ? 0 : 1;
+}
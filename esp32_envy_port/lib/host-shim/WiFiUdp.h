@@ -0,0 +1,48 @@
+/**
+ * Host shim for WiFiUDP backed by a POSIX UDP socket
+ * License: MIT
+ */
+#ifndef KNX_HOST_WIFIUDP_H
+#define KNX_HOST_WIFIUDP_H
+
+#include "Udp.h"
+
+class WiFiUDP : public UDP
+{
+  public:
+    WiFiUDP();
+    ~WiFiUDP();
+
+    uint8_t begin(uint16_t port) override;
+    uint8_t beginMulticast(IPAddress ip, uint16_t port);
+    void stop() override;
+
+    int parsePacket() override;
+    int available() override { return rx_len - rx_pos; }
+    int read() override;
+    int read(unsigned char *buf, size_t len) override;
+    int read(char *buf, size_t len) override { return read((unsigned char *)buf, len); }
+    int peek() override { return rx_pos < rx_len ? rx_buf[rx_pos] : -1; }
+    void flush() override { rx_len = rx_pos = 0; }
+
+    int beginPacket(IPAddress ip, uint16_t port) override;
+    int beginPacket(const char *host, uint16_t port) override;
+    int endPacket() override;
+    size_t write(uint8_t c) override;
+    size_t write(const uint8_t *buf, size_t len) override;
+
+    IPAddress remoteIP() override { return remote_ip; }
+    uint16_t remotePort() override { return remote_port; }
+
+  private:
+    int fd;
+    IPAddress remote_ip;
+    uint16_t remote_port;
+    uint8_t rx_buf[1460];
+    int rx_len;
+    int rx_pos;
+    uint8_t tx_buf[1460];
+    size_t tx_len;
+};
+
+#endif
@@ -0,0 +1,43 @@
+/**
+ * Host shim for the ESP-IDF logging macros
+ * License: MIT
+ */
+#ifndef KNX_HOST_ESP_LOG_H
+#define KNX_HOST_ESP_LOG_H
+
+#include <stdio.h>
+
+typedef enum {
+  ESP_LOG_NONE,
+  ESP_LOG_ERROR,
+  ESP_LOG_WARN,
+  ESP_LOG_INFO,
+  ESP_LOG_DEBUG,
+  ESP_LOG_VERBOSE,
+} esp_log_level_t;
+
+extern esp_log_level_t esp_log_host_level;
+
+static inline void esp_log_level_set(const char *, esp_log_level_t level) { esp_log_host_level = level; }
+
+#define ESP_HOST_LOG(level, letter, tag, fmt, ...) \
+  do { if (esp_log_host_level >= level) fprintf(stderr, letter " (%s) " fmt "\n", tag, ##__VA_ARGS__); } while (0)
+
+#define ESP_LOGE(tag, fmt, ...) ESP_HOST_LOG(ESP_LOG_ERROR, "E", tag, fmt, ##__VA_ARGS__)
+#define ESP_LOGW(tag, fmt, ...) ESP_HOST_LOG(ESP_LOG_WARN, "W", tag, fmt, ##__VA_ARGS__)
+#define ESP_LOGI(tag, fmt, ...) ESP_HOST_LOG(ESP_LOG_INFO, "I", tag, fmt, ##__VA_ARGS__)
+#define ESP_LOGD(tag, fmt, ...) ESP_HOST_LOG(ESP_LOG_DEBUG, "D", tag, fmt, ##__VA_ARGS__)
+#define ESP_LOGV(tag, fmt, ...) ESP_HOST_LOG(ESP_LOG_VERBOSE, "V", tag, fmt, ##__VA_ARGS__)
+
+static inline void esp_log_buffer_hex_host(const char *tag, const void *buf, unsigned len, esp_log_level_t level)
+{
+  if (esp_log_host_level < level)
+    return;
+  fprintf(stderr, "D (%s)", tag);
+  for (unsigned i = 0; i < len; ++i)
+    fprintf(stderr, " %02x", ((const unsigned char *)buf)[i]);
+  fprintf(stderr, "\n");
+}
+#define ESP_LOG_BUFFER_HEX_LEVEL(tag, buf, len, level) esp_log_buffer_hex_host(tag, buf, len, level)
+
+#endif
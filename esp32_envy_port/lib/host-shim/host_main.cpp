@@ -0,0 +1,16 @@
+/**
+ * Host shim entry point: runs an Arduino sketch's setup() and loop() as a process
+ * License: MIT
+ */
+
+void setup();
+void loop();
+
+// Only linked in when the program has no main() of its own, since the
+// library is built as an archive
+int main()
+{
+  setup();
+  for (;;)
+    loop();
+}
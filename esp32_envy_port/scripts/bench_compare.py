@@ -0,0 +1,102 @@
+"""
+Compares a benchmark run from src/bench against a stored baseline.
+
+    python3 scripts/bench_compare.py current.json baseline.json [--threshold 10]
+
+Either file may be a raw log, e.g. a serial capture from the bench-esp32 env.
+The JSON document is picked out of it. Each benchmark's fastest batch
+(per_op) is compared. One that got slower by more than the threshold, in
+percent, is flagged as a regression, and the exit status is then 1. Runs
+from different platforms or units are refused, since ns and cycles do not
+compare. Save a run as the new baseline by keeping its output as is.
+
+The current run's built-in comparisons are printed after that: the linear
+scan against the group address index, and repeated send() against
+send_batch(). Dedup cost needs no partner, its steps should stay level.
+"""
+
+import argparse
+import json
+import sys
+
+
+def load(path):
+    with open(path, encoding="utf-8", errors="replace") as f:
+        text = f.read()
+    start = text.find('{"suite"')
+    if start < 0:
+        sys.exit("%s: no benchmark results found" % path)
+    try:
+        doc, _ = json.JSONDecoder().raw_decode(text[start:])
+    except ValueError as e:
+        sys.exit("%s: %s" % (path, e))
+    return doc
+
+
+# Old path and new path of the same work, matched by name
+PAIRS = (("/scan/", "/index/"), ("/single/", "/batch/"))
+
+
+def comparisons(results):
+    per_op = {r["name"]: r["per_op"] for r in results}
+    rows = []
+    for r in results:
+        for old, new in PAIRS:
+            if old in r["name"]:
+                other = r["name"].replace(old, new)
+                if per_op.get(other, 0) > 0:
+                    rows.append((other, r["name"], r["per_op"] / per_op[other]))
+    return rows
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Flag benchmark regressions against a baseline")
+    parser.add_argument("current")
+    parser.add_argument("baseline")
+    parser.add_argument("--threshold", type=float, default=10.0,
+                        help="slowdown in percent that counts as a regression (default 10)")
+    args = parser.parse_args()
+
+    current = load(args.current)
+    baseline = load(args.baseline)
+    for key in ("platform", "unit"):
+        if current.get(key) != baseline.get(key):
+            sys.exit("%s differs: %s vs %s" % (key, current.get(key), baseline.get(key)))
+
+    unit = current["unit"]
+    base = {r["name"]: r for r in baseline["results"]}
+    seen = set()
+    regressions = 0
+    print("%-28s %12s %12s %8s" % ("benchmark", "baseline", "current", "change"))
+    for r in current["results"]:
+        name = r["name"]
+        seen.add(name)
+        b = base.get(name)
+        if b is None:
+            print("%-28s %12s %12.2f %8s  new" % (name, "-", r["per_op"], ""))
+            continue
+        change = (r["per_op"] - b["per_op"]) / b["per_op"] * 100 if b["per_op"] > 0 else 0.0
+        flag = ""
+        if change > args.threshold:
+            flag = "  REGRESSION"
+            regressions += 1
+        elif change < -args.threshold:
+            flag = "  faster"
+        print("%-28s %12.2f %12.2f %+7.1f%%%s" % (name, b["per_op"], r["per_op"], change, flag))
+    for name in base:
+        if name not in seen:
+            print("%-28s %12.2f %12s %8s  missing" % (name, base[name]["per_op"], "-", ""))
+
+    print("%d regression(s) over %.1f%%, times in %s/op" % (regressions, args.threshold, unit))
+
+    rows = comparisons(current["results"])
+    if rows:
+        print()
+        print("%-28s %-28s %8s" % ("benchmark", "against", "speedup"))
+        for new, old, speedup in rows:
+            print("%-28s %-28s %7.1fx" % (new, old, speedup))
+    return 1 if regressions else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,64 @@
+"""
+Prints a bus capture from /knx/capture, or a .kc file copied off the flash,
+one telegram per line in the monitor's format:
+
+    python3 scripts/capture_dump.py bus.kc
+
+Times are seconds since boot. The capture is a sequence of blocks, each
+starting with 'K', 'C', version, record count, record bytes (uint16, LE),
+millis() and micros() of the first record (uint32, LE). Records are the µs
+since the previous record (LEB128), source, destination, ct, length and
+payload. A damaged block is skipped by looking for the next block header.
+"""
+
+import struct
+import sys
+
+HEADER_LEN = 14
+VERSION = 1
+
+
+def records(data):
+    pos = 0
+    while pos + HEADER_LEN <= len(data):
+        if data[pos:pos + 2] != b"KC" or data[pos + 2] != VERSION:
+            pos += 1
+            continue
+        count, length, ms, us = struct.unpack_from("<BHII", data, pos + 3)
+        body = data[pos + HEADER_LEN:pos + HEADER_LEN + length]
+        if len(body) < length:
+            break
+        offset_us = 0
+        i = 0
+        for _ in range(count):
+            delta = shift = 0
+            while True:
+                b = body[i]
+                i += 1
+                delta |= (b & 0x7F) << shift
+                shift += 7
+                if not b & 0x80:
+                    break
+            offset_us += delta
+            src, dst, ct, n = struct.unpack_from(">HHBB", body, i)
+            i += 6
+            yield ms * 1000 + offset_us, src, dst, ct, body[i:i + n]
+            i += n
+        pos += HEADER_LEN + length
+
+
+def main():
+    if len(sys.argv) != 2:
+        sys.exit("usage: capture_dump.py <capture file>")
+    with open(sys.argv[1], "rb") as f:
+        data = f.read()
+    for t_us, src, dst, ct, payload in records(data):
+        print("%d.%06d Received %d.%d.%d -> %d/%d/%d CT=0x%x Data: %s" % (
+            t_us // 1000000, t_us % 1000000,
+            src >> 12, (src >> 8) & 0x0F, src & 0xFF,
+            dst >> 11, (dst >> 8) & 0x07, dst & 0xFF,
+            ct, " ".join("%02x" % b for b in payload)))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,121 @@
+"""
+Packs the static web files into gzip-compressed C arrays.
+
+Runs as a PlatformIO pre-build script (see extra_scripts in platformio.ini)
+and can be run by hand with `python3 scripts/gen_assets.py`. Each asset set
+turns a directory of files into one header holding a knx_asset_t table. The
+ETag is a hash of the uncompressed file, so it only changes when the content
+does. A page refers to another file as {{asset:name}}, which is replaced
+by name?v=<version>. Headers are rewritten only when their content changes, which keeps
+incremental builds incremental. The generated headers are committed so the
+library also builds without this script (e.g. from the Arduino IDE).
+"""
+
+import gzip
+import hashlib
+import os
+import re
+
+MIME = {
+    ".css": "text/css",
+    ".html": "text/html",
+    ".js": "application/javascript",
+    ".json": "application/json",
+    ".svg": "image/svg+xml",
+    ".ico": "image/x-icon",
+}
+
+# (source dir, output header, symbol prefix, URL prefix expression, description)
+ASSET_SETS = [
+    ("lib/esp-knx-ip/web", "lib/esp-knx-ip/esp-knx-ip-assets.h", "knx", "ROOT_PREFIX ",
+     "Static web assets of the configuration page"),
+    ("src/web", "src/monitor-assets.h", "monitor", "",
+     "Static web assets of the monitor page"),
+]
+
+
+def symbol(name):
+    return re.sub(r"[^A-Za-z0-9]", "_", name)
+
+
+def c_array(data):
+    lines = []
+    for i in range(0, len(data), 16):
+        lines.append("  " + ", ".join("0x%02x" % b for b in data[i:i + 16]) + ",")
+    return "\n".join(lines)
+
+
+def render(src_dir, header, prefix, url_prefix, description):
+    names = sorted(n for n in os.listdir(src_dir)
+                   if os.path.isfile(os.path.join(src_dir, n)) and os.path.splitext(n)[1] in MIME)
+    guard = symbol(os.path.basename(header)).upper()
+    out = [
+        "/**",
+        " * esp-knx-ip library for KNX/IP communication on an ESP32",
+        " * %s, generated by scripts/gen_assets.py. Do not edit." % description,
+        " * License: MIT",
+        " */",
+        "",
+        "#ifndef %s" % guard,
+        "#define %s" % guard,
+        "",
+        '#include "esp-knx-ip-asset.h"',
+        "",
+    ]
+    # Pages come last so they can refer to the other files by version:
+    # {{asset:knx.css}} becomes knx.css?v=<version>.
+    names.sort(key=lambda n: n.endswith(".html"))
+    versions = {}
+    rows = []
+    for name in names:
+        with open(os.path.join(src_dir, name), "rb") as f:
+            raw = f.read()
+        if name.endswith(".html"):
+            raw = re.sub(rb"\{\{asset:([^}]+)\}\}",
+                         lambda m: b"%s?v=%s" % (m.group(1), versions[m.group(1).decode()].encode()), raw)
+        packed = gzip.compress(raw, compresslevel=9, mtime=0)
+        tag = hashlib.sha1(raw).hexdigest()[:16]
+        versions[name] = tag
+        sym = "%s_asset_%s" % (prefix, symbol(name))
+        macro = sym.upper()
+        url = "/" if name == "index.html" else "/" + name
+        out.append("// %s: %u bytes, %u gzipped" % (name, len(raw), len(packed)))
+        out.append('#define %s_VERSION "%s"' % (macro, tag))
+        out.append("static const uint8_t %s[] PROGMEM = {" % sym)
+        out.append(c_array(packed))
+        out.append("};")
+        out.append("")
+        # Pages are fetched by their bare URL and must be revalidated;
+        # everything else is linked with ?v=<version> and cached for good.
+        cache = "ASSET_CACHE_REVALIDATE" if name.endswith(".html") else "ASSET_CACHE_IMMUTABLE"
+        rows.append('  { %s"%s", "%s", %s, sizeof(%s), "\\"" %s_VERSION "\\"", %s },'
+                    % (url_prefix, url, MIME[os.path.splitext(name)[1]], sym, sym, macro, cache))
+    out.append("static const knx_asset_t %s_assets[] = {" % prefix)
+    out.extend(rows)
+    out.append("};")
+    out.append("")
+    out.append("#define %s_ASSET_COUNT (sizeof(%s_assets) / sizeof(%s_assets[0]))" % (prefix.upper(), prefix, prefix))
+    out.append("")
+    out.append("#endif")
+    out.append("")
+    return "\n".join(out)
+
+
+def generate(root):
+    for src, header, prefix, url_prefix, description in ASSET_SETS:
+        text = render(os.path.join(root, src), header, prefix, url_prefix, description)
+        path = os.path.join(root, header)
+        if os.path.exists(path):
+            with open(path) as f:
+                if f.read() == text:
+                    continue
+        with open(path, "w") as f:
+            f.write(text)
+        print("gen_assets: wrote %s" % header)
+
+
+try:
+    Import("env")  # noqa: F821 - provided by PlatformIO's SCons environment
+    generate(env["PROJECT_DIR"])  # noqa: F821
+except NameError:
+    generate(os.path.dirname(os.path.dirname(os.path.abspath(__file__))))
@@ -0,0 +1,416 @@
+/**
+ * Microbenchmarks for the esp-knx-ip hot paths: receive parsing, dedup as
+ * traffic grows, callback dispatch (against the old linear scan), send
+ * encoders, send_batch() against send(), data_to_* decoders, config access
+ * and the root page.
+ * Build with the bench-native or bench-esp32 env; compare runs with
+ * scripts/bench_compare.py.
+ * License: MIT
+ */
+
+#include <Arduino.h>
+#include <stdlib.h>
+#include "esp-knx-ip.h"
+#include "bench.h"
+
+/* Dispatch is timed at each of these assignment counts, the root page at the marked ones */
+static const uint16_t DISPATCH_STEPS[] = {1, 10, 100, 1000};
+static const uint16_t ROOT_STEPS[] = {10, 1000};
+/* Dedup is timed with this many distinct telegrams in flight, the cache holds DEDUP_SETS * DEDUP_WAYS */
+static const uint16_t DEDUP_STEPS[] = {16, 256, 4096, 65535};
+/* send_batch() is timed with this many telegrams per call */
+static const uint8_t BATCH_STEPS[] = {8, 64};
+
+static uint32_t delivered;
+
+static void count_cb(message_t const & /* msg */, void * /* arg */)
+{
+  delivered++;
+}
+
+/* Friend of ESPKNXIP, see esp-knx-ip.h */
+class KnxBench
+{
+  public:
+    KnxBench(ESPKNXIP &knx, Bench &bench) : knx(knx), bench(bench)
+    {
+      ga = ESPKNXIP::GA_to_address(10, 6, 5);
+    }
+
+    void run_all()
+    {
+      // Every datagram has to reach dispatch, and every send leaves at once
+      knx.dedup_window_set(0);
+      knx.tx_rate_set(0);
+
+      rx();
+      dedup();
+      encoders();
+      batch();
+      decoders();
+      config();
+      dispatch();
+    }
+
+  private:
+    /* Per-datagram work of __loop_knx() without the socket read */
+    void rx()
+    {
+      // Routing indication, 1.1.5 writes DPT 9 21.5 to 10/6/5
+      static const uint8_t frame[] = {0x06, 0x10, 0x05, 0x30, 0x00, 0x13, 0x29, 0x00, 0xbc, 0xe0,
+                                      0x11, 0x05, 0x56, 0x05, 0x03, 0x00, 0x80, 0x0c, 0x33};
+      uint8_t buf[sizeof(frame)];
+      memcpy(buf, frame, sizeof(frame));
+
+      bench.run("rx/parse", [&](uint32_t n) {
+        telegram_t telegram;
+        for (uint32_t i = 0; i < n; ++i)
+        {
+          bench_keep(knx.__parse_packet(bench_opaque(buf), sizeof(buf), telegram));
+          bench_keep(telegram);
+        }
+      });
+      // Parse, dedup, state cache and a dispatch that finds no assignment
+      bench.run("rx/packet", [&](uint32_t n) {
+        for (uint32_t i = 0; i < n; ++i)
+          knx.__handle_packet(bench_opaque(buf), sizeof(buf));
+      });
+    }
+
+    /*
+     * Per-telegram dedup cost, key hash and cache lookup, in a cache of its
+     * own with the default window. Every telegram is flagged as repeated and
+     * cycles through more and more distinct group addresses: 16 are all
+     * duplicates, the larger counts evict on nearly every telegram.
+     */
+    void dedup()
+    {
+      static KnxDedupCache cache;
+      static const uint8_t payload[] = {0x80, 0x0c, 0x33};
+      uint16_t source = ESPKNXIP::PA_to_address(1, 1, 5).value;
+      cache.window_set(DEDUP_WINDOW_MS);
+
+      for (uint8_t step = 0; step < sizeof(DEDUP_STEPS) / sizeof(DEDUP_STEPS[0]); ++step)
+      {
+        uint16_t distinct = DEDUP_STEPS[step];
+        uint16_t ga = 0;
+        char name[40];
+        snprintf(name, sizeof(name), "dedup/received/%u", distinct);
+        bench.run(name, [&](uint32_t n) {
+          uint32_t now = millis();
+          for (uint32_t i = 0; i < n; ++i)
+          {
+            uint64_t key = KnxDedupCache::key(source, ga, KNX_CT_WRITE, bench_opaque(payload), sizeof(payload));
+            bench_keep(cache.received(key, now, true));
+            ga = ga + 1 == distinct ? 0 : ga + 1;
+          }
+        });
+      }
+    }
+
+    /* What each send_* does before the socket: DPT encode and frame build */
+    template <typename D>
+    void encoder(const char *name, typename D::value_type v)
+    {
+      bench.run(name, [&](uint32_t n) {
+        for (uint32_t i = 0; i < n; ++i)
+        {
+          dpt_bytes_t<D::size> payload = D::encode(bench_opaque(v));
+          bench_keep(knx.__encode_frame(ga, KNX_CT_WRITE, D::size, payload.data));
+        }
+      });
+    }
+
+    void encoders()
+    {
+      time_of_day_t time = {DPT_10_001_WEEKDAY_MONDAY, 12, 34, 56};
+      date_t date = {17, 10, 26};
+      color_t color = {0x10, 0x80, 0xF0};
+      encoder<Dpt<1>>("send/1bit", true);
+      encoder<Dpt<2>>("send/2bit", 2);
+      encoder<Dpt<3>>("send/4bit", 9);
+      encoder<Dpt<6>>("send/1byte_int", -42);
+      encoder<Dpt<5>>("send/1byte_uint", 200);
+      encoder<Dpt<8>>("send/2byte_int", -1234);
+      encoder<Dpt<7>>("send/2byte_uint", 54321);
+      encoder<Dpt<9>>("send/2byte_float", 21.5f);
+      encoder<Dpt<10>>("send/3byte_time", time);
+      encoder<Dpt<11>>("send/3byte_date", date);
+      encoder<Dpt<232>>("send/3byte_color", color);
+      encoder<Dpt<13>>("send/4byte_int", -123456789);
+      encoder<Dpt<12>>("send/4byte_uint", 3123456789UL);
+      encoder<Dpt<14>>("send/4byte_float", 1013.25f);
+      encoder<Dpt<16>>("send/14byte_string", "esp-knx-ip");
+
+      // The whole path once, including the socket. The bench does not join a
+      // network on the target, so this one only runs on the host.
+      if (WiFi.status() != WL_CONNECTED)
+        return;
+      bench.run("send/2byte_float/socket", [&](uint32_t n) {
+        for (uint32_t i = 0; i < n; ++i)
+          knx.send_2byte_float(ga, KNX_CT_WRITE, bench_opaque(21.5f));
+      });
+    }
+
+    /*
+     * send_batch() against one send() per telegram, socket included, so host
+     * only like send/2byte_float/socket. One op is one frame, per_s is frames/s.
+     */
+    void batch()
+    {
+      if (WiFi.status() != WL_CONNECTED)
+        return;
+      static const uint8_t payload[] = {0x80, 0x0c, 0x33};
+      static knx_batch_entry_t entries[64];
+      for (uint8_t i = 0; i < sizeof(entries) / sizeof(entries[0]); ++i)
+        entries[i] = {ESPKNXIP::GA_to_address(10, 6, i), KNX_CT_WRITE, sizeof(payload), payload};
+
+      for (uint8_t step = 0; step < sizeof(BATCH_STEPS) / sizeof(BATCH_STEPS[0]); ++step)
+      {
+        uint8_t size = BATCH_STEPS[step];
+        char name[40];
+        snprintf(name, sizeof(name), "send/single/%u", size);
+        bench.run(name, [&](uint32_t n) {
+          for (uint32_t i = 0; i < n; ++i)
+          {
+            knx_batch_entry_t const &e = entries[i % size];
+            knx.send(e.receiver, e.ct, e.data_len, bench_opaque(e.data));
+          }
+        });
+        snprintf(name, sizeof(name), "send/batch/%u", size);
+        bench.run(name, [&](uint32_t n) {
+          for (uint32_t i = 0; i < n; i += size)
+            bench_keep(knx.send_batch(bench_opaque(entries), n - i < size ? n - i : size));
+        });
+      }
+    }
+
+    template <typename F>
+    void decoder(const char *name, const uint8_t *data, F fn)
+    {
+      bench.run(name, [&](uint32_t n) {
+        for (uint32_t i = 0; i < n; ++i)
+          bench_keep(fn(bench_opaque(data)));
+      });
+    }
+
+    void decoders()
+    {
+      static const uint8_t one[] = {0x01};
+      static const uint8_t byte[] = {0x00, 0xd6};
+      static const uint8_t two[] = {0x00, 0xfb, 0x2e};
+      static const uint8_t f16[] = {0x00, 0x0c, 0x33};
+      static const uint8_t three[] = {0x00, 0x4c, 0x22, 0x38};
+      static const uint8_t four[] = {0x00, 0xf8, 0xa4, 0x32, 0xeb};
+      static const uint8_t f32[] = {0x00, 0x44, 0x7d, 0x50, 0x00};
+      decoder("decode/bool", one, [this](const uint8_t *d) { return knx.data_to_bool(d); });
+      decoder("decode/1byte_int", byte, [this](const uint8_t *d) { return knx.data_to_1byte_int(d); });
+      decoder("decode/1byte_uint", byte, [this](const uint8_t *d) { return knx.data_to_1byte_uint(d); });
+      decoder("decode/2byte_int", two, [this](const uint8_t *d) { return knx.data_to_2byte_int(d); });
+      decoder("decode/2byte_uint", two, [this](const uint8_t *d) { return knx.data_to_2byte_uint(d); });
+      decoder("decode/2byte_float", f16, [this](const uint8_t *d) { return knx.data_to_2byte_float(d); });
+      decoder("decode/3byte_color", three, [this](const uint8_t *d) { return knx.data_to_3byte_color(d); });
+      decoder("decode/3byte_time", three, [this](const uint8_t *d) { return knx.data_to_3byte_time(d); });
+      decoder("decode/3byte_date", three, [this](const uint8_t *d) { return knx.data_to_3byte_data(d); });
+      decoder("decode/4byte_int", four, [this](const uint8_t *d) { return knx.data_to_4byte_int(d); });
+      decoder("decode/4byte_uint", four, [this](const uint8_t *d) { return knx.data_to_4byte_uint(d); });
+      decoder("decode/4byte_float", f32, [this](const uint8_t *d) { return knx.data_to_4byte_float(d); });
+    }
+
+    void config()
+    {
+      static option_entry_t options[] = {{(char *)"Off", 0}, {(char *)"On", 1}, {nullptr, 0}};
+      config_id_t s = knx.config_register_string("Bench string", 16, "living room");
+      config_id_t i = knx.config_register_int("Bench int", 42);
+      config_id_t b = knx.config_register_bool("Bench bool", true);
+      config_id_t o = knx.config_register_options("Bench options", options, 1);
+      config_id_t g = knx.config_register_ga("Bench GA");
+      knx.config_set_ga(g, ga);
+
+      bench.run("config/get_string", [&](uint32_t n) {
+        for (uint32_t k = 0; k < n; ++k)
+          bench_keep(knx.config_get_string(s));
+      });
+      bench.run("config/get_int", [&](uint32_t n) {
+        for (uint32_t k = 0; k < n; ++k)
+          bench_keep(knx.config_get_int(i));
+      });
+      bench.run("config/get_bool", [&](uint32_t n) {
+        for (uint32_t k = 0; k < n; ++k)
+          bench_keep(knx.config_get_bool(b));
+      });
+      bench.run("config/get_options", [&](uint32_t n) {
+        for (uint32_t k = 0; k < n; ++k)
+          bench_keep(knx.config_get_options(o));
+      });
+      bench.run("config/get_ga", [&](uint32_t n) {
+        for (uint32_t k = 0; k < n; ++k)
+          bench_keep(knx.config_get_ga(g));
+      });
+
+      String text("kitchen");
+      bench.run("config/set_string", [&](uint32_t n) {
+        for (uint32_t k = 0; k < n; ++k)
+          knx.config_set_string(s, text);
+      });
+      bench.run("config/set_int", [&](uint32_t n) {
+        for (uint32_t k = 0; k < n; ++k)
+          knx.config_set_int(i, (int32_t)k);
+      });
+      bench.run("config/set_bool", [&](uint32_t n) {
+        for (uint32_t k = 0; k < n; ++k)
+          knx.config_set_bool(b, k & 1);
+      });
+      bench.run("config/set_options", [&](uint32_t n) {
+        for (uint32_t k = 0; k < n; ++k)
+          knx.config_set_options(o, k & 1);
+      });
+      bench.run("config/set_ga", [&](uint32_t n) {
+        for (uint32_t k = 0; k < n; ++k)
+          knx.config_set_ga(g, bench_opaque(ga));
+      });
+    }
+
+    /* __dispatch() through the group address index, and the same lookup as the linear scan it replaced */
+    void dispatch_pair(const char *kind, uint16_t assigned, telegram_t const &telegram)
+    {
+      char name[40];
+      snprintf(name, sizeof(name), "dispatch/index/%s/%u", kind, assigned);
+      bench.run(name, [&](uint32_t n) {
+        for (uint32_t i = 0; i < n; ++i)
+          knx.__dispatch(telegram);
+      });
+      snprintf(name, sizeof(name), "dispatch/scan/%s/%u", kind, assigned);
+      bench.run(name, [&](uint32_t n) {
+        for (uint32_t i = 0; i < n; ++i)
+          scan_dispatch(telegram);
+      });
+    }
+
+    /* The dispatch loop of __loop_knx() before the index, debug output left out */
+    void scan_dispatch(telegram_t const &telegram)
+    {
+      for (int i = 0; i < knx.registered_callback_assignments; ++i)
+      {
+        if (telegram.destination.value == knx.callback_assignments[i].address.value)
+        {
+          callback_t &cb = knx.callbacks[knx.callback_assignments[i].callback_id];
+          if (cb.cond && !cb.cond())
+          {
+#if ALLOW_MULTIPLE_CALLBACKS_PER_ADDRESS
+            continue;
+#else
+            return;
+#endif
+          }
+          uint8_t data[telegram.data_len];
+          memcpy(data, telegram.data, telegram.data_len);
+          data[0] = data[0] & 0x3F;
+          message_t msg = {};
+          msg.ct = telegram.ct;
+          msg.received_on = telegram.destination;
+          msg.data_len = telegram.data_len;
+          msg.data = data;
+          cb.fkt(msg, cb.arg);
+#if !ALLOW_MULTIPLE_CALLBACKS_PER_ADDRESS
+          return;
+#endif
+        }
+      }
+    }
+
+    /* Index against scan as the assignment table grows, for a hit and a miss */
+    void dispatch()
+    {
+      callback_id_t id = knx.callback_register("Bench", count_cb);
+      static const uint8_t payload[] = {0x80, 0x0c, 0x33};
+      telegram_t telegram = {};
+      telegram.source = ESPKNXIP::PA_to_address(1, 1, 5);
+      telegram.ct = KNX_CT_WRITE;
+      telegram.data = payload;
+      telegram.data_len = sizeof(payload);
+
+      uint16_t assigned = 0;
+      for (uint8_t step = 0; step < sizeof(DISPATCH_STEPS) / sizeof(DISPATCH_STEPS[0]); ++step)
+      {
+        uint16_t target = DISPATCH_STEPS[step];
+        if (target > MAX_CALLBACK_ASSIGNMENTS)
+          break;
+        for (; assigned < target; ++assigned)
+          knx.callback_assign(id, ESPKNXIP::GA_to_address(1 + assigned / 256, 0, assigned % 256));
+
+        // The most recent assignment, the worst case for a linear search
+        telegram.destination = ESPKNXIP::GA_to_address(1 + (assigned - 1) / 256, 0, (assigned - 1) % 256);
+        dispatch_pair("hit", assigned, telegram);
+        telegram.destination = ESPKNXIP::GA_to_address(31, 7, 255);
+        dispatch_pair("miss", assigned, telegram);
+
+        for (uint8_t r = 0; r < sizeof(ROOT_STEPS) / sizeof(ROOT_STEPS[0]); ++r)
+        {
+          if (ROOT_STEPS[r] == assigned)
+            root(assigned);
+        }
+      }
+    }
+
+    /* The whole configuration page, pulled through the chunked response */
+    void root(uint16_t assigned)
+    {
+#ifndef ESP_PLATFORM
+      char name[40];
+      snprintf(name, sizeof(name), "web/root/%u", assigned);
+      bench.run(name, [&](uint32_t n) {
+        for (uint32_t i = 0; i < n; ++i)
+        {
+          AsyncWebServerRequest request(HTTP_GET, ROOT_PREFIX "/");
+          knx.__handle_root(&request);
+          bench_keep(request.response_body);
+        }
+      });
+#else
+      // An AsyncWebServerRequest needs a live TCP client on the target
+#endif
+    }
+
+    ESPKNXIP &knx;
+    Bench &bench;
+    address_t ga;
+};
+
+void Bench::print(Print &out)
+{
+  out.printf("{\"suite\": \"esp-knx-ip\", \"platform\": \"%s\", \"unit\": \"%s\", \"cpu_mhz\": %u,\n",
+             BENCH_PLATFORM, BENCH_UNIT, (unsigned)bench_cpu_mhz());
+  out.printf(" \"max_callback_assignments\": %u, \"results\": [\n", (unsigned)MAX_CALLBACK_ASSIGNMENTS);
+  for (uint8_t i = 0; i < count; ++i)
+  {
+    bench_result_t const &r = results[i];
+    // Operations per second from the fastest batch
+    double per_s = r.per_op > 0 ? bench_ticks_per_ms() * 1000.0 / r.per_op : 0;
+    out.printf("  {\"name\": \"%s\", \"per_op\": %.2f, \"median\": %.2f, \"per_s\": %.0f, \"iterations\": %lu}%s\n",
+               r.name, r.per_op, r.median, per_s, (unsigned long)r.iterations, i + 1 < count ? "," : "");
+  }
+  out.printf("]}\n");
+}
+
+void setup()
+{
+  Serial.begin(115200);
+  delay(1000);
+
+  knx.start(nullptr);
+  knx.physical_address_set(ESPKNXIP::PA_to_address(1, 1, 160));
+
+  // KNX_BENCH_FILTER=<substring> picks benchmarks on the host
+  Bench *bench = new Bench(getenv("KNX_BENCH_FILTER"));
+  KnxBench(knx, *bench).run_all();
+  bench->print(Serial);
+#ifndef ESP_PLATFORM
+  exit(0);
+#endif
+}
+
+void loop()
+{
+  delay(1000);
+}
@@ -0,0 +1,126 @@
+/**
+ * Microbenchmark harness for the esp-knx-ip hot paths
+ * Times on the host are in ns, on the ESP32 in CPU cycles from the cycle counter.
+ * License: MIT
+ */
+
+#ifndef KNX_BENCH_H
+#define KNX_BENCH_H
+
+#include <Arduino.h>
+#include <string.h>
+#ifdef ESP_PLATFORM
+#include <esp_cpu.h>
+#else
+#include <chrono>
+#endif
+
+#define BENCH_MAX_RESULTS  96
+#define BENCH_RUNS         5    // timed batches per benchmark, the fastest one counts
+#define BENCH_BATCH_MS     10   // calibrated length of one batch
+
+#ifdef ESP_PLATFORM
+typedef uint32_t bench_ticks_t;
+static inline bench_ticks_t bench_ticks() { return esp_cpu_get_ccount(); }
+static inline uint32_t bench_ticks_per_ms() { return getCpuFrequencyMhz() * 1000UL; }
+static inline uint32_t bench_cpu_mhz() { return getCpuFrequencyMhz(); }
+#define BENCH_PLATFORM "esp32"
+#define BENCH_UNIT     "cycles"
+#else
+typedef uint64_t bench_ticks_t;
+static inline bench_ticks_t bench_ticks()
+{
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+static inline uint32_t bench_ticks_per_ms() { return 1000000UL; }
+static inline uint32_t bench_cpu_mhz() { return 0; } // not known, and ns do not need it
+#define BENCH_PLATFORM "native"
+#define BENCH_UNIT     "ns"
+#endif
+
+/* Keeps v alive without the cost of a volatile store */
+template <typename T>
+static inline void bench_keep(T const &v)
+{
+  asm volatile("" : : "r"(&v) : "memory");
+}
+
+/* Hides v from the optimiser, so constexpr encoders are not folded away */
+template <typename T>
+static inline T bench_opaque(T v)
+{
+  asm volatile("" : : "r"(&v) : "memory");
+  return v;
+}
+
+typedef struct __bench_result {
+  char name[40];
+  double per_op;   // fastest batch
+  double median;   // median batch
+  uint32_t iterations;
+} bench_result_t;
+
+/*
+ * run(name, fn) calls fn(n), which must do the measured operation n times.
+ * n is doubled until one call takes BENCH_BATCH_MS, then BENCH_RUNS calls
+ * are timed. Benchmarks whose name does not contain the filter are skipped.
+ */
+class Bench
+{
+  public:
+    Bench(const char *filter) : filter(filter), count(0) {}
+
+    template <typename F>
+    void run(const char *name, F fn)
+    {
+      if (filter != nullptr && strstr(name, filter) == nullptr)
+        return;
+      if (count == BENCH_MAX_RESULTS)
+        return;
+
+      bench_ticks_t target = (bench_ticks_t)bench_ticks_per_ms() * BENCH_BATCH_MS;
+      uint32_t n = 1;
+      while (n < (1UL << 30) && __time(fn, n) < target)
+        n *= 2;
+
+      double runs[BENCH_RUNS];
+      for (uint8_t r = 0; r < BENCH_RUNS; ++r)
+      {
+        runs[r] = (double)__time(fn, n) / n;
+        yield();
+      }
+      // Insertion sort, BENCH_RUNS is tiny
+      for (uint8_t i = 1; i < BENCH_RUNS; ++i)
+        for (uint8_t j = i; j > 0 && runs[j] < runs[j - 1]; --j)
+        {
+          double t = runs[j];
+          runs[j] = runs[j - 1];
+          runs[j - 1] = t;
+        }
+
+      bench_result_t &res = results[count++];
+      strncpy(res.name, name, sizeof(res.name) - 1);
+      res.name[sizeof(res.name) - 1] = '\0';
+      res.per_op = runs[0];
+      res.median = runs[BENCH_RUNS / 2];
+      res.iterations = n;
+    }
+
+    /* One JSON document, one result per line */
+    void print(Print &out);
+
+  private:
+    template <typename F>
+    bench_ticks_t __time(F &fn, uint32_t n)
+    {
+      bench_ticks_t start = bench_ticks();
+      fn(n);
+      return (bench_ticks_t)(bench_ticks() - start);
+    }
+
+    const char *filter;
+    uint8_t count;
+    bench_result_t results[BENCH_MAX_RESULTS];
+};
+
+#endif
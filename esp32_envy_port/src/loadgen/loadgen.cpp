@@ -0,0 +1,587 @@
+/**
+ * Routing load generator and throughput harness for the esp-knx-ip receive path
+ * Floods the routing multicast group on loopback while the library receives in
+ * the same process, and matches every telegram a callback sees to the one sent,
+ * for loss, latency percentiles and the highest rate without loss.
+ * Host only: build with the loadgen-native env, run with --help for the options.
+ * License: MIT
+ */
+
+#ifdef ESP_PLATFORM
+#error "the load generator runs on the host, against the native build"
+#endif
+
+#include <Arduino.h>
+#include <ESPAsyncWebServer.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+#include "esp-knx-ip.h"
+
+/*
+ * Every telegram carries its sequence number in the source address, so the
+ * receiving callback can look up when it was sent whatever its payload is.
+ * This holds as long as fewer than 65536 telegrams are in flight.
+ */
+#define SEQ_SLOTS         65536
+#define DRAIN_IDLE_MS     100    // a step is over once nothing arrived for this long
+#define DRAIN_MAX_MS      2000
+#define GA_AREA           10     // telegrams go to 10/0/0 upwards
+
+typedef std::chrono::steady_clock clock_type;
+
+static uint64_t now_ns()
+{
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(clock_type::now().time_since_epoch()).count();
+}
+
+typedef enum __ga_dist {
+  GA_UNIFORM,
+  GA_ZIPF,     // GA i is picked with weight 1 / (i + 1), so a few are hot
+  GA_ROUND_ROBIN,
+} ga_dist_t;
+
+typedef enum __dpt_kind {
+  KIND_SWITCH,  // DPT 1, payload in the APCI byte
+  KIND_SCALING, // DPT 5.001
+  KIND_FLOAT,   // DPT 9
+  KIND_COUNTER, // DPT 13
+  KIND_STRING,  // DPT 16, the longest group telegram
+  KIND_COUNT,
+} dpt_kind_t;
+
+static const char *const KIND_NAMES[KIND_COUNT] = {"switch", "scaling", "float", "counter", "string"};
+
+typedef struct __options {
+  uint32_t rate;          // telegrams per second, or the first step of a sweep
+  uint32_t rate_to;       // last step of a sweep, 0 for a single run
+  uint32_t rate_step;
+  uint32_t seconds;       // per step
+  uint16_t gas;
+  ga_dist_t dist;
+  uint32_t mix[KIND_COUNT];
+  uint32_t burst;         // telegrams sent back to back; bursts are spaced to keep the rate
+  double max_loss;        // percent a step may lose and still count as sustained
+  bool rx_task;
+  bool blocking_loop;     // the loop before the receive task: inline receive, HTTP served in it, delay(10)
+  uint16_t budget_packets;
+  uint32_t http_rps;      // concurrent requests per second to the web UI, 0 for none
+} options_t;
+
+typedef struct __step_result {
+  uint32_t rate;
+  uint32_t sent;
+  uint32_t received;
+  uint32_t unmatched;     // arrived with a sequence number that was not in flight
+  double achieved;        // telegrams per second really sent
+  double p50_us, p90_us, p99_us, max_us;
+  uint32_t ring_full;     // times a frame waited in the socket because the receive ring was full
+  uint32_t http_requests;
+} step_result_t;
+
+static ESPKNXIP knx_rx;
+static AsyncWebServer server(80);
+
+static std::atomic<uint64_t> sent_at[SEQ_SLOTS];
+static std::atomic<uint32_t> received;
+static std::atomic<uint32_t> unmatched;
+static std::atomic<uint32_t> http_requests;
+static std::atomic<uint32_t> http_waiting;  // requests the blocking loop has yet to serve
+static std::atomic<bool> done;
+static std::atomic<bool> http_run;
+
+// Written by the callback on the loop thread, read by the controller between steps
+static std::vector<uint32_t> latencies_ns;
+static knx_lock_t latencies_lock;
+
+static void received_cb(message_t const &msg, void * /* arg */)
+{
+  uint64_t now = now_ns();
+  uint64_t at = sent_at[msg.source.value].exchange(0, std::memory_order_acq_rel);
+  if (at == 0)
+  {
+    unmatched++;
+    return;
+  }
+  received++;
+  knx_lock_take(&latencies_lock);
+  latencies_ns.push_back((uint32_t)std::min<uint64_t>(now - at, UINT32_MAX));
+  knx_lock_give(&latencies_lock);
+}
+
+/* xorshift32, cheap enough to not show up next to sendto() */
+class Rng
+{
+  public:
+    Rng(uint32_t seed) : s(seed ? seed : 1) {}
+    uint32_t next()
+    {
+      s ^= s << 13;
+      s ^= s >> 17;
+      s ^= s << 5;
+      return s;
+    }
+    /* [0, n) from a cumulative weight table */
+    size_t pick(std::vector<double> const &cdf)
+    {
+      double r = (next() / 4294967296.0) * cdf.back();
+      return std::upper_bound(cdf.begin(), cdf.end(), r) - cdf.begin();
+    }
+
+  private:
+    uint32_t s;
+};
+
+/* Multicast sender of its own, so the library socket only ever receives */
+class RoutingSender
+{
+  public:
+    bool open()
+    {
+      fd = socket(AF_INET, SOCK_DGRAM, 0);
+      if (fd < 0)
+        return false;
+      // Same interface choice as the WiFiUDP shim, loopback unless KNX_HOST_IF says otherwise
+      struct in_addr ifaddr = {};
+      const char *iface = getenv("KNX_HOST_IF");
+      if (iface == nullptr || inet_pton(AF_INET, iface, &ifaddr) != 1)
+        ifaddr.s_addr = htonl(INADDR_LOOPBACK);
+      setsockopt(fd, IPPROTO_IP, IP_MULTICAST_IF, &ifaddr, sizeof(ifaddr));
+      unsigned char loop = 1;
+      setsockopt(fd, IPPROTO_IP, IP_MULTICAST_LOOP, &loop, sizeof(loop));
+      int sndbuf = 1 << 20;
+      setsockopt(fd, SOL_SOCKET, SO_SNDBUF, &sndbuf, sizeof(sndbuf));
+
+      dest = {};
+      dest.sin_family = AF_INET;
+      dest.sin_port = htons(MULTICAST_PORT);
+      dest.sin_addr.s_addr = (uint32_t)MULTICAST_IP;
+      return true;
+    }
+
+    bool send(const uint8_t *frame, size_t len)
+    {
+      return sendto(fd, frame, len, 0, (struct sockaddr *)&dest, sizeof(dest)) == (ssize_t)len;
+    }
+
+  private:
+    int fd = -1;
+    struct sockaddr_in dest;
+};
+
+template <size_t N>
+static size_t copy_payload(dpt_bytes_t<N> const &p, uint8_t *data)
+{
+  memcpy(data, p.data, N);
+  return N;
+}
+
+static size_t encode_payload(dpt_kind_t kind, uint32_t seq, uint8_t *data)
+{
+  switch (kind)
+  {
+    case KIND_SWITCH:  return copy_payload(Dpt<1>::encode(seq & 1), data);
+    case KIND_SCALING: return copy_payload(Dpt<5>::encode((uint8_t)seq), data);
+    case KIND_FLOAT:   return copy_payload(Dpt<9>::encode((float)(seq % 4000) / 100.0f), data);
+    case KIND_COUNTER: return copy_payload(Dpt<13>::encode((int32_t)seq), data);
+    default:
+    {
+      char s[15];
+      snprintf(s, sizeof(s), "seq %lu", (unsigned long)seq);
+      return copy_payload(Dpt<16>::encode(s), data);
+    }
+  }
+}
+
+static double percentile(std::vector<uint32_t> const &sorted, double p)
+{
+  if (sorted.empty())
+    return 0;
+  size_t i = (size_t)(p / 100.0 * (sorted.size() - 1) + 0.5);
+  return sorted[i] / 1000.0;
+}
+
+class LoadGen
+{
+  public:
+    LoadGen(options_t const &opt) : opt(opt), rng(0x4b4e58)
+    {
+      for (uint16_t i = 0; i < opt.gas; ++i)
+      {
+        double w = opt.dist == GA_ZIPF ? 1.0 / (i + 1) : 1.0;
+        ga_cdf.push_back((ga_cdf.empty() ? 0 : ga_cdf.back()) + w);
+      }
+      for (uint8_t k = 0; k < KIND_COUNT; ++k)
+        kind_cdf.push_back((kind_cdf.empty() ? 0 : kind_cdf.back()) + opt.mix[k]);
+    }
+
+    bool open() { return sender.open(); }
+
+    step_result_t step(uint32_t rate)
+    {
+      step_result_t res = {};
+      res.rate = rate;
+      received = 0;
+      unmatched = 0;
+      http_requests = 0;
+      knx_lock_take(&latencies_lock);
+      latencies_ns.clear();
+      knx_lock_give(&latencies_lock);
+      uint32_t ring_full = knx_rx.rx_task_stats().ring_full;
+
+      uint64_t gap = (uint64_t)opt.burst * 1000000000ULL / rate;
+      uint64_t start = now_ns();
+      uint64_t end = start + (uint64_t)opt.seconds * 1000000000ULL;
+      uint64_t next = start;
+      uint8_t frame[KNX_FRAME_HEADER_LEN + 15];
+      uint8_t data[15];
+      while (next < end)
+      {
+        std::this_thread::sleep_until(clock_type::time_point(std::chrono::nanoseconds(next)));
+        // A late wakeup sends the bursts it missed right away, so the average rate holds
+        for (uint32_t b = 0; b < opt.burst; ++b)
+        {
+          uint16_t ga = opt.dist == GA_ROUND_ROBIN ? seq % opt.gas : rng.pick(ga_cdf);
+          dpt_kind_t kind = (dpt_kind_t)rng.pick(kind_cdf);
+          size_t data_len = encode_payload(kind, seq, data);
+          address_t src;
+          src.value = (uint16_t)seq;
+          address_t dst = ESPKNXIP::GA_to_address(GA_AREA, ga >> 8, ga & 0xFF);
+          size_t len = knx_frame_encode(frame, src, dst, KNX_CT_WRITE, data, data_len);
+
+          sent_at[(uint16_t)seq].store(now_ns(), std::memory_order_release);
+          if (sender.send(frame, len))
+            res.sent++;
+          else
+            sent_at[(uint16_t)seq].store(0, std::memory_order_relaxed);
+          seq++;
+        }
+        next += gap;
+      }
+      res.achieved = res.sent / ((now_ns() - start) / 1e9);
+
+      // Wait for the tail to come through
+      uint32_t last = received;
+      uint64_t idle_since = now_ns();
+      uint64_t drain_end = idle_since + DRAIN_MAX_MS * 1000000ULL;
+      while (received < res.sent && now_ns() < drain_end && now_ns() - idle_since < DRAIN_IDLE_MS * 1000000ULL)
+      {
+        delay(5);
+        if (received != last)
+        {
+          last = received;
+          idle_since = now_ns();
+        }
+      }
+      // Whatever is still in flight now counts as lost
+      for (uint32_t i = 0; i < SEQ_SLOTS; ++i)
+        sent_at[i].store(0, std::memory_order_relaxed);
+
+      res.received = received;
+      res.unmatched = unmatched;
+      res.ring_full = knx_rx.rx_task_stats().ring_full - ring_full;
+      res.http_requests = http_requests;
+      knx_lock_take(&latencies_lock);
+      std::vector<uint32_t> lat;
+      lat.swap(latencies_ns);
+      knx_lock_give(&latencies_lock);
+      std::sort(lat.begin(), lat.end());
+      res.p50_us = percentile(lat, 50);
+      res.p90_us = percentile(lat, 90);
+      res.p99_us = percentile(lat, 99);
+      res.max_us = percentile(lat, 100);
+      return res;
+    }
+
+  private:
+    options_t const &opt;
+    Rng rng;
+    RoutingSender sender;
+    std::vector<double> ga_cdf;
+    std::vector<double> kind_cdf;
+    uint32_t seq = 0;
+};
+
+static const char *const http_urls[] = {__ROOT_PATH, __API_PATH};
+
+static void http_serve(uint32_t i)
+{
+  AsyncWebServerRequest request(HTTP_GET, http_urls[i % 2]);
+  server.handle(request);
+  http_requests++;
+}
+
+/* Requests the pages a browser would keep loading, on a thread of their own like AsyncTCP,
+   or hands them to the loop when it serves them itself like WebServer::handleClient() */
+static void http_load(uint32_t rps, bool blocking_loop)
+{
+  uint64_t gap = 1000000000ULL / rps;
+  uint64_t next = now_ns();
+  for (uint32_t i = 0; http_run; ++i)
+  {
+    std::this_thread::sleep_until(clock_type::time_point(std::chrono::nanoseconds(next)));
+    if (blocking_loop)
+      http_waiting++;
+    else
+      http_serve(i);
+    next += gap;
+  }
+}
+
+static double loss_pct(step_result_t const &r)
+{
+  return r.sent ? 100.0 * (r.sent - r.received) / r.sent : 0;
+}
+
+static bool sustained(options_t const &opt, step_result_t const &r)
+{
+  // The generator has to keep up too, or the step says nothing about the receiver
+  return loss_pct(r) <= opt.max_loss && r.achieved >= 0.95 * r.rate;
+}
+
+static void print_step(step_result_t const &r)
+{
+  fprintf(stderr, "rate %7lu/s  sent %8lu  recv %8lu  loss %6.2f%%  p50 %8.1f  p99 %8.1f  max %9.1f us  ring_full %lu\n",
+          (unsigned long)r.rate, (unsigned long)r.sent, (unsigned long)r.received, loss_pct(r),
+          r.p50_us, r.p99_us, r.max_us, (unsigned long)r.ring_full);
+}
+
+static void print_json(options_t const &opt, std::vector<step_result_t> const &steps, uint32_t max_rate)
+{
+  printf("{\"suite\": \"esp-knx-ip-loadgen\", \"rx_task\": %s, \"blocking_loop\": %s, \"gas\": %u, \"ga_dist\": \"%s\", \"burst\": %lu, "
+         "\"http_rps\": %lu, \"seconds\": %lu, \"mix\": {",
+         opt.rx_task ? "true" : "false", opt.blocking_loop ? "true" : "false", opt.gas,
+         opt.dist == GA_ZIPF ? "zipf" : opt.dist == GA_ROUND_ROBIN ? "round-robin" : "uniform",
+         (unsigned long)opt.burst, (unsigned long)opt.http_rps, (unsigned long)opt.seconds);
+  for (uint8_t k = 0; k < KIND_COUNT; ++k)
+    printf("%s\"%s\": %lu", k ? ", " : "", KIND_NAMES[k], (unsigned long)opt.mix[k]);
+  printf("},\n \"steps\": [\n");
+  for (size_t i = 0; i < steps.size(); ++i)
+  {
+    step_result_t const &r = steps[i];
+    printf("  {\"rate\": %lu, \"sent\": %lu, \"received\": %lu, \"unmatched\": %lu, \"loss_pct\": %.3f, "
+           "\"achieved\": %.1f, \"p50_us\": %.1f, \"p90_us\": %.1f, \"p99_us\": %.1f, \"max_us\": %.1f, "
+           "\"ring_full\": %lu, \"http_requests\": %lu}%s\n",
+           (unsigned long)r.rate, (unsigned long)r.sent, (unsigned long)r.received, (unsigned long)r.unmatched,
+           loss_pct(r), r.achieved, r.p50_us, r.p90_us, r.p99_us, r.max_us,
+           (unsigned long)r.ring_full, (unsigned long)r.http_requests, i + 1 < steps.size() ? "," : "");
+  }
+  printf(" ],\n \"max_sustained_rate\": %lu}\n", (unsigned long)max_rate);
+}
+
+static void usage()
+{
+  fprintf(stderr,
+          "usage: program [options]\n"
+          "  --rate N          telegrams per second (default 1000)\n"
+          "  --sweep A:B:S     step the rate from A to B by S, stopping at the first step that is not sustained\n"
+          "  --seconds N       length of each step (default 5)\n"
+          "  --gas N           group addresses, 10/0/0 upwards (default 64, at most MAX_CALLBACK_ASSIGNMENTS)\n"
+          "  --ga-dist D       uniform, zipf or round-robin (default uniform)\n"
+          "  --mix M           DPT weights, e.g. switch:4,scaling:1,float:3,counter:1,string:1 (default)\n"
+          "  --burst N         send N telegrams back to back, bursts spaced to keep the rate (default 1)\n"
+          "  --max-loss P      percent lost that still counts as sustained (default 0)\n"
+          "  --inline          receive in loop() instead of the receive task\n"
+          "  --budget N        datagrams per loop() pass without the receive task (default %u)\n"
+          "  --blocking-loop   the loop before the receive task: --inline, one web request served\n"
+          "                    per pass and delay(10) instead of wait()\n"
+          "  --http-rps N      concurrent web UI requests per second (default 0)\n"
+          "Progress goes to stderr, the JSON result to stdout.\n",
+          RX_BUDGET_PACKETS);
+  exit(2);
+}
+
+static bool parse_mix(const char *s, uint32_t *mix)
+{
+  memset(mix, 0, KIND_COUNT * sizeof(*mix));
+  std::string all(s);
+  size_t pos = 0;
+  while (pos < all.size())
+  {
+    size_t comma = all.find(',', pos);
+    std::string item = all.substr(pos, comma == std::string::npos ? std::string::npos : comma - pos);
+    size_t colon = item.find(':');
+    std::string name = item.substr(0, colon);
+    uint32_t weight = colon == std::string::npos ? 1 : strtoul(item.c_str() + colon + 1, nullptr, 10);
+    uint8_t k = 0;
+    while (k < KIND_COUNT && name != KIND_NAMES[k])
+      k++;
+    if (k == KIND_COUNT)
+      return false;
+    mix[k] = weight;
+    if (comma == std::string::npos)
+      break;
+    pos = comma + 1;
+  }
+  for (uint8_t k = 0; k < KIND_COUNT; ++k)
+    if (mix[k] > 0)
+      return true;
+  return false;
+}
+
+static void parse_options(int argc, char **argv, options_t &opt)
+{
+  opt = {};
+  opt.rate = 1000;
+  opt.seconds = 5;
+  opt.gas = 64;
+  opt.dist = GA_UNIFORM;
+  parse_mix("switch:4,scaling:1,float:3,counter:1,string:1", opt.mix);
+  opt.burst = 1;
+  opt.rx_task = true;
+  opt.budget_packets = RX_BUDGET_PACKETS;
+
+  for (int i = 1; i < argc; ++i)
+  {
+    const char *arg = argv[i];
+    const char *val = i + 1 < argc ? argv[i + 1] : nullptr;
+    if (strcmp(arg, "--inline") == 0)
+    {
+      opt.rx_task = false;
+      continue;
+    }
+    if (strcmp(arg, "--blocking-loop") == 0)
+    {
+      opt.rx_task = false;
+      opt.blocking_loop = true;
+      continue;
+    }
+    if (val == nullptr)
+      usage();
+    i++;
+    if (strcmp(arg, "--rate") == 0)
+      opt.rate = strtoul(val, nullptr, 10);
+    else if (strcmp(arg, "--sweep") == 0)
+    {
+      unsigned long a, b, s;
+      if (sscanf(val, "%lu:%lu:%lu", &a, &b, &s) != 3 || s == 0 || b < a)
+        usage();
+      opt.rate = a;
+      opt.rate_to = b;
+      opt.rate_step = s;
+    }
+    else if (strcmp(arg, "--seconds") == 0)
+      opt.seconds = strtoul(val, nullptr, 10);
+    else if (strcmp(arg, "--gas") == 0)
+      opt.gas = strtoul(val, nullptr, 10);
+    else if (strcmp(arg, "--ga-dist") == 0)
+    {
+      if (strcmp(val, "uniform") == 0)
+        opt.dist = GA_UNIFORM;
+      else if (strcmp(val, "zipf") == 0)
+        opt.dist = GA_ZIPF;
+      else if (strcmp(val, "round-robin") == 0)
+        opt.dist = GA_ROUND_ROBIN;
+      else
+        usage();
+    }
+    else if (strcmp(arg, "--mix") == 0)
+    {
+      if (!parse_mix(val, opt.mix))
+        usage();
+    }
+    else if (strcmp(arg, "--burst") == 0)
+      opt.burst = strtoul(val, nullptr, 10);
+    else if (strcmp(arg, "--max-loss") == 0)
+      opt.max_loss = strtod(val, nullptr);
+    else if (strcmp(arg, "--budget") == 0)
+      opt.budget_packets = strtoul(val, nullptr, 10);
+    else if (strcmp(arg, "--http-rps") == 0)
+      opt.http_rps = strtoul(val, nullptr, 10);
+    else
+      usage();
+  }
+  if (opt.rate == 0 || opt.seconds == 0 || opt.gas == 0 || opt.burst == 0)
+    usage();
+  if (opt.gas > MAX_CALLBACK_ASSIGNMENTS)
+  {
+    fprintf(stderr, "--gas %u is over MAX_CALLBACK_ASSIGNMENTS, using %u\n", opt.gas, MAX_CALLBACK_ASSIGNMENTS);
+    opt.gas = MAX_CALLBACK_ASSIGNMENTS;
+  }
+}
+
+int main(int argc, char **argv)
+{
+  options_t opt;
+  parse_options(argc, argv, opt);
+  knx_lock_init(&latencies_lock);
+
+  knx_rx.physical_address_set(ESPKNXIP::PA_to_address(15, 15, 255));
+  callback_id_t id = knx_rx.callback_register("Load", received_cb);
+  for (uint16_t i = 0; i < opt.gas; ++i)
+    knx_rx.callback_assign(id, ESPKNXIP::GA_to_address(GA_AREA, i >> 8, i & 0xFF));
+  knx_rx.rx_budget_set(opt.budget_packets, RX_BUDGET_US);
+  knx_rx.start(&server);
+  if (opt.rx_task && !knx_rx.rx_task_start())
+  {
+    fprintf(stderr, "receive task did not start\n");
+    return 1;
+  }
+
+  LoadGen gen(opt);
+  if (!gen.open())
+  {
+    perror("socket");
+    return 1;
+  }
+
+  std::thread http;
+  if (opt.http_rps > 0)
+  {
+    http_run = true;
+    http = std::thread(http_load, opt.http_rps, opt.blocking_loop);
+  }
+
+  std::vector<step_result_t> steps;
+  uint32_t max_rate = 0;
+  std::thread controller([&]() {
+    uint32_t last = opt.rate_to ? opt.rate_to : opt.rate;
+    for (uint32_t rate = opt.rate; rate <= last; rate += opt.rate_to ? opt.rate_step : last)
+    {
+      step_result_t r = gen.step(rate);
+      steps.push_back(r);
+      print_step(r);
+      if (!sustained(opt, r))
+        break;
+      max_rate = rate;
+    }
+    done = true;
+  });
+
+  // The application loop before the receive task: receive, one handleClient(), delay(10)
+  for (uint32_t i = 0; opt.blocking_loop && !done; ++i)
+  {
+    knx_rx.loop();
+    if (http_waiting > 0)
+    {
+      http_waiting--;
+      http_serve(i);
+    }
+    delay(10);
+  }
+
+  // The application loop, as in src/main.cpp
+  while (!done)
+  {
+    rx_pass_t rx = knx_rx.loop();
+    if (rx.left_over == 0)
+      knx_rx.wait(10);
+  }
+
+  controller.join();
+  http_run = false;
+  if (http.joinable())
+    http.join();
+  print_json(opt, steps, max_rate);
+  return 0;
+}
@@ -1,87 +1,84 @@
 #include <WiFi.h>
-#include <WebServer.h>
+#include <ESPAsyncWebServer.h>
 #include <esp_log.h>
+#include <LittleFS.h>
 #include "esp-knx-ip.h"
+#include "monitor-assets.h"
 #include <Arduino.h>
 
 // Replace with your Wi‑Fi network credentials
 const char* ssid = "ssid";
 const char* password = "password";
 
-// Create a separate WebServer just for monitoring
-WebServer monitorServer(80);
+// One server for the monitor page and the KNX pages below ROOT_PREFIX.
+// It runs in the AsyncTCP task, so requests never wait for loop().
+AsyncWebServer server(80);
 
 // Group address to send to
 address_t groupAddr;
 
-// Buffer for storing recent messages
-const int MAX_MESSAGES = 10;
-String recentMessages[MAX_MESSAGES];
-int messageIndex = 0;
+// Our physical address, recorded as the source of what we send
+address_t physAddr;
+
+// Recent telegrams, kept raw in MONITOR_HISTORY_SIZE * 24 bytes of static RAM
+// and only turned into text when someone asks for /messages
+#ifndef MONITOR_HISTORY_SIZE
+#define MONITOR_HISTORY_SIZE 1024
+#endif
+KnxHistory<MONITOR_HISTORY_SIZE> history;
+
+// Temperatures requested on /send. Handlers run in the AsyncTCP task, so they
+// only queue the value here and loop() sends it.
+SpscRing<float, 4> sendRequests;
 
 // Timer for periodic sending
 unsigned long lastSendTime = 0;
 const unsigned long sendInterval = 10000; // 10 seconds
 
-// Function declaration - needs to be before it's called
-void addMessage(String message);
-
-void handleRoot() {
-  String html = "<html><head><meta charset='utf-8'>";
-  html += "<meta name='viewport' content='width=device-width, initial-scale=1'>";
-  html += "<title>ESP32 KNX Monitor</title>";
-  html += "<style>body{font-family:Arial;margin:20px}";
-  html += ".message{border:1px solid #ddd;padding:10px;margin:5px 0;border-radius:4px}";
-  html += ".controls{margin:20px 0}</style>";
-  html += "<script>function refreshPage(){window.location.reload()}</script>";
-  html += "</head><body>";
-  html += "<h1>ESP32 KNX Monitor</h1>";
-  
-  // Messages section
-  html += "<h2>Recent KNX Messages</h2>";
-  html += "<div class='messages'>";
-  for (int i = 0; i < MAX_MESSAGES; i++) {
-    int idx = (messageIndex - 1 - i + MAX_MESSAGES) % MAX_MESSAGES;
-    if (recentMessages[idx].length() > 0) {
-      html += "<div class='message'>" + recentMessages[idx] + "</div>";
-    }
-  }
-  html += "</div>";
-  
-  // Controls section
-  html += "<div class='controls'>";
-  html += "<form action='/send' method='get'>";
-  html += "Send temperature: <input type='number' name='temp' min='0' max='40' step='0.5' value='21.5'>";
-  html += "<input type='submit' value='Send'>";
-  html += "</form>";
-  html += "<button onclick='refreshPage()'>Refresh</button>";
-  html += "</div>";
-  
-  html += "</body></html>";
-  
-  monitorServer.send(200, "text/html", html);
+// Called from setup() and loop() only: the history has a single writer
+void sendTemperature(float temp) {
+  dpt_bytes_t<Dpt<9>::size> payload = Dpt<9>::encode(temp);
+  knx.send(groupAddr, KNX_CT_WRITE, Dpt<9>::size, payload.data);
+  history.push(millis(), physAddr, groupAddr, KNX_CT_WRITE, payload.data, Dpt<9>::size, true);
 }
 
-void handleSend() {
-  if (monitorServer.hasArg("temp")) {
-    float temp = monitorServer.arg("temp").toFloat();
-    knx.send_2byte_float(groupAddr, KNX_CT_WRITE, temp);
-    
-    String message = "Sent temperature: " + String(temp, 1) + "°C to 10/6/5";
-    addMessage(message);
-    Serial.println(message);
-    
-    monitorServer.sendHeader("Location", "/");
-    monitorServer.send(302);
-  } else {
-    monitorServer.send(400, "text/plain", "Missing temperature parameter");
-  }
+// The page is static; it fetches the history from here, newest first, one line per
+// telegram, and then follows new telegrams on the library's WebSocket stream.
+// Lines are formatted chunk by chunk straight into the response buffer.
+void handleMessages(AsyncWebServerRequest *request) {
+  uint32_t next = history.seq();
+  AsyncWebServerResponse *response = request->beginChunkedResponse("text/plain; charset=utf-8",
+    [next](uint8_t *buf, size_t maxLen, size_t /* index */) mutable -> size_t {
+      size_t len = 0;
+      history_entry_t entry;
+      // Stops at the oldest entry, or early if the writer has overwritten the rest meanwhile
+      while (next > 0 && history.get(next - 1, entry)) {
+        size_t n = knx_history_format(entry, (char *)buf + len, maxLen - len);
+        if (n == 0)
+          break;
+        len += n;
+        next--;
+      }
+      return len;
+    });
+  response->addHeader("Cache-Control", "no-store");
+  request->send(response);
 }
 
-// Function implementation
-void addMessage(String message) {
-  recentMessages[messageIndex] = message;
-  messageIndex = (messageIndex + 1) % MAX_MESSAGES;
+void handleSend(AsyncWebServerRequest *request) {
+  if (request->hasParam("temp")) {
+    float *slot = sendRequests.reserve();
+    if (slot == nullptr) {
+      request->send(503, "text/plain", "Busy, try again");
+      return;
+    }
+    *slot = request->getParam("temp")->value().toFloat();
+    sendRequests.commit();
+    knx.wake();
+    request->redirect("/");
+  } else {
+    request->send(400, "text/plain", "Missing temperature parameter");
+  }
 }
 
 void setup() {
@@ -103,32 +100,33 @@ void setup() {
   Serial.println(WiFi.localIP());
 
   // Set the originating physical address to 1.1.160
-  address_t pa;
-  pa.bytes.high = (1 << 4) | 1; // area=1, line=1 → 0x11
-  pa.bytes.low = 160;           // member = 160
-  knx.physical_address_set(pa);
-  
-  // Setup simple web monitor
-  monitorServer.on("/", handleRoot);
-  monitorServer.on("/send", handleSend);
-  monitorServer.begin();
+  physAddr.bytes.high = (1 << 4) | 1; // area=1, line=1 → 0x11
+  physAddr.bytes.low = 160;           // member = 160
+  knx.physical_address_set(physAddr);
+
+  // Start KNX with its web interface below ROOT_PREFIX (see platformio.ini)
+  knx.start(&server);
+  // Receive on a task of its own, which also lets loop() sleep until a telegram arrives
+  knx.rx_task_start();
+  // Record the whole bus to flash for post-mortems, downloadable at /knx/capture
+  if (LittleFS.begin(true))
+    knx.capture_start(LittleFS);
+  else
+    Serial.println("LittleFS not mounted, bus capture disabled");
+
+  // Setup simple web monitor next to it
+  for (size_t i = 0; i < MONITOR_ASSET_COUNT; i++) {
+    server.on(monitor_assets[i].path, HTTP_GET, [i](AsyncWebServerRequest *request) { knx_asset_send(request, monitor_assets[i]); });
+  }
+  server.on("/messages", HTTP_GET, handleMessages);
+  server.on("/send", HTTP_GET, handleSend);
+  server.begin();
   Serial.println("Web monitor started");
-  
-  // Start KNX without built-in web interface
-  knx.start(nullptr);
-
-  // Register a callback to monitor messages on the bus
-  knx.callback_register("Monitor", [](message_t const &msg, void *arg) {
-    String message = "Received KNX message from ";
-    message += String(msg.received_on.ga.area) + "/" + String(msg.received_on.ga.line) + "/" + String(msg.received_on.ga.member);
-    message += ", CT=0x" + String(msg.ct, HEX) + ", Data:";
-    
-    for (uint8_t i = 0; i < msg.data_len; i++) {
-      message += " 0x" + String(msg.data[i], HEX);
-    }
-    
-    addMessage(message);
-    Serial.println(message);
+
+  // Register a callback to monitor messages on the bus. It only copies the raw
+  // telegram; nothing is formatted unless the history is requested.
+  knx.callback_register("Monitor", [](message_t const &msg, void * /* arg */) {
+    history.push(millis(), msg.source, msg.received_on, msg.ct, msg.data, msg.data_len, false);
   }, nullptr);
 
   // Build the target group address "10/6/5"
@@ -137,19 +135,23 @@ void setup() {
   groupAddr.ga.member = 5;
 
   // Initial send
-  knx.send_2byte_float(groupAddr, KNX_CT_WRITE, 21.5f);
-  addMessage("Sent temperature command: 21.5°C to group 10/6/5");
+  sendTemperature(21.5f);
   Serial.println("Sent temperature command: 21.5°C to group 10/6/5");
   lastSendTime = millis();
 }
 
 void loop() {
-  // Process KNX messages
-  knx.loop();
-  
-  // Handle web server requests
-  monitorServer.handleClient();
-  
-  // Add a small delay
-  delay(10);
+  // Process KNX messages; the web server needs no polling
+  rx_pass_t rx = knx.loop();
+
+  float *temp;
+  while ((temp = sendRequests.front()) != nullptr) {
+    sendTemperature(*temp);
+    sendRequests.pop();
+  }
+
+  // Sleep until a telegram comes in or a queued frame is due, unless a burst
+  // is still waiting in the receive ring. There is no fixed delay any more.
+  if (rx.left_over == 0)
+    knx.wait(1000);
 }
\ No newline at end of file
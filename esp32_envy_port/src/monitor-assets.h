@@ -0,0 +1,94 @@
+/**
+ * esp-knx-ip library for KNX/IP communication on an ESP32
+ * Static web assets of the monitor page, generated by scripts/gen_assets.py. Do not edit.
+ * License: MIT
+ */
+
+#ifndef MONITOR_ASSETS_H
+#define MONITOR_ASSETS_H
+
+#include "esp-knx-ip-asset.h"
+
+// index.html: 2044 bytes, 1124 gzipped
+#define MONITOR_ASSET_INDEX_HTML_VERSION "ef76d6b0e7853970"
+static const uint8_t monitor_asset_index_html[] PROGMEM = {
+  0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0x6d, 0x55, 0xdb, 0x8e, 0xdb, 0x36,
+  0x10, 0x7d, 0xf7, 0x57, 0x30, 0x2e, 0x60, 0x91, 0xb0, 0x57, 0xb2, 0xbc, 0xde, 0x24, 0xb5, 0x25,
+  0x05, 0xc9, 0x66, 0x0b, 0x14, 0x45, 0x2e, 0x88, 0xb7, 0x4d, 0x0a, 0x14, 0x28, 0x68, 0x71, 0xbc,
+  0x22, 0x2c, 0x91, 0x02, 0x49, 0xdf, 0x60, 0xf8, 0xdf, 0x3b, 0x94, 0x7c, 0x0d, 0xfa, 0x20, 0x90,
+  0x9a, 0x39, 0x73, 0xe6, 0x4a, 0x32, 0x79, 0xf5, 0xf1, 0xcb, 0xe3, 0xf3, 0xdf, 0x5f, 0x9f, 0x48,
+  0xe1, 0xaa, 0x32, 0xeb, 0x24, 0xcd, 0x92, 0x14, 0xc0, 0x45, 0x96, 0x54, 0xe0, 0x38, 0xc9, 0x0b,
+  0x6e, 0x2c, 0xb8, 0xb4, 0xbb, 0x72, 0x8b, 0xbb, 0xb7, 0x5d, 0x84, 0x34, 0x62, 0xc5, 0x2b, 0x48,
+  0xbb, 0x6b, 0x09, 0x9b, 0x5a, 0x1b, 0xd7, 0x25, 0xb9, 0x56, 0x0e, 0x14, 0xc2, 0x36, 0x52, 0xb8,
+  0x22, 0x15, 0xb0, 0x96, 0x39, 0xdc, 0x35, 0x3f, 0x03, 0x22, 0x95, 0x74, 0x92, 0x97, 0x77, 0x36,
+  0xe7, 0x25, 0xa4, 0xb1, 0x27, 0x71, 0xd2, 0x95, 0x90, 0x3d, 0xcd, 0xbe, 0xde, 0x8f, 0xc8, 0x1f,
+  0x9f, 0x7f, 0x90, 0x4f, 0x1a, 0x31, 0xda, 0x24, 0x51, 0xab, 0xe8, 0x24, 0xd6, 0xed, 0x70, 0x9d,
+  0x6b, 0xb1, 0xdb, 0x2f, 0x90, 0xfb, 0x6e, 0xc1, 0x2b, 0x59, 0xee, 0x26, 0xef, 0x0d, 0x12, 0x4d,
+  0x2b, 0x6e, 0x5e, 0xa4, 0x9a, 0x8c, 0x86, 0xf5, 0xf6, 0x10, 0x56, 0x60, 0x2d, 0x7f, 0x81, 0xfd,
+  0x5c, 0x1b, 0x01, 0x66, 0x12, 0xd7, 0x5b, 0x62, 0x75, 0x29, 0x05, 0xf9, 0x45, 0x08, 0x31, 0xad,
+  0xb9, 0x10, 0x52, 0xbd, 0x4c, 0x62, 0xc4, 0x9e, 0xec, 0x1e, 0x10, 0x32, 0x9c, 0xb6, 0xf8, 0x3b,
+  0xc3, 0x85, 0x5c, 0xd9, 0xc9, 0xd8, 0x53, 0xf9, 0x2c, 0x8c, 0x2e, 0xed, 0xfe, 0xca, 0x01, 0x19,
+  0x1e, 0x92, 0xa8, 0x8d, 0xa6, 0x93, 0x44, 0x6d, 0x65, 0x7c, 0x58, 0xbe, 0x58, 0xf1, 0xff, 0x65,
+  0x80, 0x52, 0x54, 0x8d, 0xb2, 0x6f, 0x90, 0x63, 0x45, 0x5a, 0x5d, 0x1b, 0xa2, 0x45, 0xe5, 0x08,
+  0x95, 0x42, 0xae, 0x49, 0x5e, 0x72, 0x6b, 0xd3, 0xee, 0x31, 0x78, 0xdb, 0x25, 0x52, 0x5c, 0xfd,
+  0x65, 0x49, 0x84, 0xa0, 0x5b, 0xe8, 0x29, 0x38, 0x5f, 0xbe, 0x85, 0x36, 0x15, 0xe1, 0xb9, 0x93,
+  0x5a, 0xa5, 0xdd, 0xc8, 0x82, 0x12, 0x5d, 0x82, 0x7d, 0x29, 0x34, 0x92, 0xbc, 0x80, 0x43, 0xc8,
+  0x0c, 0x65, 0xc4, 0x41, 0x55, 0x83, 0xe1, 0x6e, 0x65, 0x60, 0x42, 0x12, 0xa9, 0xea, 0x95, 0x23,
+  0x6e, 0x57, 0x63, 0xe7, 0xd4, 0xaa, 0x9a, 0x83, 0xe9, 0x1e, 0xfb, 0xe8, 0x71, 0x48, 0x20, 0x91,
+  0x6c, 0x88, 0x2b, 0xdf, 0xa6, 0xdd, 0x31, 0x6e, 0xac, 0x83, 0x1a, 0x25, 0xe1, 0x43, 0x97, 0xac,
+  0x79, 0xb9, 0x42, 0xe0, 0x28, 0xc6, 0x1f, 0xf4, 0x7f, 0x4d, 0x65, 0x57, 0xf3, 0x4a, 0xba, 0x33,
+  0xc4, 0x3b, 0xf6, 0x90, 0xc8, 0xc7, 0xe8, 0xd7, 0x36, 0x11, 0x9b, 0x1b, 0x59, 0xbb, 0xac, 0xb3,
+  0xe6, 0x86, 0x7c, 0x7a, 0xff, 0xe3, 0xdf, 0x6f, 0x5f, 0xbe, 0xcf, 0xd2, 0x78, 0x38, 0x1c, 0x0e,
+  0xe6, 0x7a, 0x9b, 0x0a, 0x9d, 0xaf, 0x2a, 0xac, 0x56, 0x88, 0xc1, 0x3f, 0x95, 0xe0, 0xb7, 0x1f,
+  0x76, 0xbf, 0x0b, 0x1a, 0x9c, 0x2a, 0x12, 0xb0, 0x69, 0x67, 0xb1, 0x52, 0x4d, 0xc6, 0x04, 0x5b,
+  0x4a, 0x4b, 0xa9, 0x60, 0xe0, 0x74, 0xcd, 0xf6, 0x1d, 0x42, 0x3c, 0xa9, 0xb8, 0x90, 0xe4, 0x06,
+  0xb8, 0x83, 0x23, 0x0f, 0x0d, 0x30, 0x00, 0x6f, 0x4e, 0x88, 0x08, 0x9b, 0x52, 0x7e, 0xf6, 0x39,
+  0x9f, 0x98, 0x83, 0x56, 0xe1, 0x60, 0xeb, 0x1e, 0x8f, 0x33, 0xec, 0xa9, 0xbd, 0x54, 0x2e, 0xa8,
+  0x77, 0x80, 0xf1, 0x85, 0x52, 0x59, 0x30, 0xee, 0x03, 0x60, 0x4e, 0x40, 0x85, 0x0f, 0x39, 0x5c,
+  0x48, 0x63, 0xdd, 0x63, 0x21, 0x4b, 0xc1, 0xa6, 0x50, 0x5a, 0x20, 0x5e, 0xc8, 0xeb, 0x1a, 0xd3,
+  0x6f, 0xa4, 0x54, 0x34, 0x3e, 0x37, 0xb8, 0x07, 0xea, 0x75, 0xb9, 0x97, 0x7e, 0xd6, 0x02, 0x6c,
+  0x58, 0x82, 0x7a, 0x71, 0x45, 0x76, 0xaa, 0x43, 0xe3, 0xc2, 0x40, 0xa5, 0xd7, 0xd0, 0x9a, 0xfa,
+  0x7f, 0x8c, 0xf4, 0x44, 0xdf, 0x39, 0x5c, 0x72, 0x2f, 0x60, 0x4b, 0xe7, 0x6c, 0x6f, 0x00, 0x9b,
+  0xaa, 0x08, 0x9d, 0x27, 0xf1, 0xeb, 0x77, 0xc1, 0x30, 0x98, 0x04, 0x01, 0xeb, 0xcf, 0x43, 0xa7,
+  0x67, 0xce, 0xe0, 0xb8, 0xd3, 0xf8, 0x35, 0x3b, 0x74, 0xa2, 0x88, 0xcc, 0x30, 0x57, 0xe2, 0x13,
+  0x22, 0xbe, 0x1d, 0xdc, 0x11, 0x6e, 0x89, 0x2b, 0x80, 0x14, 0xd2, 0xe2, 0xb0, 0xee, 0xc8, 0xc2,
+  0xe8, 0x8a, 0x44, 0xa7, 0x2a, 0x5f, 0xdc, 0x94, 0x72, 0x8d, 0x51, 0xaf, 0x16, 0x57, 0xe5, 0x55,
+  0xb0, 0x21, 0x1f, 0xb9, 0xe3, 0x7f, 0xe1, 0xa1, 0x6f, 0x54, 0x03, 0x95, 0x0a, 0xdf, 0xb0, 0x3f,
+  0xa5, 0x72, 0x6f, 0x69, 0xcc, 0x06, 0x3a, 0x1d, 0xfb, 0x94, 0xd1, 0x13, 0xf5, 0x26, 0x32, 0x1d,
+  0x4e, 0x65, 0xa2, 0xa6, 0xb2, 0xdf, 0x6f, 0x68, 0x5a, 0x22, 0x77, 0x31, 0xba, 0x1f, 0x51, 0x3d,
+  0x70, 0x66, 0x05, 0x6c, 0x60, 0xaf, 0xa9, 0x74, 0xff, 0x81, 0x0d, 0x8a, 0x5b, 0xc9, 0x1b, 0x36,
+  0xc0, 0xaa, 0xdd, 0xca, 0xe2, 0x21, 0x1b, 0x08, 0x8c, 0x28, 0x0d, 0x9a, 0x2e, 0x5e, 0x3c, 0x2f,
+  0xd1, 0xf3, 0x32, 0x41, 0x7c, 0xaf, 0xb7, 0x4c, 0xe2, 0xf1, 0x74, 0x89, 0x11, 0x78, 0x60, 0x3f,
+  0x0d, 0x48, 0xd0, 0xf7, 0x25, 0xbc, 0xe5, 0x89, 0xfb, 0x4b, 0xc6, 0x5a, 0x0a, 0x6c, 0x3a, 0xda,
+  0x65, 0xf1, 0xf8, 0x6c, 0x10, 0x86, 0xe1, 0x91, 0xde, 0xcf, 0x1d, 0x75, 0x91, 0x9f, 0x5a, 0x86,
+  0xa5, 0xfe, 0x4d, 0x6e, 0x41, 0xd0, 0x7b, 0xd6, 0xbf, 0x65, 0x1b, 0xb3, 0x5e, 0xfc, 0x2e, 0x20,
+  0x33, 0x7f, 0xf8, 0xb1, 0x2f, 0xc4, 0xdf, 0x03, 0x58, 0x4d, 0x41, 0xb0, 0x43, 0xd4, 0x66, 0xd9,
+  0x98, 0xf5, 0x83, 0x30, 0xc0, 0x6d, 0x2f, 0x7e, 0x68, 0xb7, 0x37, 0xe6, 0xaf, 0x51, 0x46, 0xee,
+  0x32, 0x8c, 0x93, 0x16, 0x59, 0x86, 0xec, 0x41, 0xe4, 0xb7, 0xbd, 0x37, 0xed, 0xee, 0x06, 0xfb,
+  0xd6, 0x63, 0x1f, 0x9f, 0xd3, 0xe1, 0xf6, 0x27, 0xc5, 0xaf, 0xec, 0x66, 0x14, 0x10, 0xe5, 0x3b,
+  0x37, 0x41, 0x14, 0x2e, 0x6d, 0xc9, 0xdb, 0x94, 0x74, 0x3f, 0xc5, 0xec, 0x31, 0x63, 0xff, 0x7b,
+  0xb8, 0x1e, 0x34, 0xbc, 0x6e, 0x14, 0xe4, 0x8e, 0x9e, 0x27, 0x60, 0x63, 0x9b, 0x11, 0xf8, 0x0e,
+  0xf3, 0x99, 0xce, 0x97, 0xe0, 0x28, 0x2d, 0x75, 0xce, 0x3d, 0x36, 0xac, 0x8d, 0x76, 0x3a, 0xd7,
+  0x65, 0x9a, 0x06, 0x85, 0x73, 0xb5, 0x9d, 0x04, 0xef, 0x82, 0x8d, 0xb5, 0x93, 0x28, 0xc2, 0x02,
+  0x6c, 0x9a, 0x95, 0xf5, 0xcf, 0xe8, 0x42, 0x5b, 0x87, 0xb9, 0x2c, 0xd5, 0x16, 0xef, 0x55, 0x3c,
+  0xaa, 0x55, 0x7b, 0x3a, 0x37, 0x36, 0x9c, 0x4b, 0xc5, 0xcd, 0xee, 0xd9, 0x5f, 0x2b, 0x01, 0x37,
+  0x86, 0xef, 0x70, 0xcc, 0x16, 0x60, 0x82, 0xa3, 0x5a, 0xab, 0xe3, 0xa0, 0xa6, 0xa7, 0x28, 0x29,
+  0xb0, 0xbd, 0x3f, 0xa6, 0x68, 0xa1, 0x17, 0x04, 0x42, 0x9f, 0xde, 0xab, 0x34, 0xb0, 0x4d, 0xe6,
+  0x41, 0xaf, 0x77, 0x33, 0xb3, 0xad, 0x9a, 0x5d, 0xea, 0x34, 0x64, 0x69, 0x3a, 0x62, 0xcd, 0xa8,
+  0x1f, 0x75, 0x87, 0xb3, 0xa7, 0xbc, 0xd4, 0xf6, 0xca, 0x0f, 0xdb, 0xe3, 0x23, 0xf8, 0x2c, 0x2b,
+  0xd0, 0x2b, 0x47, 0x8f, 0xa5, 0x19, 0x8c, 0xfc, 0x20, 0x1c, 0x9a, 0xe3, 0x09, 0x2e, 0x2f, 0x68,
+  0x10, 0x5d, 0xae, 0xab, 0x10, 0x4f, 0x99, 0xa2, 0x67, 0x7b, 0x73, 0x3e, 0xb2, 0xa6, 0xb9, 0x6b,
+  0x28, 0x3b, 0xfc, 0x0c, 0x71, 0x4d, 0xa5, 0x5d, 0x68, 0xeb, 0x52, 0xe2, 0xad, 0xf5, 0x8f, 0x42,
+  0x12, 0x1c, 0xe8, 0x27, 0x8e, 0xcc, 0x67, 0x90, 0x3f, 0xca, 0x4d, 0xca, 0xcd, 0xe6, 0x7c, 0x11,
+  0x2e, 0x38, 0xde, 0x40, 0x48, 0xe9, 0xc3, 0x3f, 0x37, 0x0e, 0x03, 0xc3, 0x0f, 0x1f, 0xaf, 0xe3,
+  0xd5, 0x9b, 0x44, 0xcd, 0xbb, 0x85, 0x8f, 0x50, 0xf3, 0xd6, 0xff, 0x07, 0xb6, 0xd0, 0xc8, 0xcc,
+  0xfc, 0x07, 0x00, 0x00,
+};
+
+static const knx_asset_t monitor_assets[] = {
+  { "/", "text/html", monitor_asset_index_html, sizeof(monitor_asset_index_html), "\"" MONITOR_ASSET_INDEX_HTML_VERSION "\"", ASSET_CACHE_REVALIDATE },
+};
+
+#define MONITOR_ASSET_COUNT (sizeof(monitor_assets) / sizeof(monitor_assets[0]))
+
+#endif
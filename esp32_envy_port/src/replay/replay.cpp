@@ -0,0 +1,185 @@
+/**
+ * Replays the bus captures in CAPTURE_DIR through the esp-knx-ip receive path
+ * and prints throughput and per-callback latency as JSON. Build with the
+ * replay-native or replay-esp32 env. On the host LittleFS is the directory
+ * KNX_HOST_FS_DIR (default ./littlefs), so a download from /knx/capture can
+ * be replayed by saving it as littlefs/capture/0.kc.
+ * License: MIT
+ */
+
+#include <Arduino.h>
+#include <LittleFS.h>
+#include <stdlib.h>
+#include <vector>
+#include <algorithm>
+#include "esp-knx-ip.h"
+
+/* 1 keeps the captured timing, 10 is ten times faster, 0 as fast as possible */
+#ifndef REPLAY_SPEED
+#define REPLAY_SPEED 1.0
+#endif
+
+#ifdef ESP_PLATFORM
+#define REPLAY_PLATFORM "esp32"
+#else
+#define REPLAY_PLATFORM "native"
+#endif
+
+#define CALLBACK_NONE ((callback_id_t)-1)
+
+static KnxReplay replay;
+static volatile float sink;
+
+/* Stands in for application work: decode the value the way a callback would */
+static void decode_cb(message_t const &msg, void * /* arg */)
+{
+  switch (msg.data_len)
+  {
+    case 1: sink = knx.data_to_bool(msg.data); break;
+    case 2: sink = knx.data_to_1byte_uint(msg.data); break;
+    case 3: sink = knx.data_to_2byte_float(msg.data); break;
+    case 5: sink = knx.data_to_4byte_float(msg.data); break;
+    default: sink = msg.data_len; break;
+  }
+}
+
+/* Capture files in numeric order, oldest first */
+static std::vector<uint32_t> capture_files(const char *dir)
+{
+  std::vector<uint32_t> files;
+  File d = LittleFS.open(dir);
+  if (!d || !d.isDirectory())
+    return files;
+  for (File f = d.openNextFile(); f; f = d.openNextFile())
+  {
+    const char *name = strrchr(f.name(), '/');
+    name = name != nullptr ? name + 1 : f.name();
+    char *end;
+    unsigned long n = strtoul(name, &end, 10);
+    if (end != name && strcmp(end, ".kc") == 0)
+      files.push_back(n);
+  }
+  std::sort(files.begin(), files.end());
+  return files;
+}
+
+static File open_capture(uint32_t n)
+{
+  char path[CAPTURE_PATH_MAX];
+  snprintf(path, sizeof(path), "%s/%lu.kc", CAPTURE_DIR, (unsigned long)n);
+  return LittleFS.open(path, FILE_READ);
+}
+
+/*
+ * Gives every main group in the captures a callback of its own, so the
+ * latency report shows which part of the installation costs what. Group
+ * addresses past MAX_CALLBACK_ASSIGNMENTS, and main groups past
+ * MAX_CALLBACKS, are left unassigned.
+ */
+static uint16_t assign_callbacks(std::vector<uint32_t> const &files, callback_id_t *ids)
+{
+  KnxReplay scan;
+  std::vector<uint16_t> gas;
+  uint8_t buf[KNX_FRAME_HEADER_LEN + 255];
+  for (uint32_t n : files)
+  {
+    scan.begin(open_capture(n), 0);
+    while (!scan.done())
+    {
+      int len = scan.parsePacket();
+      if (len <= 0)
+        continue;
+      scan.read(buf, len);
+      telegram_t telegram;
+      if (knx_frame_parse(buf, len, telegram) != KNX_PARSE_OK)
+        continue;
+      address_t ga = telegram.destination;
+      if (gas.size() >= MAX_CALLBACK_ASSIGNMENTS || std::find(gas.begin(), gas.end(), ga.value) != gas.end())
+        continue;
+
+      uint8_t area = ga.ga.area;
+      if (ids[area] == CALLBACK_NONE)
+      {
+        callback_id_t id = knx.callback_register(String("main ") + String((int)area), decode_cb);
+        if (id == CALLBACK_NONE)
+          continue;
+        ids[area] = id;
+      }
+      gas.push_back(ga.value);
+      knx.callback_assign(ids[area], ga);
+    }
+  }
+  return gas.size();
+}
+
+void setup()
+{
+  Serial.begin(115200);
+  delay(1000);
+
+  float speed = REPLAY_SPEED;
+#ifndef ESP_PLATFORM
+  // KNX_REPLAY_SPEED=<factor> overrides it on the host
+  if (getenv("KNX_REPLAY_SPEED") != nullptr)
+    speed = atof(getenv("KNX_REPLAY_SPEED"));
+#endif
+
+  if (!LittleFS.begin())
+  {
+    Serial.println("LittleFS not mounted");
+    return;
+  }
+  std::vector<uint32_t> files = capture_files(CAPTURE_DIR);
+  if (files.empty())
+  {
+    Serial.printf("No captures in %s\n", CAPTURE_DIR);
+    return;
+  }
+
+  callback_id_t ids[32]; // per main group
+  for (uint8_t i = 0; i < 32; ++i)
+    ids[i] = CALLBACK_NONE;
+  uint16_t gas = assign_callbacks(files, ids);
+
+  knx.start(nullptr);
+  knx.replay_set(&replay);
+  for (uint32_t n : files)
+  {
+    replay.begin(open_capture(n), speed);
+    while (!replay.done())
+      knx.loop();
+  }
+  knx.replay_set(nullptr);
+
+  replay_stats_t s = replay.stats();
+  dedup_stats_t dedup = knx.dedup_stats();
+  Serial.printf("{\"suite\": \"esp-knx-ip-replay\", \"platform\": \"%s\", \"speed\": %.2f, \"files\": %u, \"group_addresses\": %u,\n",
+                REPLAY_PLATFORM, speed, (unsigned)files.size(), gas);
+  Serial.printf(" \"frames\": %lu, \"seconds\": %.3f, \"rate\": %.1f, \"lag_max_us\": %lu, \"bad_blocks\": %lu,\n",
+                (unsigned long)s.frames, s.elapsed_us / 1e6, s.elapsed_us > 0 ? s.frames * 1e6 / s.elapsed_us : 0.0,
+                (unsigned long)s.lag_max_us, (unsigned long)s.bad_blocks);
+  Serial.printf(" \"echoes\": %lu, \"duplicates\": %lu, \"calls\": %lu,\n \"callbacks\": [\n",
+                (unsigned long)dedup.echoes, (unsigned long)dedup.duplicates, (unsigned long)s.calls);
+  bool first = true;
+  for (uint8_t area = 0; area < 32; ++area)
+  {
+    if (ids[area] == CALLBACK_NONE)
+      continue;
+    KnxLatencyHistogram const *h = replay.callback_latency(ids[area]);
+    if (h == nullptr)
+      continue;
+    Serial.printf("%s  {\"name\": \"main %u\", \"calls\": %lu, \"p50_us\": %lu, \"p90_us\": %lu, \"p99_us\": %lu, \"max_us\": %lu}",
+                  first ? "" : ",\n", area, (unsigned long)h->count(), (unsigned long)h->percentile(50),
+                  (unsigned long)h->percentile(90), (unsigned long)h->percentile(99), (unsigned long)h->percentile(100));
+    first = false;
+  }
+  Serial.printf("\n ]}\n");
+#ifndef ESP_PLATFORM
+  exit(0);
+#endif
+}
+
+void loop()
+{
+  delay(1000);
+}
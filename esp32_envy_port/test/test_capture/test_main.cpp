@@ -0,0 +1,95 @@
+/**
+ * esp-knx-ip library for KNX/IP communication on an ESP32
+ * Capture and replay: telegrams written by KnxCapture come back from
+ * KnxReplay as the same routing indications, for each of the 16 command
+ * types. Run with: pio test -e native
+ * License: MIT
+ */
+
+#include <unity.h>
+#include <Arduino.h>
+#include <LittleFS.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "esp-knx-ip.h"
+
+#define TEST_DIR        "/roundtrip"
+#define SETTLE_TIMEOUT  1000  // ms to wait for the writer task
+
+static KnxCapture capture;
+
+void setUp() {}
+void tearDown() {}
+
+/* Flushes the open block and waits until the writer task has stored it */
+static bool store()
+{
+  uint32_t blocks = capture.stats().blocks;
+  uint32_t start = millis();
+  while (capture.stats().blocks == blocks)
+  {
+    if (millis() - start > SETTLE_TIMEOUT)
+      return false;
+    capture.flush(millis() + CAPTURE_FLUSH_MS);
+    delay(1);
+  }
+  return true;
+}
+
+static void test_every_command_type_round_trips()
+{
+  static const uint8_t payload[] = {0x15, 0x12, 0x34};
+  for (uint8_t ct = 0; ct <= 0x0F; ++ct)
+  {
+    telegram_t telegram = {};
+    telegram.source = ESPKNXIP::PA_to_address(1, 1, 5);
+    telegram.destination = ESPKNXIP::GA_to_address(3, 1, ct);
+    telegram.ct = (knx_command_type_t)ct;
+    telegram.data_len = sizeof(payload);
+    telegram.data = payload;
+    capture.push(telegram, micros(), millis());
+  }
+  TEST_ASSERT_TRUE(store());
+
+  char path[CAPTURE_PATH_MAX];
+  snprintf(path, sizeof(path), TEST_DIR "/%u.kc", (unsigned)(capture.stats().next_segment - 1));
+  KnxReplay replay;
+  TEST_ASSERT_TRUE(replay.begin(LittleFS.open(path), 0));
+
+  uint8_t buf[KNX_FRAME_MAX_LEN];
+  for (uint8_t ct = 0; ct <= 0x0F; ++ct)
+  {
+    int len = replay.parsePacket();
+    TEST_ASSERT_GREATER_THAN(0, len);
+    TEST_ASSERT_EQUAL(len, replay.read(buf, sizeof(buf)));
+    telegram_t telegram;
+    TEST_ASSERT_EQUAL(KNX_PARSE_OK, knx_frame_parse(buf, len, telegram));
+    TEST_ASSERT_EQUAL_HEX8(ct, telegram.ct);
+    TEST_ASSERT_EQUAL_HEX16(ESPKNXIP::GA_to_address(3, 1, ct).value, telegram.destination.value);
+    TEST_ASSERT_EQUAL(sizeof(payload), telegram.data_len);
+    TEST_ASSERT_EQUAL_HEX8(payload[0], telegram.data[0] & 0x3F);
+    TEST_ASSERT_EQUAL_MEMORY(payload + 1, telegram.data + 1, sizeof(payload) - 1);
+  }
+  TEST_ASSERT_EQUAL(0, replay.parsePacket());
+  TEST_ASSERT_EQUAL(0, replay.stats().bad_blocks);
+}
+
+int main()
+{
+  // A fresh directory, so the capture starts at segment 0 with nothing to rotate
+  char fs_dir[] = "/tmp/knx-test-capture-XXXXXX";
+  if (mkdtemp(fs_dir) == nullptr || setenv("KNX_HOST_FS_DIR", fs_dir, 1) != 0 || !LittleFS.begin(true))
+  {
+    printf("Cannot mount a scratch LittleFS directory\n");
+    return 1;
+  }
+  if (!capture.begin(LittleFS, TEST_DIR))
+  {
+    printf("Cannot start the capture\n");
+    return 1;
+  }
+
+  UNITY_BEGIN();
+  RUN_TEST(test_every_command_type_round_trips);
+  return UNITY_END();
+}
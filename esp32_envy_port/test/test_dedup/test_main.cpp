@@ -0,0 +1,117 @@
+/**
+ * esp-knx-ip library for KNX/IP communication on an ESP32
+ * Echo and repeat suppression: only our own echoes and frames flagged as
+ * repeated are dropped, a value sent twice on purpose is delivered twice.
+ * Runs on the board (pio test -e esp32) and on the host (pio test -e native).
+ * License: MIT
+ */
+
+#include <unity.h>
+#ifdef ESP_PLATFORM
+#include <Arduino.h>
+#endif
+#include <string.h>
+#include "esp-knx-ip-dedup.h"
+#include "esp-knx-ip-frame.h"
+
+#define WINDOW_MS 250
+
+static KnxDedupCache cache;
+static const uint8_t payload[] = {0x80, 0x0c, 0x33};
+
+/* 1.1.5 writes payload to 10/6/5 */
+static uint64_t sensor_key()
+{
+  return KnxDedupCache::key(0x1105, 0x5605, KNX_CT_WRITE, payload, sizeof(payload));
+}
+
+void setUp()
+{
+  cache = KnxDedupCache();
+  cache.window_set(WINDOW_MS);
+}
+
+void tearDown() {}
+
+static void test_parse_reads_the_repeat_flag()
+{
+  // Routing indication, 1.1.5 writes DPT 9 21.5 to 10/6/5; control field 1 at offset 8
+  uint8_t frame[] = {0x06, 0x10, 0x05, 0x30, 0x00, 0x13, 0x29, 0x00, 0xbc, 0xe0,
+                     0x11, 0x05, 0x56, 0x05, 0x03, 0x00, 0x80, 0x0c, 0x33};
+  telegram_t telegram;
+  TEST_ASSERT_EQUAL(KNX_PARSE_OK, knx_frame_parse(frame, sizeof(frame), telegram));
+  TEST_ASSERT_FALSE(telegram.repeated);
+
+  frame[8] &= ~0x20;
+  TEST_ASSERT_EQUAL(KNX_PARSE_OK, knx_frame_parse(frame, sizeof(frame), telegram));
+  TEST_ASSERT_TRUE(telegram.repeated);
+}
+
+static void test_same_value_twice_is_delivered_twice()
+{
+  TEST_ASSERT_EQUAL(DEDUP_NEW, cache.received(sensor_key(), 1000, false));
+  TEST_ASSERT_EQUAL(DEDUP_NEW, cache.received(sensor_key(), 1010, false));
+  TEST_ASSERT_EQUAL(2, cache.stats().passed);
+  TEST_ASSERT_EQUAL(0, cache.stats().duplicates);
+}
+
+static void test_repeat_within_window_is_dropped()
+{
+  TEST_ASSERT_EQUAL(DEDUP_NEW, cache.received(sensor_key(), 1000, false));
+  TEST_ASSERT_EQUAL(DEDUP_DUPLICATE, cache.received(sensor_key(), 1000 + WINDOW_MS - 1, true));
+  // Measured from the original, not from the last repeat
+  TEST_ASSERT_EQUAL(DEDUP_NEW, cache.received(sensor_key(), 1000 + WINDOW_MS, true));
+}
+
+static void test_repeat_of_a_missed_original_is_delivered()
+{
+  TEST_ASSERT_EQUAL(DEDUP_NEW, cache.received(sensor_key(), 1000, true));
+}
+
+static void test_one_echo_per_send()
+{
+  cache.sent(sensor_key(), 1000);
+  cache.sent(sensor_key(), 1001);
+  TEST_ASSERT_EQUAL(DEDUP_ECHO, cache.received(sensor_key(), 1002, false));
+  // A router repeat of our frame is not an echo
+  TEST_ASSERT_EQUAL(DEDUP_DUPLICATE, cache.received(sensor_key(), 1003, true));
+  TEST_ASSERT_EQUAL(DEDUP_ECHO, cache.received(sensor_key(), 1004, false));
+  // Another device writing the same value afterwards
+  TEST_ASSERT_EQUAL(DEDUP_NEW, cache.received(sensor_key(), 1005, false));
+  TEST_ASSERT_EQUAL(2, cache.stats().echoes);
+}
+
+static void test_window_zero_delivers_everything()
+{
+  cache.window_set(0);
+  cache.sent(sensor_key(), 1000);
+  TEST_ASSERT_EQUAL(DEDUP_NEW, cache.received(sensor_key(), 1000, false));
+  TEST_ASSERT_EQUAL(DEDUP_NEW, cache.received(sensor_key(), 1000, true));
+}
+
+static int run_tests()
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_parse_reads_the_repeat_flag);
+  RUN_TEST(test_same_value_twice_is_delivered_twice);
+  RUN_TEST(test_repeat_within_window_is_dropped);
+  RUN_TEST(test_repeat_of_a_missed_original_is_delivered);
+  RUN_TEST(test_one_echo_per_send);
+  RUN_TEST(test_window_zero_delivers_everything);
+  return UNITY_END();
+}
+
+#ifdef ESP_PLATFORM
+void setup()
+{
+  delay(2000); // give the test runner time to open the serial port
+  run_tests();
+}
+
+void loop() {}
+#else
+int main()
+{
+  return run_tests();
+}
+#endif
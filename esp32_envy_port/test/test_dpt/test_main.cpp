@@ -0,0 +1,223 @@
+/**
+ * esp-knx-ip library for KNX/IP communication on an ESP32
+ * Dpt<> codecs: decode(encode(v)) == v over every value of each type, every
+ * DPT 9 code, and every byte value in every position for the 4-byte types.
+ * Runs on the board (pio test -e esp32) and on the host (pio test -e native).
+ * License: MIT
+ */
+
+#include <unity.h>
+#ifdef ESP_PLATFORM
+#include <Arduino.h>
+#endif
+#include <stdio.h>
+#include <string.h>
+#include "esp-knx-ip-dpt.h"
+
+void setUp() {}
+void tearDown() {}
+
+/* Encoding a constant is a constant payload */
+static_assert(Dpt<7>::decode(Dpt<7>::encode(0xBEEF).data) == 0xBEEF, "DPT 7 is not constexpr");
+static_assert(Dpt<1>::encode(true).data[0] == 0x01, "DPT 1 is not constexpr");
+static_assert(Dpt<16>::encode("KNX").data[3] == 'X' && Dpt<16>::encode("KNX").data[4] == 0, "DPT 16 is not constexpr");
+
+/* 32-bit values whose bytes go through every value in every position */
+template <typename F>
+static void each_u32(F check)
+{
+  for (uint32_t i = 0; i <= 0xFFFF; ++i)
+  {
+    check(i);
+    check(i << 16);
+    check((i << 16) | (i ^ 0xFFFF));
+    check(i * 0x9E3779B9u); // spread over the whole range
+  }
+  check(0xFFFFFFFFu);
+}
+
+static void test_dpt1_boolean()
+{
+  TEST_ASSERT_TRUE(Dpt<1>::decode(Dpt<1>::encode(true).data));
+  TEST_ASSERT_FALSE(Dpt<1>::decode(Dpt<1>::encode(false).data));
+  // Only bit 0 counts, whatever the APCI left in the upper bits
+  for (uint32_t b = 0; b <= 0xFF; ++b)
+  {
+    uint8_t d = (uint8_t)b;
+    TEST_ASSERT_EQUAL(b & 0x01, Dpt<1>::decode(&d));
+  }
+}
+
+static void test_dpt2_dpt3_control()
+{
+  for (uint32_t v = 0; v <= 0xFF; ++v)
+  {
+    TEST_ASSERT_EQUAL_UINT8(v & 0x03, Dpt<2>::decode(Dpt<2>::encode((uint8_t)v).data));
+    TEST_ASSERT_EQUAL_UINT8(v & 0x0F, Dpt<3>::decode(Dpt<3>::encode((uint8_t)v).data));
+  }
+}
+
+static void test_dpt5_dpt6_one_byte()
+{
+  for (uint32_t v = 0; v <= 0xFF; ++v)
+  {
+    TEST_ASSERT_EQUAL_UINT8(v, Dpt<5>::decode(Dpt<5>::encode((uint8_t)v).data));
+    TEST_ASSERT_EQUAL_INT8((int8_t)v, Dpt<6>::decode(Dpt<6>::encode((int8_t)v).data));
+  }
+}
+
+static void test_dpt5_001_percentage()
+{
+  char msg[48];
+  for (uint32_t b = 0; b <= 0xFF; ++b)
+  {
+    const uint8_t d[] = {0x00, (uint8_t)b};
+    float pct = Dpt<5, 1>::decode(d);
+    snprintf(msg, sizeof(msg), "byte %u, %.4f %%", (unsigned)b, pct);
+    dpt_bytes_t<2> p = Dpt<5, 1>::encode(pct);
+    TEST_ASSERT_EQUAL_UINT8_MESSAGE(b, p.data[1], msg);
+  }
+  // Out of range percentages clamp
+  dpt_bytes_t<2> lo = Dpt<5, 1>::encode(-5.0f), hi = Dpt<5, 1>::encode(150.0f);
+  TEST_ASSERT_EQUAL_UINT8(0, lo.data[1]);
+  TEST_ASSERT_EQUAL_UINT8(255, hi.data[1]);
+}
+
+static void test_dpt7_dpt8_two_byte()
+{
+  for (uint32_t v = 0; v <= 0xFFFF; ++v)
+  {
+    TEST_ASSERT_EQUAL_UINT16(v, Dpt<7>::decode(Dpt<7>::encode((uint16_t)v).data));
+    TEST_ASSERT_EQUAL_INT16((int16_t)v, Dpt<8>::decode(Dpt<8>::encode((int16_t)v).data));
+  }
+}
+
+static void test_dpt9_two_byte_float()
+{
+  char msg[64];
+  for (uint32_t c = 0; c <= 0xFFFF; ++c)
+  {
+    const uint8_t d[] = {0x00, (uint8_t)(c >> 8), (uint8_t)c};
+    float v = Dpt<9>::decode(d);
+    float r = Dpt<9>::decode(Dpt<9>::encode(v).data);
+    snprintf(msg, sizeof(msg), "code 0x%04X: %.2f -> %.2f", (unsigned)c, v, r);
+    // The invalid code may decode to NaN, which only has to stay NaN
+    TEST_ASSERT_TRUE_MESSAGE(r == v || (r != r && v != v), msg);
+  }
+}
+
+static void test_dpt10_time_of_day()
+{
+  for (uint8_t wd = 0; wd <= 7; ++wd)
+    for (uint8_t h = 0; h <= 23; ++h)
+      for (uint8_t m = 0; m <= 59; ++m)
+        for (uint8_t s = 0; s <= 59; ++s)
+        {
+          time_of_day_t t = {(weekday_t)wd, h, m, s};
+          dpt_bytes_t<4> p = Dpt<10>::encode(t);
+          time_of_day_t r = Dpt<10>::decode(p.data);
+          TEST_ASSERT_EQUAL(wd, r.weekday);
+          TEST_ASSERT_EQUAL(h, r.hours);
+          TEST_ASSERT_EQUAL(m, r.minutes);
+          TEST_ASSERT_EQUAL(s, r.seconds);
+          // Weekday in the top three bits of the first value byte, once
+          TEST_ASSERT_EQUAL_HEX8((wd << 5) | h, p.data[1]);
+        }
+}
+
+static void test_dpt11_date()
+{
+  for (uint8_t d = 1; d <= 31; ++d)
+    for (uint8_t m = 1; m <= 12; ++m)
+      for (uint8_t y = 0; y <= 99; ++y)
+      {
+        date_t v = {d, m, y};
+        date_t r = Dpt<11>::decode(Dpt<11>::encode(v).data);
+        TEST_ASSERT_EQUAL(d, r.day);
+        TEST_ASSERT_EQUAL(m, r.month);
+        TEST_ASSERT_EQUAL(y, r.year);
+      }
+}
+
+static void test_dpt12_dpt13_four_byte()
+{
+  each_u32([](uint32_t v) {
+    TEST_ASSERT_EQUAL_UINT32(v, Dpt<12>::decode(Dpt<12>::encode(v).data));
+    TEST_ASSERT_EQUAL_INT32((int32_t)v, Dpt<13>::decode(Dpt<13>::encode((int32_t)v).data));
+  });
+}
+
+static void test_dpt14_float_bits()
+{
+  // Bit for bit, NaN payloads, infinities and denormals included
+  each_u32([](uint32_t bits) {
+    float v;
+    memcpy(&v, &bits, sizeof(v));
+    float r = Dpt<14>::decode(Dpt<14>::encode(v).data);
+    uint32_t back;
+    memcpy(&back, &r, sizeof(back));
+    TEST_ASSERT_EQUAL_HEX32(bits, back);
+  });
+  // Not the integer conversion the old data_to_4byte_float did
+  static const uint8_t d[] = {0x00, 0x44, 0x7d, 0x50, 0x00};
+  TEST_ASSERT_TRUE(Dpt<14>::decode(d) == 1013.25f);
+}
+
+static void test_dpt16_string()
+{
+  char s[15];
+  for (uint8_t len = 0; len <= 14; ++len)
+    for (uint32_t c = 1; c <= 0xFF; ++c)
+    {
+      memset(s, 0, sizeof(s));
+      memset(s, (int)c, len);
+      dpt_bytes_t<15> p = Dpt<16>::encode(s);
+      TEST_ASSERT_EQUAL_MEMORY(s, Dpt<16>::decode(p.data), 14);
+    }
+  // Longer strings are cut at 14 characters
+  dpt_bytes_t<15> p = Dpt<16>::encode("0123456789ABCDEF");
+  TEST_ASSERT_EQUAL_MEMORY("0123456789ABCD", Dpt<16>::decode(p.data), 14);
+}
+
+static void test_dpt232_color()
+{
+  for (uint32_t rgb = 0; rgb <= 0xFFFFFF; ++rgb)
+  {
+    color_t c = {(uint8_t)(rgb >> 16), (uint8_t)(rgb >> 8), (uint8_t)rgb};
+    color_t r = Dpt<232>::decode(Dpt<232>::encode(c).data);
+    TEST_ASSERT_EQUAL_HEX32(rgb, ((uint32_t)r.red << 16) | ((uint32_t)r.green << 8) | r.blue);
+  }
+}
+
+static int run_tests()
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_dpt1_boolean);
+  RUN_TEST(test_dpt2_dpt3_control);
+  RUN_TEST(test_dpt5_dpt6_one_byte);
+  RUN_TEST(test_dpt5_001_percentage);
+  RUN_TEST(test_dpt7_dpt8_two_byte);
+  RUN_TEST(test_dpt9_two_byte_float);
+  RUN_TEST(test_dpt10_time_of_day);
+  RUN_TEST(test_dpt11_date);
+  RUN_TEST(test_dpt12_dpt13_four_byte);
+  RUN_TEST(test_dpt14_float_bits);
+  RUN_TEST(test_dpt16_string);
+  RUN_TEST(test_dpt232_color);
+  return UNITY_END();
+}
+
+#ifdef ESP_PLATFORM
+void setup()
+{
+  delay(2000); // give the test runner time to open the serial port
+  run_tests();
+}
+
+void loop() {}
+#else
+int main()
+{
+  return run_tests();
+}
+#endif
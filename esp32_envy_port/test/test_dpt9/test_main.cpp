@@ -0,0 +1,114 @@
+/**
+ * esp-knx-ip library for KNX/IP communication on an ESP32
+ * DPT 9 2-byte float: every one of the 65,536 codes through both encoders
+ * Runs on the board (pio test -e esp32) and on the host (pio test -e native).
+ * License: MIT
+ */
+
+#include <unity.h>
+#ifdef ESP_PLATFORM
+#include <Arduino.h>
+#endif
+#include <math.h>
+#include <stdio.h>
+#include "esp-knx-ip-dpt.h"
+
+using namespace dpt_detail;
+
+#define F16_INVALID 0x7FFF
+
+void setUp() {}
+void tearDown() {}
+
+static float decode_code(uint16_t code)
+{
+  return f16_to(code >> 8, code & 0xFF);
+}
+
+/* The code with the lowest exponent for its value, which is what the encoders produce */
+static bool canonical(uint16_t code)
+{
+  uint8_t e = (code >> 11) & 0x0F;
+  int32_t m = f16_mantissa(((uint32_t)(code & 0x8000) >> 4) | (code & 0x07FF));
+  return e == 0 || m < -1024 || m > 1023;
+}
+
+static void test_every_code_round_trips()
+{
+  char msg[96];
+  for (uint32_t c = 0; c <= 0xFFFF; ++c)
+  {
+    uint16_t code = (uint16_t)c;
+    if (code == F16_INVALID)
+      continue;
+    float v = decode_code(code);
+    uint16_t bits = f16_from_bits(v * 100.0f);
+    uint16_t folded = f16_from_const(v * 100.0f);
+    snprintf(msg, sizeof(msg), "code 0x%04X (%.2f): bits 0x%04X, const 0x%04X", code, v, bits, folded);
+
+    TEST_ASSERT_TRUE_MESSAGE(bits == folded, msg);
+    TEST_ASSERT_TRUE_MESSAGE(bits != F16_INVALID, msg);
+    TEST_ASSERT_TRUE_MESSAGE(decode_code(bits) == v, msg);
+    if (canonical(code))
+      TEST_ASSERT_TRUE_MESSAGE(bits == code, msg);
+  }
+}
+
+static void test_invalid_code_decodes_to_nan()
+{
+  static const uint8_t invalid[] = {0x00, 0x7F, 0xFF};
+  TEST_ASSERT_TRUE(isnan(Dpt<9>::decode(invalid)));
+  TEST_ASSERT_EQUAL_HEX16(F16_INVALID, f16_from_bits(NAN));
+  TEST_ASSERT_EQUAL_HEX16(F16_INVALID, f16_from_const(NAN));
+}
+
+static void test_overflow_saturates_below_invalid()
+{
+  // 670760.96 is mantissa 2047 at exponent 15, which would be the invalid code
+  static const float over[] = {670760.96f, 670760.0f, 671088.64f, 1e9f, INFINITY};
+  for (uint8_t i = 0; i < sizeof(over) / sizeof(over[0]); ++i)
+  {
+    TEST_ASSERT_EQUAL_HEX16(0x7FFE, f16_from_bits(over[i] * 100.0f));
+    TEST_ASSERT_EQUAL_HEX16(0x7FFE, f16_from_const(over[i] * 100.0f));
+  }
+  static const float under[] = {-671088.64f, -671200.0f, -1e9f, -INFINITY};
+  for (uint8_t i = 0; i < sizeof(under) / sizeof(under[0]); ++i)
+  {
+    TEST_ASSERT_EQUAL_HEX16(0xF800, f16_from_bits(under[i] * 100.0f));
+    TEST_ASSERT_EQUAL_HEX16(0xF800, f16_from_const(under[i] * 100.0f));
+  }
+
+  // Through the codec, folded at compile time and encoded at run time
+  static constexpr dpt_bytes_t<3> folded = Dpt<9>::encode(1e9f);
+  volatile float big = 1e9f;
+  dpt_bytes_t<3> run = Dpt<9>::encode(big);
+  TEST_ASSERT_EQUAL_HEX8(0x7F, folded.data[1]);
+  TEST_ASSERT_EQUAL_HEX8(0xFE, folded.data[2]);
+  TEST_ASSERT_EQUAL_HEX8(0x7F, run.data[1]);
+  TEST_ASSERT_EQUAL_HEX8(0xFE, run.data[2]);
+  TEST_ASSERT_TRUE(Dpt<9>::decode(run.data) == 670433.28f);
+}
+
+static int run_tests()
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_every_code_round_trips);
+  RUN_TEST(test_invalid_code_decodes_to_nan);
+  RUN_TEST(test_overflow_saturates_below_invalid);
+  return UNITY_END();
+}
+
+#ifdef ESP_PLATFORM
+void setup()
+{
+  delay(2000); // give the test runner time to open the serial port
+  run_tests();
+}
+
+void loop() {}
+#else
+int main()
+{
+  return run_tests();
+}
+#endif
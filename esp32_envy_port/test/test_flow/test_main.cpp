@@ -0,0 +1,243 @@
+/**
+ * esp-knx-ip library for KNX/IP communication on an ESP32
+ * Routing flow control against a stand-in router on the loopback multicast
+ * group: ROUTING_BUSY holds writes back for the announced wait, in order,
+ * and sending resumes afterwards. Run with: pio test -e native
+ * License: MIT
+ */
+
+#include <unity.h>
+#include <Arduino.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include "esp-knx-ip.h"
+
+#define BUSY_WAIT_MS    100
+#define SETTLE_TIMEOUT  1000  // ms to wait for a frame to make it through loopback
+
+/* Sends BUSY and LOST_MESSAGE like a router would, and sees every routing indication on the group */
+class StandInRouter
+{
+  public:
+    bool open()
+    {
+      fd = socket(AF_INET, SOCK_DGRAM, 0);
+      if (fd < 0)
+        return false;
+      int one = 1;
+      setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+      setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &one, sizeof(one));
+      struct sockaddr_in addr = {};
+      addr.sin_family = AF_INET;
+      addr.sin_port = htons(MULTICAST_PORT);
+      addr.sin_addr.s_addr = htonl(INADDR_ANY);
+      if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0)
+        return false;
+
+      // Loopback, the same bus the WiFiUDP shim joins
+      struct in_addr ifaddr = {};
+      ifaddr.s_addr = htonl(INADDR_LOOPBACK);
+      struct ip_mreq mreq = {};
+      mreq.imr_multiaddr.s_addr = (uint32_t)MULTICAST_IP;
+      mreq.imr_interface = ifaddr;
+      setsockopt(fd, IPPROTO_IP, IP_ADD_MEMBERSHIP, &mreq, sizeof(mreq));
+      setsockopt(fd, IPPROTO_IP, IP_MULTICAST_IF, &ifaddr, sizeof(ifaddr));
+      unsigned char loop = 1;
+      setsockopt(fd, IPPROTO_IP, IP_MULTICAST_LOOP, &loop, sizeof(loop));
+
+      dest = {};
+      dest.sin_family = AF_INET;
+      dest.sin_port = htons(MULTICAST_PORT);
+      dest.sin_addr.s_addr = (uint32_t)MULTICAST_IP;
+      return true;
+    }
+
+    void busy(uint16_t wait_ms, uint16_t control)
+    {
+      const uint8_t frame[] = {0x06, 0x10, 0x05, 0x32, 0x00, 0x0c,
+                               0x06, 0x00, (uint8_t)(wait_ms >> 8), (uint8_t)wait_ms, (uint8_t)(control >> 8), (uint8_t)control};
+      sendto(fd, frame, sizeof(frame), 0, (struct sockaddr *)&dest, sizeof(dest));
+    }
+
+    void lost(uint16_t count)
+    {
+      const uint8_t frame[] = {0x06, 0x10, 0x05, 0x31, 0x00, 0x0a,
+                               0x04, 0x00, (uint8_t)(count >> 8), (uint8_t)count};
+      sendto(fd, frame, sizeof(frame), 0, (struct sockaddr *)&dest, sizeof(dest));
+    }
+
+    /* The next routing indication on the group, skipping control frames */
+    bool receive(telegram_t &telegram)
+    {
+      for (;;)
+      {
+        ssize_t n = recv(fd, buf, sizeof(buf), MSG_DONTWAIT);
+        if (n <= 0)
+          return false;
+        if (knx_frame_parse(buf, n, telegram) == KNX_PARSE_OK)
+          return true;
+      }
+    }
+
+    void drain()
+    {
+      telegram_t telegram;
+      while (receive(telegram))
+        ;
+    }
+
+  private:
+    int fd;
+    struct sockaddr_in dest;
+    uint8_t buf[256];
+};
+
+static StandInRouter router;
+
+static address_t ga(uint8_t sub)
+{
+  return ESPKNXIP::GA_to_address(4, 2, sub);
+}
+
+/* Runs knx.loop() until fn() holds or SETTLE_TIMEOUT passes */
+template <typename F>
+static bool loop_until(F fn)
+{
+  uint32_t start = millis();
+  while (!fn())
+  {
+    if (millis() - start > SETTLE_TIMEOUT)
+      return false;
+    knx.loop();
+    delay(1);
+  }
+  return true;
+}
+
+/* Runs knx.loop() until the router sees a write to dest, the time it did or 0 */
+static uint32_t arrival(address_t const &dest)
+{
+  uint32_t seen = 0;
+  telegram_t telegram;
+  loop_until([&]() {
+    while (router.receive(telegram))
+    {
+      if (telegram.destination.value == dest.value)
+      {
+        seen = millis();
+        return true;
+      }
+    }
+    return false;
+  });
+  return seen;
+}
+
+/* Waits out the back-off of the previous test so each one starts unpaused */
+void setUp()
+{
+  loop_until([]() { return knx.routing_stats().busy_counter == 0 && knx.tx_pending() == 0; });
+  router.drain();
+}
+
+void tearDown() {}
+
+static void test_busy_holds_then_resumes()
+{
+  uint32_t busy = knx.routing_stats().busy_received;
+  uint32_t sent_at = millis();
+  router.busy(BUSY_WAIT_MS, 0x0000);
+  TEST_ASSERT_TRUE(loop_until([&]() { return knx.routing_stats().busy_received == busy + 1; }));
+  uint16_t n = knx.routing_stats().busy_counter;
+  TEST_ASSERT_EQUAL(1, n);
+
+  knx.write_2byte_float(ga(1), 21.5f);
+  TEST_ASSERT_EQUAL(1, knx.tx_pending());
+
+  uint32_t arrived = arrival(ga(1));
+  TEST_ASSERT_NOT_EQUAL(0, arrived);
+  TEST_ASSERT_EQUAL(0, knx.tx_pending());
+  // The announced wait, plus at most N * 50 ms of random share and loop slack
+  TEST_ASSERT_GREATER_OR_EQUAL_UINT32(BUSY_WAIT_MS, arrived - sent_at);
+  TEST_ASSERT_LESS_OR_EQUAL_UINT32(BUSY_WAIT_MS + n * 50 + 50, arrived - sent_at);
+
+  // Once the pause is over, writes leave at once again
+  knx.write_2byte_float(ga(2), 22.0f);
+  TEST_ASSERT_EQUAL(0, knx.tx_pending());
+  TEST_ASSERT_NOT_EQUAL(0, arrival(ga(2)));
+}
+
+static void test_held_writes_keep_their_order()
+{
+  uint32_t busy = knx.routing_stats().busy_received;
+  router.busy(BUSY_WAIT_MS, 0x0000);
+  TEST_ASSERT_TRUE(loop_until([&]() { return knx.routing_stats().busy_received == busy + 1; }));
+
+  for (uint8_t i = 10; i < 15; ++i)
+    knx.write_1byte_uint(ga(i), i);
+  TEST_ASSERT_EQUAL(5, knx.tx_pending());
+
+  for (uint8_t i = 10; i < 15; ++i)
+  {
+    telegram_t telegram;
+    TEST_ASSERT_TRUE(loop_until([&]() { return router.receive(telegram); }));
+    TEST_ASSERT_EQUAL_HEX16(ga(i).value, telegram.destination.value);
+  }
+}
+
+static void test_repeated_busy_backs_off_further()
+{
+  uint32_t busy = knx.routing_stats().busy_received;
+  router.busy(BUSY_WAIT_MS, 0x0000);
+  TEST_ASSERT_TRUE(loop_until([&]() { return knx.routing_stats().busy_received == busy + 1; }));
+  // N only counts BUSY frames at least 10 ms apart
+  delay(20);
+  uint32_t sent_at = millis();
+  router.busy(BUSY_WAIT_MS, 0x0000);
+  TEST_ASSERT_TRUE(loop_until([&]() { return knx.routing_stats().busy_received == busy + 2; }));
+  TEST_ASSERT_EQUAL(2, knx.routing_stats().busy_counter);
+
+  // The second BUSY restarts the wait
+  knx.write_2byte_float(ga(3), 23.0f);
+  uint32_t arrived = arrival(ga(3));
+  TEST_ASSERT_NOT_EQUAL(0, arrived);
+  TEST_ASSERT_GREATER_OR_EQUAL_UINT32(BUSY_WAIT_MS, arrived - sent_at);
+}
+
+static void test_reserved_control_is_ignored()
+{
+  knx_routing_stats_t before = knx.routing_stats();
+  router.busy(BUSY_WAIT_MS, 0x0001);
+  // The LOST_MESSAGE behind it shows the BUSY has been read
+  router.lost(3);
+  TEST_ASSERT_TRUE(loop_until([&]() { return knx.routing_stats().lost_reports == before.lost_reports + 1; }));
+  knx_routing_stats_t after = knx.routing_stats();
+  TEST_ASSERT_EQUAL(before.busy_received, after.busy_received);
+  TEST_ASSERT_EQUAL(before.lost_messages + 3, after.lost_messages);
+
+  knx.write_2byte_float(ga(4), 24.0f);
+  TEST_ASSERT_EQUAL(0, knx.tx_pending());
+}
+
+int main()
+{
+  knx.start(nullptr);
+  knx.physical_address_set(ESPKNXIP::PA_to_address(1, 1, 200));
+  // Held frames are what is under test, not the pacing between them
+  knx.tx_rate_set(0);
+  if (!router.open())
+  {
+    printf("No multicast on loopback, cannot run the stand-in router\n");
+    return 1;
+  }
+
+  UNITY_BEGIN();
+  RUN_TEST(test_busy_holds_then_resumes);
+  RUN_TEST(test_held_writes_keep_their_order);
+  RUN_TEST(test_repeated_busy_backs_off_further);
+  RUN_TEST(test_reserved_control_is_ignored);
+  return UNITY_END();
+}